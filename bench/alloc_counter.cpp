@@ -0,0 +1,95 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "alloc_counter.h"
+
+namespace {
+	std::atomic<uint64_t> s_alloc_count{ 0 };
+	std::atomic<uint64_t> s_alloc_bytes{ 0 };
+
+	void * counted_alloc( std::size_t size ) noexcept {
+		s_alloc_count.fetch_add( 1, std::memory_order_relaxed );
+		s_alloc_bytes.fetch_add( size, std::memory_order_relaxed );
+		return std::malloc( 0 == size ? 1 : size );
+	}
+}	// namespace anonymous
+
+namespace daw {
+	namespace bench {
+		alloc_stats_t alloc_stats( ) noexcept {
+			return alloc_stats_t{ s_alloc_count.load( std::memory_order_relaxed ), s_alloc_bytes.load( std::memory_order_relaxed ) };
+		}
+
+		void reset_alloc_stats( ) noexcept {
+			s_alloc_count = 0;
+			s_alloc_bytes = 0;
+		}
+	}	// namespace bench
+}	// namespace daw
+
+void * operator new( std::size_t size ) {
+	auto result = counted_alloc( size );
+	if( nullptr == result ) {
+		throw std::bad_alloc( );
+	}
+	return result;
+}
+
+void * operator new[]( std::size_t size ) {
+	return operator new( size );
+}
+
+void * operator new( std::size_t size, std::nothrow_t const & ) noexcept {
+	return counted_alloc( size );
+}
+
+void * operator new[]( std::size_t size, std::nothrow_t const & ) noexcept {
+	return counted_alloc( size );
+}
+
+void operator delete( void * ptr ) noexcept {
+	std::free( ptr );
+}
+
+void operator delete[]( void * ptr ) noexcept {
+	std::free( ptr );
+}
+
+void operator delete( void * ptr, std::size_t ) noexcept {
+	std::free( ptr );
+}
+
+void operator delete[]( void * ptr, std::size_t ) noexcept {
+	std::free( ptr );
+}
+
+void operator delete( void * ptr, std::nothrow_t const & ) noexcept {
+	std::free( ptr );
+}
+
+void operator delete[]( void * ptr, std::nothrow_t const & ) noexcept {
+	std::free( ptr );
+}
@@ -0,0 +1,164 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <intrin.h>
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace daw {
+	namespace bench {
+		using bench_clock_t = std::chrono::steady_clock;
+
+		/// <summary>Keep the optimizer from discarding a value that is otherwise unused</summary>
+		template<typename T>
+		inline void do_not_optimize( T const & value ) {
+#if defined( _MSC_VER )
+			static_cast<void>(*static_cast<char const volatile *>(static_cast<void const volatile *>(&value)));
+			_ReadWriteBarrier( );
+#else
+			asm volatile( "" : : "r"( &value ) : "memory" );
+#endif
+		}
+
+		inline double seconds_since( bench_clock_t::time_point const start ) {
+			return std::chrono::duration<double>( bench_clock_t::now( ) - start ).count( );
+		}
+
+		/// <summary>Peak resident set size of the process in KiB</summary>
+		inline uint64_t peak_rss_kb( ) {
+#ifdef _WIN32
+			PROCESS_MEMORY_COUNTERS counters;
+			if( !GetProcessMemoryInfo( GetCurrentProcess( ), &counters, sizeof( counters ) ) ) {
+				return 0;
+			}
+			return static_cast<uint64_t>(counters.PeakWorkingSetSize) / 1024;
+#else
+			rusage usage;
+			if( 0 != getrusage( RUSAGE_SELF, &usage ) ) {
+				return 0;
+			}
+#ifdef __APPLE__
+			return static_cast<uint64_t>(usage.ru_maxrss) / 1024;	// bytes on macOS
+#else
+			return static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+#endif
+		}
+
+		struct timing_t {
+			double min;
+			double median;
+			double mean;
+		};
+
+		inline timing_t summarize( std::vector<double> samples ) {
+			if( samples.empty( ) ) {
+				return timing_t{ 0, 0, 0 };
+			}
+			std::sort( samples.begin( ), samples.end( ) );
+			double total = 0;
+			for( auto const sample : samples ) {
+				total += sample;
+			}
+			return timing_t{ samples.front( ), samples[samples.size( ) / 2], total / static_cast<double>(samples.size( )) };
+		}
+
+		inline std::string json_escape( std::string const & value ) {
+			std::string result;
+			result.reserve( value.size( ) + 2 );
+			result.push_back( '"' );
+			for( auto const c : value ) {
+				switch( c ) {
+				case '"':
+					result += "\\\"";
+					break;
+				case '\\':
+					result += "\\\\";
+					break;
+				case '\n':
+					result += "\\n";
+					break;
+				default:
+					result.push_back( c );
+				}
+			}
+			result.push_back( '"' );
+			return result;
+		}
+
+		/// <summary>Command line arguments of the form --name=value</summary>
+		class arguments_t {
+			std::map<std::string, std::string> m_values;
+		public:
+			arguments_t( int argc, char const * const * argv ) {
+				for( int n = 1; n < argc; ++n ) {
+					std::string arg = argv[n];
+					if( 0 != arg.compare( 0, 2, "--" ) ) {
+						continue;
+					}
+					auto const eq = arg.find( '=' );
+					if( std::string::npos == eq ) {
+						m_values[arg.substr( 2 )] = "1";
+					} else {
+						m_values[arg.substr( 2, eq - 2 )] = arg.substr( eq + 1 );
+					}
+				}
+			}
+
+			bool has( std::string const & name ) const {
+				return m_values.count( name ) > 0;
+			}
+
+			template<typename T>
+			T get( std::string const & name, T const default_value ) const {
+				auto const pos = m_values.find( name );
+				if( m_values.end( ) == pos ) {
+					return default_value;
+				}
+				std::istringstream ss( pos->second );
+				T result = default_value;
+				ss >> result;
+				return result;
+			}
+
+			std::string get_string( std::string const & name, std::string const & default_value ) const {
+				auto const pos = m_values.find( name );
+				return m_values.end( ) == pos ? default_value : pos->second;
+			}
+		};
+	}	// namespace bench
+}	// namespace daw
@@ -0,0 +1,226 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "csv_generator.h"
+
+namespace daw {
+	namespace bench {
+		namespace {
+			/// <summary>splitmix64.  The standard distributions are not portable, so all randomness derives from this</summary>
+			class random_t {
+				uint64_t m_state;
+			public:
+				explicit random_t( uint64_t seed ) noexcept: m_state{ seed } { }
+
+				uint64_t next( ) noexcept {
+					auto z = (m_state += 0x9E3779B97F4A7C15ULL);
+					z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+					z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+					return z ^ (z >> 31);
+				}
+
+				/// <summary>Uniform in [0, 1)</summary>
+				double real( ) noexcept {
+					return static_cast<double>(next( ) >> 11) * (1.0 / 9007199254740992.0);
+				}
+
+				/// <summary>Uniform in [first, last]</summary>
+				uint64_t between( uint64_t first, uint64_t last ) noexcept {
+					return first + next( ) % (last - first + 1);
+				}
+
+				bool chance( double probability ) noexcept {
+					return real( ) < probability;
+				}
+			};
+
+			enum class column_kind_t { integer, real, string, timestamp };
+
+			std::vector<column_kind_t> choose_kinds( csv_generator_config_t const & config, random_t & rnd ) {
+				double const weights[] = { config.integer_weight, config.real_weight, config.string_weight, config.timestamp_weight };
+				double total = 0;
+				for( auto const weight : weights ) {
+					total += std::max( 0.0, weight );
+				}
+				if( 0 >= total ) {
+					throw std::invalid_argument( "At least one column type weight must be positive" );
+				}
+				std::vector<column_kind_t> result;
+				for( size_t n = 0; n < config.columns; ++n ) {
+					auto pick = rnd.real( ) * total;
+					size_t kind = 0;
+					while( kind < 3 && pick >= std::max( 0.0, weights[kind] ) ) {
+						pick -= std::max( 0.0, weights[kind] );
+						++kind;
+					}
+					result.push_back( static_cast<column_kind_t>(kind) );
+				}
+				return result;
+			}
+
+			void append_digits( std::string & out, random_t & rnd, size_t count ) {
+				out.push_back( static_cast<char>('1' + rnd.between( 0, 8 )) );
+				for( size_t n = 1; n < count; ++n ) {
+					out.push_back( static_cast<char>('0' + rnd.between( 0, 9 )) );
+				}
+			}
+
+			void append_two( std::string & out, uint64_t value ) {
+				out.push_back( static_cast<char>('0' + value / 10) );
+				out.push_back( static_cast<char>('0' + value % 10) );
+			}
+
+			void append_field( std::string & out, column_kind_t kind, csv_generator_config_t const & config, random_t & rnd ) {
+				auto const width = static_cast<size_t>(rnd.between( std::max<size_t>( 1, config.min_width ), std::max( config.min_width, config.max_width ) ));
+				switch( kind ) {
+				case column_kind_t::integer:
+					// At most 9 digits so the values fit int32 storage
+					if( rnd.chance( 0.5 ) ) {
+						out.push_back( '-' );
+					}
+					append_digits( out, rnd, std::min<size_t>( width, 9 ) );
+					break;
+				case column_kind_t::real: {
+					auto const digits = std::max<size_t>( 2, std::min<size_t>( width, 9 ) );
+					auto const integral = static_cast<size_t>(rnd.between( 1, digits - 1 ));
+					append_digits( out, rnd, integral );
+					out.push_back( '.' );
+					append_digits( out, rnd, digits - integral );
+					break;
+				}
+				case column_kind_t::timestamp:
+					out += "20";
+					append_two( out, rnd.between( 0, 29 ) );
+					out.push_back( '-' );
+					append_two( out, rnd.between( 1, 12 ) );
+					out.push_back( '-' );
+					append_two( out, rnd.between( 1, 28 ) );
+					out.push_back( ' ' );
+					append_two( out, rnd.between( 0, 23 ) );
+					out.push_back( ':' );
+					append_two( out, rnd.between( 0, 59 ) );
+					out.push_back( ':' );
+					append_two( out, rnd.between( 0, 59 ) );
+					break;
+				case column_kind_t::string: {
+					if( !rnd.chance( config.quote_density ) ) {
+						for( size_t n = 0; n < width; ++n ) {
+							out.push_back( static_cast<char>('a' + rnd.between( 0, 25 )) );
+						}
+						break;
+					}
+					// Quoted fields carry the characters that force quoting
+					auto const newline_at = rnd.chance( config.embedded_newline_ratio ) ? rnd.between( 0, width - 1 ) : width;
+					out.push_back( '"' );
+					for( size_t n = 0; n < width; ++n ) {
+						if( n == newline_at ) {
+							out.push_back( '\n' );
+							continue;
+						}
+						auto const pick = rnd.between( 0, 31 );
+						if( 26 == pick ) {
+							out.push_back( ',' );
+						} else if( 27 == pick ) {
+							out += "\"\"";
+						} else if( 28 <= pick ) {
+							out.push_back( ' ' );
+						} else {
+							out.push_back( static_cast<char>('a' + pick) );
+						}
+					}
+					out.push_back( '"' );
+					break;
+				}
+				}
+			}
+		}	// namespace anonymous
+
+		csv_generator_result_t generate_csv( std::ostream & out, csv_generator_config_t const & config ) {
+			random_t rnd{ config.seed };
+			auto const kinds = choose_kinds( config, rnd );
+			csv_generator_result_t result{ 0, config.rows, config.rows * config.columns };
+
+			std::string line;
+			for( size_t column = 0; column < config.columns; ++column ) {
+				if( 0 != column ) {
+					line.push_back( ',' );
+				}
+				line += "column_" + std::to_string( column );
+			}
+			line.push_back( '\n' );
+			out << line;
+			result.bytes += line.size( );
+
+			for( size_t row = 0; row < config.rows; ++row ) {
+				line.clear( );
+				for( size_t column = 0; column < config.columns; ++column ) {
+					if( 0 != column ) {
+						line.push_back( ',' );
+					}
+					if( !rnd.chance( config.null_ratio ) ) {
+						append_field( line, kinds[column], config, rnd );
+					}
+				}
+				line.push_back( '\n' );
+				out << line;
+				result.bytes += line.size( );
+			}
+			return result;
+		}
+
+		csv_generator_result_t generate_csv( std::string const & file_name, csv_generator_config_t const & config ) {
+			std::ofstream out( file_name, std::ios::binary | std::ios::trunc );
+			if( !out ) {
+				throw std::runtime_error( "Could not open " + file_name + " for writing" );
+			}
+			auto result = generate_csv( out, config );
+			out.flush( );
+			if( !out ) {
+				throw std::runtime_error( "Error writing " + file_name );
+			}
+			return result;
+		}
+
+		std::string to_json( csv_generator_config_t const & config ) {
+			std::ostringstream ss;
+			ss << "{\"rows\":" << config.rows
+				<< ",\"columns\":" << config.columns
+				<< ",\"integer_weight\":" << config.integer_weight
+				<< ",\"real_weight\":" << config.real_weight
+				<< ",\"string_weight\":" << config.string_weight
+				<< ",\"timestamp_weight\":" << config.timestamp_weight
+				<< ",\"null_ratio\":" << config.null_ratio
+				<< ",\"quote_density\":" << config.quote_density
+				<< ",\"embedded_newline_ratio\":" << config.embedded_newline_ratio
+				<< ",\"min_width\":" << config.min_width
+				<< ",\"max_width\":" << config.max_width
+				<< ",\"seed\":" << config.seed << "}";
+			return ss.str( );
+		}
+	}	// namespace bench
+}	// namespace daw
@@ -0,0 +1,59 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace daw {
+	namespace bench {
+		/// <summary>Shape of a synthetic CSV file.  Weights are relative and need not sum to 1</summary>
+		struct csv_generator_config_t {
+			size_t rows = 100000;
+			size_t columns = 16;
+			double integer_weight = 0.35;
+			double real_weight = 0.35;
+			double string_weight = 0.2;
+			double timestamp_weight = 0.1;
+			double null_ratio = 0.05;	// fraction of empty fields
+			double quote_density = 0.1;	// fraction of string fields that are quoted
+			double embedded_newline_ratio = 0.01;	// fraction of quoted fields containing a newline
+			size_t min_width = 2;
+			size_t max_width = 16;
+			uint64_t seed = 42;
+		};
+
+		struct csv_generator_result_t {
+			uint64_t bytes;
+			uint64_t rows;
+			uint64_t cells;
+		};
+
+		/// <summary>Write a CSV file with a header row.  The same config always produces the same bytes on every platform</summary>
+		csv_generator_result_t generate_csv( std::ostream & out, csv_generator_config_t const & config );
+		csv_generator_result_t generate_csv( std::string const & file_name, csv_generator_config_t const & config );
+
+		std::string to_json( csv_generator_config_t const & config );
+	}	// namespace bench
+}	// namespace daw
@@ -0,0 +1,223 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Per operation cost of the cell layer: time and heap allocations of building, copying, comparing and
+// formatting cells.  Writes a JSON array with one object per case
+//
+// csv_helper_micro_bench [--iterations=N] [--filter=substring] [--label=text] [--output=results.json]
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <daw/daw_cstring.h>
+
+#include "alloc_counter.h"
+#include "bench_common.h"
+#include "data_cell.h"
+#include "string_helpers.h"
+#include "variant.h"
+
+namespace {
+	using namespace daw::bench;
+	using daw::data::DataCell;
+	using daw::data::Variant;
+
+	struct result_t {
+		std::string name;
+		size_t iterations;
+		double ns_per_op;
+		double allocations_per_op;
+		double bytes_per_op;
+	};
+
+	class suite_t {
+		size_t m_iterations;
+		std::string m_filter;
+		std::vector<result_t> m_results;
+	public:
+		suite_t( size_t iterations, std::string filter ): m_iterations{ iterations }, m_filter{ std::move( filter ) }, m_results{ } { }
+
+		/// <summary>Time func( ) and count its allocations after a short warm up</summary>
+		template<typename Function>
+		void run( std::string name, Function func ) {
+			if( !m_filter.empty( ) && std::string::npos == name.find( m_filter ) ) {
+				return;
+			}
+			for( size_t n = 0; n < std::max<size_t>( 1, m_iterations / 100 ); ++n ) {
+				func( );
+			}
+			reset_alloc_stats( );
+			auto const start = bench_clock_t::now( );
+			for( size_t n = 0; n < m_iterations; ++n ) {
+				func( );
+			}
+			auto const seconds = seconds_since( start );
+			auto const allocations = alloc_stats( );
+			auto const ops = static_cast<double>(m_iterations);
+			m_results.push_back( result_t{ std::move( name ), m_iterations, seconds * 1e9 / ops, static_cast<double>(allocations.count) / ops, static_cast<double>(allocations.bytes) / ops } );
+		}
+
+		std::string to_json( std::string const & label ) const {
+			std::ostringstream ss;
+			ss.precision( 3 );
+			ss << std::fixed;
+			ss << "{\"benchmark\":\"cell_primitives\",\"label\":" << json_escape( label ) << ",\"results\":[";
+			for( size_t n = 0; n < m_results.size( ); ++n ) {
+				auto const & result = m_results[n];
+				ss << (0 == n ? "" : ",") << "\n{\"name\":" << json_escape( result.name )
+					<< ",\"iterations\":" << result.iterations
+					<< ",\"ns_per_op\":" << result.ns_per_op
+					<< ",\"allocations_per_op\":" << result.allocations_per_op
+					<< ",\"bytes_per_op\":" << result.bytes_per_op << "}";
+			}
+			ss << "\n]}\n";
+			return ss.str( );
+		}
+	};
+
+	daw::cstring make_cstring( std::string const & value ) {
+		return daw::cstring{ value.c_str( ), true, value.size( ) };
+	}
+
+	struct input_t {
+		char const * name;
+		std::string text;
+	};
+
+	std::vector<input_t> const & cell_inputs( ) {
+		static std::vector<input_t> const result = {
+			{ "empty", "" },
+			{ "small_int", "42" },
+			{ "int", "-987654321" },
+			{ "real", "1234.5678" },
+			{ "short_string", "hello" },
+			{ "long_string", "a string long enough to defeat any small string optimization" }
+		};
+		return result;
+	}
+
+	void bench_from_string( suite_t & suite ) {
+		for( auto const & input : cell_inputs( ) ) {
+			suite.run( std::string( "DataCell::from_string/" ) + input.name, [&input]( ) {
+				auto cell = DataCell::from_string( make_cstring( input.text ) );
+				do_not_optimize( cell );
+			} );
+		}
+		suite.run( "DataCell::from_time_string", []( ) {
+			auto cell = DataCell::from_time_string( "2016-03-04 05:06:07", "%Y-%m-%d %H:%M:%S" );
+			do_not_optimize( cell );
+		} );
+	}
+
+	void bench_variant( suite_t & suite ) {
+		Variant const integer{ daw::data::integer_t{ 123456 } };
+		Variant const real{ daw::data::real_t{ 3.25f } };
+		Variant const timestamp{ DataCell::from_time_string( "2016-03-04 05:06:07", "%Y-%m-%d %H:%M:%S" ).timestamp( ) };
+		Variant const short_string{ make_cstring( "hello" ) };
+		Variant const long_string{ make_cstring( cell_inputs( ).back( ).text ) };
+		Variant const long_string2{ make_cstring( cell_inputs( ).back( ).text + "!" ) };
+
+		std::pair<char const *, Variant const *> const values[] = {
+			{ "integer", &integer }, { "real", &real }, { "timestamp", &timestamp }, { "short_string", &short_string }, { "long_string", &long_string }
+		};
+		for( auto const & value : values ) {
+			suite.run( std::string( "Variant::copy/" ) + value.first, [&value]( ) {
+				Variant copy{ *value.second };
+				do_not_optimize( copy );
+			} );
+			// The move cases include making the source, subtract the matching copy case for the move alone
+			suite.run( std::string( "Variant::move/" ) + value.first, [&value]( ) {
+				Variant source{ *value.second };
+				Variant moved{ std::move( source ) };
+				do_not_optimize( moved );
+			} );
+		}
+		suite.run( "Variant::compare/integer", [&integer]( ) {
+			auto result = Variant::compare( integer, integer );
+			do_not_optimize( result );
+		} );
+		suite.run( "Variant::compare/real", [&real]( ) {
+			auto result = Variant::compare( real, real );
+			do_not_optimize( result );
+		} );
+		suite.run( "Variant::compare/timestamp", [&timestamp]( ) {
+			auto result = Variant::compare( timestamp, timestamp );
+			do_not_optimize( result );
+		} );
+		suite.run( "Variant::compare/long_string", [&long_string, &long_string2]( ) {
+			auto result = Variant::compare( long_string, long_string2 );
+			do_not_optimize( result );
+		} );
+	}
+
+	void bench_to_string( suite_t & suite ) {
+		DataCell const integer{ daw::data::integer_t{ -987654321 } };
+		DataCell const real{ daw::data::real_t{ 1234.5678f } };
+		DataCell const timestamp = DataCell::from_time_string( "2016-03-04 05:06:07", "%Y-%m-%d %H:%M:%S" );
+		DataCell const string{ make_cstring( "hello" ) };
+
+		std::pair<char const *, DataCell const *> const cells[] = {
+			{ "integer", &integer }, { "real", &real }, { "timestamp", &timestamp }, { "string", &string }
+		};
+		for( auto const & cell : cells ) {
+			suite.run( std::string( "DataCell::to_string/" ) + cell.first, [&cell]( ) {
+				auto result = cell.second->to_string( );
+				do_not_optimize( result );
+			} );
+		}
+		auto const ts = timestamp.timestamp( );
+		suite.run( "ptime_to_string", [&ts]( ) {
+			auto result = daw::string::ptime_to_string( ts, "%Y-%m-%d %H:%M:%S" );
+			do_not_optimize( result );
+		} );
+		auto const duration = ts.time_of_day( );
+		suite.run( "ptime_to_string/time_duration", [&duration]( ) {
+			auto result = daw::string::ptime_to_string( duration );
+			do_not_optimize( result );
+		} );
+	}
+}	// namespace anonymous
+
+int main( int argc, char ** argv ) {
+	arguments_t const args( argc, argv );
+	suite_t suite{ std::max<size_t>( 1, args.get( "iterations", size_t{ 200000 } ) ), args.get_string( "filter", "" ) };
+	try {
+		bench_from_string( suite );
+		bench_variant( suite );
+		bench_to_string( suite );
+	} catch( std::exception const & ex ) {
+		std::cerr << "Error: " << ex.what( ) << '\n';
+		return 1;
+	}
+	auto const json = suite.to_json( args.get_string( "label", "" ) );
+	if( args.has( "output" ) ) {
+		std::ofstream out( args.get_string( "output", "" ) );
+		out << json;
+	} else {
+		std::cout << json;
+	}
+	return 0;
+}
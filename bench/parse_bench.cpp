@@ -0,0 +1,143 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Measures parse_csv_data on a synthetic or supplied CSV file and writes the results as JSON
+//
+// csv_helper_bench [--input=file.csv | --rows=N --columns=N --integer_weight=W --real_weight=W
+//     --string_weight=W --timestamp_weight=W --null_ratio=R --quote_density=R --embedded_newline_ratio=R
+//     --min_width=N --max_width=N --seed=N --file=generated.csv --keep] [--iterations=N] [--phases] [--label=text] [--output=results.json]
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "alloc_counter.h"
+#include "bench_common.h"
+#include "csv_generator.h"
+#include "data_table.h"
+
+int main( int argc, char ** argv ) {
+	using namespace daw::bench;
+	arguments_t const args( argc, argv );
+
+	csv_generator_config_t config;
+	config.rows = args.get( "rows", config.rows );
+	config.columns = args.get( "columns", config.columns );
+	config.integer_weight = args.get( "integer_weight", config.integer_weight );
+	config.real_weight = args.get( "real_weight", config.real_weight );
+	config.string_weight = args.get( "string_weight", config.string_weight );
+	config.timestamp_weight = args.get( "timestamp_weight", config.timestamp_weight );
+	config.null_ratio = args.get( "null_ratio", config.null_ratio );
+	config.quote_density = args.get( "quote_density", config.quote_density );
+	config.embedded_newline_ratio = args.get( "embedded_newline_ratio", config.embedded_newline_ratio );
+	config.min_width = args.get( "min_width", config.min_width );
+	config.max_width = args.get( "max_width", config.max_width );
+	config.seed = args.get( "seed", config.seed );
+
+	auto const iterations = std::max<size_t>( 1, args.get( "iterations", size_t{ 5 } ) );
+	auto const generated = !args.has( "input" );
+	auto const file_name = generated ? args.get_string( "file", "csv_helper_bench.csv" ) : args.get_string( "input", "" );
+
+	try {
+		if( generated ) {
+			generate_csv( file_name, config );
+		}
+		uint64_t file_bytes = 0;
+		{
+			std::ifstream in( file_name, std::ios::binary | std::ios::ate );
+			file_bytes = static_cast<uint64_t>(in.tellg( ));
+		}
+
+		std::vector<double> samples;
+		uint64_t rows = 0;
+		uint64_t cells = 0;
+		alloc_stats_t allocations{ 0, 0 };
+		for( size_t n = 0; n < iterations; ++n ) {
+			reset_alloc_stats( );
+			auto const start = bench_clock_t::now( );
+			auto table = daw::data::parse_csv_data( file_name, 0 );
+			samples.push_back( seconds_since( start ) );
+			allocations = alloc_stats( );
+
+			auto const & result = table.get( );
+			rows = result.empty( ) ? 0 : result[0].size( );
+			cells = rows * result.size( );
+		}
+		auto const timing = summarize( samples );
+		// Timing every cell slows the parse so the phases come from one extra run
+		daw::data::parse_stats stats;
+		auto const phases = args.has( "phases" );
+		if( phases ) {
+			daw::data::parse_csv_data( daw::data::parse_csv_data_param{ file_name, 0 }, stats ).get( );
+		}
+		auto const per_second = []( double amount, double seconds ) {
+			return seconds > 0 ? amount / seconds : 0.0;
+		};
+
+		std::ostringstream json;
+		json.precision( 6 );
+		json << std::fixed;
+		json << "{\"benchmark\":\"parse_csv_data\""
+			<< ",\"label\":" << json_escape( args.get_string( "label", "" ) )
+			<< ",\"input\":" << json_escape( file_name )
+			<< ",\"config\":" << (generated ? to_json( config ) : std::string( "null" ))
+			<< ",\"file_bytes\":" << file_bytes
+			<< ",\"rows\":" << rows
+			<< ",\"cells\":" << cells
+			<< ",\"iterations\":" << iterations
+			<< ",\"seconds\":{\"min\":" << timing.min << ",\"median\":" << timing.median << ",\"mean\":" << timing.mean << "}"
+			<< ",\"mb_per_s\":" << per_second( static_cast<double>(file_bytes) / (1024.0 * 1024.0), timing.median )
+			<< ",\"rows_per_s\":" << per_second( static_cast<double>(rows), timing.median )
+			<< ",\"cells_per_s\":" << per_second( static_cast<double>(cells), timing.median )
+			<< ",\"allocations\":" << allocations.count
+			<< ",\"allocated_bytes\":" << allocations.bytes
+			<< ",\"peak_rss_kb\":" << peak_rss_kb( );
+		if( phases ) {
+			json << ",\"phases\":{\"tokenize\":" << stats.tokenize_seconds
+				<< ",\"type_detect\":" << stats.type_detect_seconds
+				<< ",\"convert\":" << stats.convert_seconds
+				<< ",\"post_process\":" << stats.post_process_seconds
+				<< ",\"total\":" << stats.total_seconds
+				<< ",\"ragged_rows\":" << stats.ragged_rows
+				<< ",\"parser_estimated_allocations\":" << stats.estimated_allocations << "}";
+		}
+		json << "}\n";
+
+		if( args.has( "output" ) ) {
+			std::ofstream out( args.get_string( "output", "" ) );
+			out << json.str( );
+		} else {
+			std::cout << json.str( );
+		}
+		if( generated && !args.has( "keep" ) ) {
+			std::remove( file_name.c_str( ) );
+		}
+	} catch( std::exception const & ex ) {
+		std::cerr << "Error: " << ex.what( ) << '\n';
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,58 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace daw {
+	namespace data {
+		/// <summary>Shared flag used to ask a long running operation to stop.  Copies refer to the same flag.  There is no move so a token is never left without one</summary>
+		class cancellation_token final {
+			std::shared_ptr<std::atomic<bool>> m_cancelled;
+		public:
+			cancellation_token( );
+			~cancellation_token( ) = default;
+			cancellation_token( cancellation_token const & ) = default;
+			cancellation_token & operator=( cancellation_token const & ) = default;
+
+			/// <summary>Request cancellation.  Safe to call from any thread, more than once</summary>
+			void cancel( ) noexcept;
+			bool is_cancelled( ) const noexcept;
+		};
+
+		/// <summary>Thrown, and stored in the returned expected_t, when an operation stops early at a cancellation or deadline check</summary>
+		class operation_cancelled: public std::runtime_error {
+		public:
+			enum class reason_t: int8_t { cancelled = 0, deadline = 1 };
+		private:
+			reason_t m_reason;
+		public:
+			operation_cancelled( reason_t reason, std::string const & message );
+
+			reason_t reason( ) const noexcept;
+		};
+	}	// namespace data
+}	// namespace daw
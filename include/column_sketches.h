@@ -0,0 +1,107 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "data_algorithms.h"
+#include "data_cell.h"
+
+namespace daw {
+	namespace data {
+		/// <summary>HyperLogLog estimate of the number of distinct values added.  The relative error is about 1.04 / sqrt( 2^precision )</summary>
+		class hyperloglog_t final {
+			uint8_t m_precision;
+			std::vector<uint8_t> m_registers;
+		public:
+			/// <param name="precision">log2 of the register count, 4 to 18.  12 uses 4KB for about 1.6% error</param>
+			explicit hyperloglog_t( uint8_t precision = 12 );
+
+			/// <summary>Add a value by its 64 bit hash.  The hash must be well mixed</summary>
+			void add_hash( uint64_t hash ) noexcept;
+			/// <summary>Combine with a sketch of another part of the data.  Both must have the same precision</summary>
+			void merge( hyperloglog_t const & other );
+			double estimate( ) const;
+			uint8_t precision( ) const noexcept;
+		};
+
+		/// <summary>KLL quantile sketch of doubles.  Ranks are within about 1.7 / k of the exact rank with high probability</summary>
+		class kll_sketch_t final {
+			size_t m_k;
+			uint64_t m_count;
+			double m_min;
+			double m_max;
+			uint64_t m_random;
+			std::vector<std::vector<double>> m_levels;	// Items of level h each stand for 2^h values
+
+			size_t capacity( size_t level ) const noexcept;
+			bool over_capacity( ) const noexcept;
+			void compress( );
+		public:
+			explicit kll_sketch_t( size_t k = 200 );
+
+			void add( double value );
+			/// <summary>Combine with a sketch of another part of the data</summary>
+			void merge( kll_sketch_t const & other );
+
+			uint64_t count( ) const noexcept;
+			size_t k( ) const noexcept;
+			/// <summary>Approximate value at fraction q of the sorted values.  NaN when empty</summary>
+			double quantile( double q ) const;
+			/// <summary>Approximate fraction of the values that are <= value</summary>
+			double rank( double value ) const;
+			/// <summary>Items held, which grows with log( count )</summary>
+			size_t retained( ) const noexcept;
+		};
+
+		/// <summary>Distinct count of all non empty cells and quantiles of the integer, real and decimal cells of a column</summary>
+		struct column_sketches {
+			hyperloglog_t distinct;
+			kll_sketch_t quantiles;
+
+			column_sketches( ) = default;
+			column_sketches( uint8_t precision, size_t k );
+
+			void add( DataCell const & cell );
+			void merge( column_sketches const & other );
+		};
+
+		/// <summary>Sketch the cells of a column, splitting it into chunks that are sketched in parallel and merged</summary>
+		template<typename Column>
+		column_sketches sketch_column( Column const & column, uint8_t precision = 12, size_t k = 200 ) {
+			column_sketches const init{ precision, k };
+			return algorithm::parallel_reduce( 0, column.size( ), init, [&]( size_t first, size_t last ) {
+				auto result = init;
+				for( auto n = first; n < last; ++n ) {
+					result.add( column[n] );
+				}
+				return result;
+			}, []( column_sketches lhs, column_sketches const & rhs ) {
+				lhs.merge( rhs );
+				return lhs;
+			}, 65536 );
+		}
+	}	// namespace data
+}	// namespace daw
@@ -0,0 +1,142 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "data_cell.h"
+#include "data_types.h"
+
+namespace daw {
+	namespace data {
+		/// <summary>Bounds of the values in a run of rows.  Cells of different types are not comparable so each kind has its own bounds</summary>
+		struct value_range_t {
+			static constexpr size_t const no_row = std::numeric_limits<size_t>::max( );
+
+			size_t count = 0;
+			size_t null_count = 0;
+			/// <summary>Over integer, real and decimal cells.  min > max when there are none</summary>
+			double numeric_min = std::numeric_limits<double>::infinity( );
+			double numeric_max = -std::numeric_limits<double>::infinity( );
+			/// <summary>not_a_date_time when there are no timestamp cells</summary>
+			timestamp_t timestamp_min;
+			timestamp_t timestamp_max;
+			/// <summary>Rows of the smallest and largest string cells, no_row when there are none.  Rows are kept instead of copies of the strings</summary>
+			size_t string_min_row = no_row;
+			size_t string_max_row = no_row;
+
+			/// <summary>Could a numeric cell in this range be within [lo, hi]</summary>
+			bool may_contain( double lo, double hi ) const noexcept;
+			bool may_contain( timestamp_t const & lo, timestamp_t const & hi ) const;
+			bool has_nulls( ) const noexcept;
+
+			/// <summary>Widen to include cell at row.  cell_at( n ) must return the cell at row n for the string bounds</summary>
+			template<typename CellAt>
+			void add( DataCell const & cell, size_t row, CellAt cell_at ) {
+				++count;
+				if( cell.empty( ) ) {	// Empty cells report their type as string
+					++null_count;
+					return;
+				}
+				if( DataCellType::string == cell.type( ) ) {
+					auto const value = cell.string_view( );
+					if( no_row == string_min_row || value.compare( cell_at( string_min_row ).string_view( ) ) < 0 ) {
+						string_min_row = row;
+					}
+					if( no_row == string_max_row || value.compare( cell_at( string_max_row ).string_view( ) ) > 0 ) {
+						string_max_row = row;
+					}
+					return;
+				}
+				add_value( cell );
+			}
+		private:
+			void add_value( DataCell const & cell );
+		};
+
+		/// <summary>Statistics of a column that are kept current as cells are appended, with a value_range_t per zone_rows rows so scans can skip zones</summary>
+		class column_stats final {
+			value_range_t m_totals;
+			std::array<size_t, 6> m_type_counts;	// Indexed by DataCellType
+			uint64_t m_string_bytes;
+			std::vector<value_range_t> m_zones;
+			integer_t m_integer_min;
+			integer_t m_integer_max;
+			bool m_reals_fit_float;
+
+			void add_numeric( DataCell const & cell );
+		public:
+			static constexpr size_t const zone_rows = 65536;
+
+			column_stats( );
+
+			/// <summary>Account for cell, which is stored at row.  Rows must be added in order starting at 0</summary>
+			template<typename CellAt>
+			void add( DataCell const & cell, size_t row, CellAt cell_at ) {
+				if( m_zones.size( ) <= row / zone_rows ) {
+					m_zones.emplace_back( );
+				}
+				m_totals.add( cell, row, cell_at );
+				m_zones.back( ).add( cell, row, cell_at );
+				auto const type = cell.empty( ) ? DataCellType::empty_string : cell.type( );
+				++m_type_counts[static_cast<size_t>(type)];
+				if( DataCellType::string == type ) {
+					m_string_bytes += cell.string_view( ).size( );
+				} else if( DataCellType::integer == type || DataCellType::real == type ) {
+					add_numeric( cell );
+				}
+			}
+
+			/// <summary>Start over, as for an empty column</summary>
+			void clear( );
+
+			value_range_t const & totals( ) const noexcept;
+			size_t row_count( ) const noexcept;
+			size_t null_count( ) const noexcept;
+			size_t type_count( DataCellType type ) const noexcept;
+			uint64_t string_bytes( ) const noexcept;
+
+			/// <summary>Zone n covers rows [n * zone_rows, (n + 1) * zone_rows)</summary>
+			std::vector<value_range_t> const & zones( ) const noexcept;
+
+			boost::optional<double> numeric_min( ) const;
+			boost::optional<double> numeric_max( ) const;
+			/// <summary>Exact bounds of the integer cells, none when there are none</summary>
+			boost::optional<integer_t> integer_min( ) const;
+			boost::optional<integer_t> integer_max( ) const;
+
+			/// <summary>The narrowest storage that holds every value exactly.  none unless every cell is null, integer or
+			/// real, or when no width is exact, as for integers past 2^53 mixed with reals</summary>
+			storage_width_t width( ) const noexcept;
+		};
+
+		/// <summary>The narrowest integer storage holding [min, max]</summary>
+		storage_width_t narrowest_integer_width( integer_t min, integer_t max ) noexcept;
+	}	// namespace data
+}	// namespace daw
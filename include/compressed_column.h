@@ -0,0 +1,165 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "data_table.h"
+#include "data_types.h"
+
+namespace daw {
+	namespace data {
+		enum class column_encoding_t: uint8_t { run_length, frame_of_reference };
+
+		/// <summary>An integer or timestamp column stored compressed, either as runs of equal values or as each value's
+		/// offset from the column minimum packed into as few bits as the range needs.  Timestamps are stored as
+		/// microseconds since the epoch and every value below is in those units.  The infinities are stored as
+		/// neg_infinity_value and pos_infinity_value, which no date and time reaches, and not_a_date_time as a null as it
+		/// holds no time.  The aggregates and filters run on the compressed values without building cells</summary>
+		class compressed_column_t final {
+		public:
+			static constexpr int64_t const neg_infinity_value = std::numeric_limits<int64_t>::min( );
+			static constexpr int64_t const pos_infinity_value = std::numeric_limits<int64_t>::max( );
+		private:
+			std::string m_header;
+			column_encoding_t m_encoding;
+			DataCellType m_type;	// integer or timestamp
+			size_t m_size;
+			size_t m_null_count;
+			boost::optional<int64_t> m_min;
+			boost::optional<int64_t> m_max;
+			// run_length
+			std::vector<int64_t> m_run_values;
+			std::vector<uint64_t> m_run_ends;	// One past the last row of each run
+			std::vector<uint8_t> m_run_valid;	// 0 for a run of nulls.  Empty when no row is null
+			// frame_of_reference
+			uint8_t m_bits;
+			std::vector<uint64_t> m_packed;	// value - *m_min of each row, m_bits apiece
+			std::vector<uint8_t> m_valid;	// 1 when the row has a value.  Empty when no row is null
+
+			/// <summary>Take the header and type of column and its values and null mask.  Returns the number of runs</summary>
+			size_t load( DataTable::value_type const & column, std::vector<int64_t> & values, std::vector<uint8_t> & valid );
+			void encode( std::vector<int64_t> const & values, std::vector<uint8_t> const & valid, column_encoding_t encoding );
+			size_t run_of( size_t row ) const;
+			/// <summary>The offsets of rows [first, first + count) from the minimum, nulls included</summary>
+			void unpack_offsets( size_t first, size_t count, uint64_t * out ) const noexcept;
+
+			uint64_t offset_of( size_t row ) const noexcept {
+				if( 0 == m_bits ) {
+					return 0;
+				}
+				auto const bit = static_cast<uint64_t>(row) * m_bits;
+				auto const word = static_cast<size_t>(bit / 64);
+				auto const shift = static_cast<unsigned>(bit % 64);
+				auto result = m_packed[word] >> shift;
+				if( shift + m_bits > 64 ) {
+					result |= m_packed[word + 1] << (64 - shift);
+				}
+				return 64 == m_bits ? result : result & ((uint64_t{ 1 } << m_bits) - 1);
+			}
+
+			bool row_is_valid( size_t row ) const noexcept {
+				return m_valid.empty( ) || 0 != m_valid[row];
+			}
+		public:
+			compressed_column_t( );
+
+			/// <summary>Compress column with whichever encoding is smaller.  Throws unless every cell is null or all of the
+			/// others are integers, or all are timestamps</summary>
+			explicit compressed_column_t( DataTable::value_type const & column );
+			compressed_column_t( DataTable::value_type const & column, column_encoding_t encoding );
+
+			std::string const & header( ) const noexcept;
+			column_encoding_t encoding( ) const noexcept;
+			/// <summary>integer or timestamp</summary>
+			DataCellType type( ) const noexcept;
+			size_t size( ) const noexcept;
+			bool empty( ) const noexcept;
+			/// <summary>Bytes of compressed values and null masks</summary>
+			size_t memory_size( ) const noexcept;
+			/// <summary>Runs for run_length, rows for frame_of_reference</summary>
+			size_t run_count( ) const noexcept;
+			/// <summary>Bits per value for frame_of_reference, 0 for run_length</summary>
+			uint8_t bits( ) const noexcept;
+
+			bool is_null( size_t row ) const;
+			/// <summary>The value at row, 0 for null rows.  O(log runs) for run_length</summary>
+			int64_t value( size_t row ) const;
+			/// <summary>An integer or timestamp cell, or an empty cell for null rows</summary>
+			DataCell cell( size_t row ) const;
+
+			/// <summary>Calls func( first_row, row_count, value ) for each run of rows with the same value, skipping nulls.
+			/// Runs are a row long for frame_of_reference</summary>
+			template<typename Function>
+			void for_each_run( Function func ) const {
+				if( column_encoding_t::run_length == m_encoding ) {
+					uint64_t first = 0;
+					for( size_t run = 0; run < m_run_ends.size( ); ++run ) {
+						if( m_run_valid.empty( ) || 0 != m_run_valid[run] ) {
+							func( static_cast<size_t>(first), static_cast<size_t>(m_run_ends[run] - first), m_run_values[run] );
+						}
+						first = m_run_ends[run];
+					}
+					return;
+				}
+				for( size_t row = 0; row < m_size; ++row ) {
+					if( row_is_valid( row ) ) {
+						func( row, size_t{ 1 }, static_cast<int64_t>(static_cast<uint64_t>(*m_min) + offset_of( row )) );
+					}
+				}
+			}
+
+			/// <summary>Write the values of rows [first, first + count) to out, 0 for null rows</summary>
+			void decode( size_t first, size_t count, int64_t * out ) const;
+
+			/// <summary>Rows that are not null</summary>
+			size_t count( ) const noexcept;
+			/// <summary>Sum of the values.  Throws as aggregate::sum does when it does not fit in int64_t</summary>
+			int64_t sum( ) const;
+			/// <returns>The smallest value or none if all rows are null</returns>
+			boost::optional<int64_t> const & min( ) const noexcept;
+			/// <returns>The largest value or none if all rows are null</returns>
+			boost::optional<int64_t> const & max( ) const noexcept;
+			/// <returns>The mean of the values or NaN if all rows are null.  For timestamps, an infinity when the column
+			/// holds that infinity and NaN when it holds both</returns>
+			double mean( ) const;
+
+			/// <summary>Mask suitable for TableView::filter, 1 for rows whose value is in [low, high].  Null rows are 0.  The
+			/// timestamp bounds may be infinities but not not_a_date_time</summary>
+			std::vector<uint8_t> filter_between( int64_t low, int64_t high ) const;
+			std::vector<uint8_t> filter_between( timestamp_t const & low, timestamp_t const & high ) const;
+			std::vector<uint8_t> filter_equal( int64_t value ) const;
+
+			/// <summary>Back to a column of cells</summary>
+			DataTable::value_type decompress( ) const;
+		};
+
+		/// <summary>Compress the columns of table that hold only integers or only timestamps, and at least one of them</summary>
+		std::vector<compressed_column_t> compress_columns( DataTable const & table );
+	}	// namespace data
+}	// namespace daw
@@ -0,0 +1,121 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "data_table.h"
+#include "data_types.h"
+#include "decimal.h"
+
+namespace daw {
+	namespace data {
+		namespace aggregate {
+			/// <summary>Contiguous values of one type with a byte per row null mask</summary>
+			template<typename T>
+			struct numeric_buffer_t {
+				std::vector<T> values;
+				std::vector<uint8_t> valid;	// 1 when values[n] holds a value, 0 when the row is null
+
+				size_t size( ) const noexcept {
+					return values.size( );
+				}
+			};
+
+			/// <summary>Integer cells of column.  All other cells are null</summary>
+			numeric_buffer_t<integer_t> integer_values( DataTable::value_type const & column );
+
+			/// <summary>Integer, real and decimal cells of column widened to double.  All other cells are null</summary>
+			numeric_buffer_t<double> numeric_values( DataTable::value_type const & column );
+
+			/// <summary>Exact sum of the decimal cells of column at the largest scale among them.  Other cells are skipped.
+			/// Throws when the sum does not fit</summary>
+			decimal_t decimal_sum( DataTable::value_type const & column );
+
+			/// <summary>Sums of integers are exact in int64_t, everything else is summed in double.  An integer sum that does not fit
+			/// in int64_t throws rather than wrapping, while mean and variance fall back to summing it in long double</summary>
+			template<typename T>
+			using accumulator_t = typename std::conditional<std::is_integral<T>::value, int64_t, double>::type;
+
+			// The kernels below are instantiated for the packed storage types int8_t, int16_t, int32_t, int64_t,
+			// float and double, see packed_column_t.  valid may be nullptr when
+			// there are no nulls.  They are vectorized with AVX2 when it is enabled at compile time and split
+			// across threads in row blocks for large inputs
+			size_t count( uint8_t const * valid, size_t size );
+
+			template<typename T>
+			accumulator_t<T> sum( T const * values, uint8_t const * valid, size_t size );
+
+			/// <returns>The smallest non-null value or none if all rows are null.  NaN values are skipped, so the result is only NaN when
+			/// every non-null value is</returns>
+			template<typename T>
+			boost::optional<T> min( T const * values, uint8_t const * valid, size_t size );
+
+			/// <returns>The largest non-null value or none if all rows are null.  NaN values are skipped as they are by min</returns>
+			template<typename T>
+			boost::optional<T> max( T const * values, uint8_t const * valid, size_t size );
+
+			/// <returns>The mean of the non-null values or NaN if all rows are null</returns>
+			template<typename T>
+			double mean( T const * values, uint8_t const * valid, size_t size );
+
+			/// <returns>The sample variance of the non-null values or NaN with fewer than two</returns>
+			template<typename T>
+			double variance( T const * values, uint8_t const * valid, size_t size );
+
+			template<typename T>
+			size_t count( numeric_buffer_t<T> const & buffer ) {
+				return count( buffer.valid.data( ), buffer.size( ) );
+			}
+
+			template<typename T>
+			accumulator_t<T> sum( numeric_buffer_t<T> const & buffer ) {
+				return sum( buffer.values.data( ), buffer.valid.data( ), buffer.size( ) );
+			}
+
+			template<typename T>
+			boost::optional<T> min( numeric_buffer_t<T> const & buffer ) {
+				return min( buffer.values.data( ), buffer.valid.data( ), buffer.size( ) );
+			}
+
+			template<typename T>
+			boost::optional<T> max( numeric_buffer_t<T> const & buffer ) {
+				return max( buffer.values.data( ), buffer.valid.data( ), buffer.size( ) );
+			}
+
+			template<typename T>
+			double mean( numeric_buffer_t<T> const & buffer ) {
+				return mean( buffer.values.data( ), buffer.valid.data( ), buffer.size( ) );
+			}
+
+			template<typename T>
+			double variance( numeric_buffer_t<T> const & buffer ) {
+				return variance( buffer.values.data( ), buffer.valid.data( ), buffer.size( ) );
+			}
+		}	// namespace aggregate
+	}	// namespace data
+}	// namespace daw
@@ -23,46 +23,112 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <functional>
 #include <iterator>
 #include <type_traits>
 #include <vector>
 
 #include "defs.h"
-
-#if USE_PPL == 1
-#include <ppl.h>
-#else
-#ifdef _WIN32
-#include <omp.h>
-#endif
-#endif
+#include "task_scheduler.h"
 
 namespace daw {
 	namespace data {
 		namespace algorithm {
-			template<typename ContainerType>
-			void parallel_for_each( ContainerType& container, const std::function<void( typename ContainerType::reference )>& func ) {
-#if USE_PPL == 1
-				Concurrency::parallel_for_each( std::begin( container ), std::end( container ), func );
-#else
-#pragma omp parallel for
-				for( ptrdiff_t n = 0; n < static_cast<ptrdiff_t>(container.size( )); ++n ) {
-					func( container.item( static_cast<size_t>(n) ) );
+			namespace impl {
+				/// <summary>Number of threads parallel algorithms can use</summary>
+				inline size_t thread_count( ) {
+					return get_task_scheduler( )->size( );
+				}
+
+				/// <summary>Split [first, last) into chunks of chunk_size and run func( chunk, chunk_first, chunk_last ) for each on the library scheduler</summary>
+				/// <returns>The number of chunks</returns>
+				template<typename Function>
+				size_t run_chunks( size_t const first, size_t const last, size_t chunk_size, Function & func ) {
+					if( first >= last ) {
+						return 0;
+					}
+					chunk_size = std::max<size_t>( 1, chunk_size );
+					auto const chunk_count = (last - first + chunk_size - 1) / chunk_size;
+					if( 1 == chunk_count ) {
+						func( size_t{ 0 }, first, last );
+						return 1;
+					}
+					auto const run_chunk = [&func, first, last, chunk_size]( size_t chunk ) {
+						auto const chunk_first = first + chunk * chunk_size;
+						func( chunk, chunk_first, std::min( last, chunk_first + chunk_size ) );
+					};
+					// Queue a task per worker, each claiming chunks until none are left, instead of a task per chunk
+					std::atomic<size_t> next_chunk{ 0 };
+					auto task = [&run_chunk, &next_chunk, chunk_count]( ) {
+						for( auto chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++ ) {
+							run_chunk( chunk );
+						}
+					};
+					auto scheduler = get_task_scheduler( );
+					task_group group{ *scheduler };
+					auto const task_count = std::min( chunk_count, scheduler->size( ) );
+					for( size_t n = 0; n < task_count; ++n ) {
+						group.run( task );
+					}
+					group.wait( );
+					return chunk_count;
+				}
+
+				/// <summary>Split [0, count) into at most max_blocks contiguous blocks and run func( block, first, last ) for each in parallel.
+				/// The blocks only depend on count and max_blocks</summary>
+				/// <returns>The number of blocks used</returns>
+				template<typename Function>
+				size_t parallel_blocks( size_t const count, Function func, size_t max_blocks = 0 ) {
+					if( 0 == max_blocks ) {
+						max_blocks = thread_count( );
+					}
+					auto const block_count = std::max<size_t>( 1, std::min( count, max_blocks ) );
+					return run_chunks( 0, count, (count + block_count - 1) / block_count, func );
 				}
-#endif
+			}	// namespace impl
+
+			/// <summary>Run func( chunk_first, chunk_last ) over chunks of [first, last) in parallel.  Chunks are at least grain long</summary>
+			template<typename Function>
+			void parallel_for( size_t const first, size_t const last, Function func, size_t const grain = 1 ) {
+				if( first >= last ) {
+					return;
+				}
+				auto const max_chunks = impl::thread_count( ) * 4;
+				auto const chunk_size = std::max( grain, (last - first + max_chunks - 1) / max_chunks );
+				auto chunk_func = [&func]( size_t, size_t chunk_first, size_t chunk_last ) {
+					func( chunk_first, chunk_last );
+				};
+				impl::run_chunks( first, last, chunk_size, chunk_func );
 			}
 
-			template<typename ContainerType>
-			void parallel_for_each( const ContainerType& container, const std::function<void( typename ContainerType::const_reference )>& func ) {
-#if USE_PPL == 1
-				Concurrency::parallel_for_each( begin( container ), end( container ), func );
-#else
-#pragma omp parallel for
-				for( ptrdiff_t n = 0; n < static_cast<ptrdiff_t>(container.size( )); ++n ) {
-					func( container.item( static_cast<size_t>(n) ) );
+			/// <summary>Combine map( chunk_first, chunk_last ) over chunks of [first, last) with reduce, folding the chunks in order starting with init</summary>
+			template<typename T, typename Map, typename Reduce>
+			T parallel_reduce( size_t const first, size_t const last, T init, Map map, Reduce reduce, size_t const grain = 1 ) {
+				if( first >= last ) {
+					return init;
 				}
-#endif
+				auto const max_chunks = impl::thread_count( ) * 4;
+				auto const chunk_size = std::max( grain, (last - first + max_chunks - 1) / max_chunks );
+				std::vector<T> partials( (last - first + chunk_size - 1) / chunk_size, init );
+				auto chunk_func = [&map, &partials]( size_t chunk, size_t chunk_first, size_t chunk_last ) {
+					partials[chunk] = map( chunk_first, chunk_last );
+				};
+				impl::run_chunks( first, last, chunk_size, chunk_func );
+				for( auto const & partial : partials ) {
+					init = reduce( init, partial );
+				}
+				return init;
+			}
+
+			template<typename ContainerType, typename Function>
+			void parallel_for_each( ContainerType & container, Function func ) {
+				parallel_for( 0, container.size( ), [&container, &func]( size_t first, size_t last ) {
+					for( auto n = first; n < last; ++n ) {
+						func( container[n] );
+					}
+				} );
 			}
 
 			template<typename ContainerType>
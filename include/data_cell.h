@@ -23,9 +23,11 @@
 #pragma once
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/utility/string_view.hpp>
 #include <cinttypes>
 #include <cstdint>
 #include <ctime>
+#include <functional>
 #include <iomanip>
 #include <memory>
 #include <string>
@@ -53,28 +55,44 @@ namespace daw {
 			explicit DataCell( integer_t value );
 			explicit DataCell( real_t value );
 			explicit DataCell( timestamp_t value );
+			explicit DataCell( decimal_t value );
 
 			explicit operator bool( ) const noexcept;
 
 			std::string string( ) const;
+			/// <summary>View of the stored characters of a string cell.  Empty for all other types</summary>
+			boost::string_view string_view( ) const noexcept;
 			std::string to_string( std::string locale_str = "" ) const;
 			DataCellType type( ) const noexcept;
 			integer_t integer( ) const;
 			real_t real( ) const;
 			timestamp_t timestamp( ) const;
+			decimal_t decimal( ) const;
 			real_t numeric( ) const;
 			bool empty( ) const noexcept;
 
 			static DataCell from_string( cstring value, std::string locale_str = "" );
+			/// <summary>The type from_string would give value.  Never timestamp</summary>
+			static DataCellType detect_type( cstring const & value, std::string locale_str = "" );
+			/// <summary>Convert value to a cell of a type already found with detect_type</summary>
+			static DataCell from_string_as( cstring value, DataCellType type );
 			static DataCell from_time_string( std::string value, std::string format = "" );
+			/// <summary>A decimal cell at scale when value is a number, see decimal_t::parse.  Otherwise as from_string</summary>
+			static DataCell from_decimal_string( cstring value, uint8_t scale );
+			/// <summary>A string cell that points at value's characters without owning them, see Variant::borrowed.  Copies
+			/// of the cell own theirs</summary>
+			static DataCell borrowed_string( cstring value );
 
 			static const std::function<bool( DataCell const &, DataCell const & )> cmp_integer;
 			static const std::function<bool( DataCell const &, DataCell const & )> cmp_real;
 			static const std::function<bool( DataCell const &, DataCell const & )> cmp_timestamp;
+			static const std::function<bool( DataCell const &, DataCell const & )> cmp_decimal;
 			static const std::function<bool( DataCell const &, DataCell const & )> cmp_other;
 			static const std::function<bool( DataCell const &, DataCell const & )> get_compare( const DataCell& cell );
 
 			static int compare( const DataCell& lhs, DataCell const & );
+			static bool equal( DataCell const & lhs, DataCell const & rhs );
+			std::size_t hash( ) const;
 
 			bool operator==(DataCell const &) const;
 			bool operator<(DataCell const &) const;
@@ -97,3 +115,12 @@ namespace daw {
 		bool is_numeric( daw::data::DataCell const & value );
 	}	// namespace data
 }	// namespace daw
+
+namespace std {
+	template<>
+	struct hash<daw::data::DataCell> {
+		size_t operator( )( daw::data::DataCell const & cell ) const {
+			return cell.hash( );
+		}
+	};
+}
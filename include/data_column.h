@@ -22,22 +22,23 @@
 
 #pragma once
 
+#include <atomic>
+#include <boost/optional.hpp>
 #include <boost/utility/string_view.hpp>
 #include <functional>
+#include <iterator>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "column_sketches.h"
+#include "column_stats.h"
+#include "data_algorithms.h"
 #include "data_cell.h"
 #include "data_types.h"
-
-#if USE_PPL == 1
-#include <ppl.h>
-#else
-#ifdef _WIN32
-#include <omp.h>
-#endif
-#endif
-
+#include "memory_arena.h"
+#include "sparse_vector.h"
 
 namespace daw {
 	namespace data {
@@ -45,7 +46,7 @@ namespace daw {
 		class DataColumn final {
 		public:
 			using value_type = typename StorageType::value_type;
-			using reference = value_type&;
+			using reference = typename StorageType::reference;
 			using const_reference = const value_type&;
 			using values_type = StorageType;
 			using iterator = typename values_type::iterator;
@@ -54,15 +55,71 @@ namespace daw {
 			using const_reverse_iterator = typename values_type::const_reverse_iterator;
 			using difference_type = typename values_type::difference_type;
 			using size_type = typename values_type::size_type;
+			using allocator_type = typename values_type::allocator_type;
 		protected:
 			values_type m_items;
 			std::string m_header;
 			bool m_hidden;
+			mutable column_stats m_stats;
+			mutable boost::optional<column_sketches> m_sketches;
+			mutable std::atomic<bool> m_stats_stale;	// Set by erase and mutable access so the stats are rebuilt once, when next read
+			mutable std::mutex m_stats_mutex;	// Serializes the rebuild by const readers of this column
+			boost::optional<storage_width_t> m_width;
+			boost::optional<uint8_t> m_decimal_scale;
 
 			reference item( const size_type pos ) {
+				invalidate_stats( );
 				return m_items[pos];
 			}
 
+			/// <summary>A caller given mutable access may change cells without the stats seeing it</summary>
+			void invalidate_stats( ) noexcept {
+				if( !m_stats_stale.load( std::memory_order_relaxed ) ) {
+					m_stats_stale.store( true, std::memory_order_relaxed );
+				}
+			}
+
+			void add_stats( size_type row ) const {
+				values_type const & items = m_items;
+				m_stats.add( items[row], row, [&items]( size_t n ) -> value_type const & {
+					return items[n];
+				} );
+				if( m_sketches ) {
+					m_sketches->add( items[row] );
+				}
+			}
+
+			/// <summary>Account for the rows appended from first_row on, unless the stats are to be rebuilt anyway</summary>
+			void add_stats_from( size_type first_row ) {
+				if( m_stats_stale.load( std::memory_order_relaxed ) ) {
+					return;
+				}
+				for( auto row = first_row; row < m_items.size( ); ++row ) {
+					add_stats( row );
+				}
+			}
+
+			void rebuild_stats( ) const {
+				m_stats.clear( );
+				if( m_sketches ) {
+					m_sketches = column_sketches{ m_sketches->distinct.precision( ), m_sketches->quantiles.k( ) };
+				}
+				for( size_type row = 0; row < m_items.size( ); ++row ) {
+					add_stats( row );
+				}
+			}
+
+			/// <summary>Rebuild stale stats.  Const readers may call it together</summary>
+			void update_stats( ) const {
+				if( m_stats_stale.load( std::memory_order_acquire ) ) {
+					std::lock_guard<std::mutex> lock{ m_stats_mutex };
+					if( m_stats_stale.load( std::memory_order_relaxed ) ) {
+						rebuild_stats( );
+						m_stats_stale.store( false, std::memory_order_release );
+					}
+				}
+			}
+
 			const_reference item( const size_type pos ) const {
 				return m_items[pos];
 			}
@@ -71,26 +128,94 @@ namespace daw {
 			DataColumn( std::string header = "" ) noexcept:
 					m_items{ },
 					m_header{ std::move( header ) }, 
-					m_hidden{ false } { }
+					m_hidden{ false },
+					m_stats{ },
+					m_sketches{ },
+					m_stats_stale{ false },
+					m_stats_mutex{ },
+					m_width{ },
+					m_decimal_scale{ } { }
+
+			/// <summary>A column whose cells are stored by alloc</summary>
+			DataColumn( std::string header, allocator_type const & alloc ):
+					m_items( alloc ),
+					m_header{ std::move( header ) },
+					m_hidden{ false },
+					m_stats{ },
+					m_sketches{ },
+					m_stats_stale{ false },
+					m_stats_mutex{ },
+					m_width{ },
+					m_decimal_scale{ } { }
+
+			/// <summary>Move the cells and settings of a DataColumnDense into a column stored another way</summary>
+			template<typename OtherStorage, typename = typename std::enable_if<!std::is_same<OtherStorage, StorageType>::value>::type>
+			explicit DataColumn( DataColumn<OtherStorage> && other ):
+					m_items( other.m_items.get_allocator( ) ),
+					m_header{ std::move( other.m_header ) },
+					m_hidden{ other.m_hidden },
+					m_stats{ std::move( other.m_stats ) },
+					m_sketches{ std::move( other.m_sketches ) },
+					m_stats_stale{ other.m_stats_stale.load( ) },
+					m_stats_mutex{ },
+					m_width{ std::move( other.m_width ) },
+					m_decimal_scale{ std::move( other.m_decimal_scale ) } {
+
+				m_items.reserve( other.m_items.size( ) );
+				move_cells( m_items, std::move( other.m_items ) );
+				other.m_items.clear( );
+				other.m_stats.clear( );
+			}
+
+			template<typename>
+			friend class DataColumn;
 
 			~DataColumn( ) = default;
 
 
 			bool operator==( DataColumn const & ) const = delete;
 
-			DataColumn( DataColumn const & ) = default;
-			DataColumn & operator=( DataColumn const & ) = default;
+			DataColumn( DataColumn const & other ):
+					m_items( other.m_items ),
+					m_header{ other.m_header },
+					m_hidden{ other.m_hidden },
+					m_stats{ (other.update_stats( ), other.m_stats) },
+					m_sketches{ other.m_sketches },
+					m_stats_stale{ false },
+					m_stats_mutex{ },
+					m_width{ other.m_width },
+					m_decimal_scale{ other.m_decimal_scale } { }
+
+			DataColumn & operator=( DataColumn const & rhs ) {
+				if( this != &rhs ) {
+					DataColumn tmp{ rhs };
+					using std::swap;
+					swap( *this, tmp );
+				}
+				return *this;
+			}
 
 			DataColumn( DataColumn && other ) noexcept: 
 				m_items{ std::move( other.m_items ) }, 
 				m_header{ std::move( other.m_header ) }, 
-				m_hidden{ std::move( other.m_hidden ) } { }
+				m_hidden{ std::move( other.m_hidden ) },
+				m_stats{ std::move( other.m_stats ) },
+				m_sketches{ std::move( other.m_sketches ) },
+				m_stats_stale{ other.m_stats_stale.load( ) },
+				m_stats_mutex{ },
+				m_width{ std::move( other.m_width ) },
+				m_decimal_scale{ std::move( other.m_decimal_scale ) } { }
 
 			friend void swap( DataColumn & lhs, DataColumn & rhs ) noexcept {
 				using std::swap;
 				swap( lhs.m_items, rhs.m_items );
 				swap( lhs.m_header, rhs.m_header );
 				swap( lhs.m_hidden, rhs.m_hidden );
+				swap( lhs.m_stats, rhs.m_stats );
+				swap( lhs.m_sketches, rhs.m_sketches );
+				lhs.m_stats_stale = rhs.m_stats_stale.exchange( lhs.m_stats_stale.load( ) );
+				swap( lhs.m_width, rhs.m_width );
+				swap( lhs.m_decimal_scale, rhs.m_decimal_scale );
 			}
 
 			DataColumn& operator=( DataColumn && rhs ) noexcept {
@@ -111,22 +236,168 @@ namespace daw {
 				values.shrink_to_fit( );
 			}
 
+			void reserve( size_type count ) {
+				m_items.reserve( count );
+			}
+
+			size_type capacity( ) const noexcept {
+				return m_items.capacity( );
+			}
+
+			allocator_type get_allocator( ) const {
+				return m_items.get_allocator( );
+			}
+
+			/// <summary>Store only the cells that are not empty.  Only a DataColumnSparse has it</summary>
+			template<typename Storage = StorageType>
+			auto make_sparse( ) -> decltype( std::declval<Storage &>( ).make_sparse( ) ) {
+				m_items.make_sparse( );
+			}
+
+			/// <summary>Store every cell again.  Reading and assigning cells keep a DataColumnSparse sparse, only inserting
+			/// before the end makes it dense itself</summary>
+			template<typename Storage = StorageType>
+			auto make_dense( ) -> decltype( std::declval<Storage &>( ).make_dense( ) ) {
+				m_items.make_dense( );
+			}
+
+			template<typename Storage = StorageType>
+			auto is_sparse( ) const noexcept -> decltype( std::declval<Storage const &>( ).is_sparse( ) ) {
+				return m_items.is_sparse( );
+			}
+
 			void append( value_type value ) {
 				m_items.push_back( std::move( value ) );
+				add_stats_from( m_items.size( ) - 1 );
+			}
+
+			/// <summary>Append a range.  Pass move iterators to move the cells out of a std::vector</summary>
+			template<typename Iterator>
+			void append( Iterator first, Iterator last ) {
+				auto const row = m_items.size( );
+				m_items.insert( m_items.end( ), first, last );
+				add_stats_from( row );
+			}
+
+			/// <summary>Move the cells of other to the end of this column and leave other empty.  A sparse other is not made
+			/// dense first</summary>
+			void append( DataColumn && other ) {
+				auto const row = m_items.size( );
+				move_append( m_items, std::move( other.m_items ) );
+				other.clear( );
+				add_stats_from( row );
+			}
+
+			template<typename T, typename Alloc>
+			inline static void move_append( std::vector<T, Alloc> & values, std::vector<T, Alloc> && other ) {
+				values.insert( values.end( ), std::make_move_iterator( other.begin( ) ), std::make_move_iterator( other.end( ) ) );
+			}
+
+			template<typename T, typename Alloc, typename IsEmpty>
+			inline static void move_append( sparse_vector_t<T, Alloc, IsEmpty> & values, sparse_vector_t<T, Alloc, IsEmpty> && other ) {
+				values.append( std::move( other ) );
+			}
+
+			template<typename T, typename Alloc>
+			inline static void move_cells( values_type & values, std::vector<T, Alloc> && other ) {
+				for( auto & cell : other ) {
+					values.push_back( std::move( cell ) );
+				}
+			}
+
+			/// <summary>Copies, reading other through const so its empty cells are not stored first</summary>
+			template<typename T, typename Alloc, typename IsEmpty>
+			inline static void move_cells( values_type & values, sparse_vector_t<T, Alloc, IsEmpty> && other ) {
+				auto const & cells = other;
+				for( auto const & cell : cells ) {
+					values.push_back( cell );
+				}
 			}
 
 			iterator erase( iterator first ) {
 				auto ret = m_items.erase( first );
+				m_stats_stale = true;
 				return ret;
 			}
 
 			iterator erase( iterator first, iterator last ) {
 				auto ret = m_items.erase( first, last );
+				m_stats_stale = true;
 				return ret;
 			}
 
 			void erase_item( size_type pos ) {
 				m_items.erase( m_items.begin( ) + static_cast<difference_type>(pos) );
+				m_stats_stale = true;
+			}
+
+			/// <summary>Statistics of the cells.  append keeps them current.  After an erase, or once a mutable reference or
+			/// iterator has been handed out, they are rebuilt once on the next read, so erasing row by row is not quadratic.
+			/// Read cells through a const column to keep the stats of a large column current</summary>
+			column_stats const & stats( ) const {
+				update_stats( );
+				return m_stats;
+			}
+
+			/// <summary>Start keeping distinct count and quantile sketches of the cells, beginning with those already here.
+			/// They are kept like stats( ) but cost more per append so are off by default</summary>
+			void enable_sketches( uint8_t precision = 12, size_t k = 200 ) {
+				update_stats( );
+				m_sketches = column_sketches{ precision, k };
+				values_type const & items = m_items;
+				for( auto const & cell : items ) {
+					m_sketches->add( cell );
+				}
+			}
+
+			boost::optional<column_sketches> const & sketches( ) const {
+				update_stats( );
+				return m_sketches;
+			}
+
+			/// <summary>How the column is stored when packed.  The width given to set_width, else the narrowest that
+			/// holds the cells exactly</summary>
+			storage_width_t width( ) const {
+				return m_width ? *m_width : stats( ).width( );
+			}
+
+			/// <summary>Force the storage width, as a schema does.  none goes back to inferring it</summary>
+			void set_width( storage_width_t width ) {
+				if( storage_width_t::none == width ) {
+					m_width = boost::none;
+				} else {
+					m_width = width;
+				}
+			}
+
+			bool width_is_forced( ) const noexcept {
+				return static_cast<bool>(m_width);
+			}
+
+			/// <summary>The scale numbers are parsed at as decimal_t, none when they are parsed as integers and reals</summary>
+			boost::optional<uint8_t> const & decimal_scale( ) const noexcept {
+				return m_decimal_scale;
+			}
+
+			void set_decimal_scale( boost::optional<uint8_t> scale ) {
+				m_decimal_scale = std::move( scale );
+			}
+
+			void refresh_stats( ) {
+				rebuild_stats( );
+				m_stats_stale = false;
+			}
+
+			/// <summary>Each cell as to_string( locale_str ) gives it.  Blocks of rows are converted in parallel</summary>
+			std::vector<std::string> to_strings( std::string const & locale_str = "" ) const {
+				std::vector<std::string> result( m_items.size( ) );
+				algorithm::parallel_for( 0, result.size( ), [&]( size_t first, size_t last ) {
+					auto cell = m_items.cbegin( ) + static_cast<difference_type>(first);
+					for( auto row = first; row < last; ++row, ++cell ) {
+						result[row] = cell->to_string( locale_str );
+					}
+				}, 1024 );
+				return result;
 			}
 
 			std::string const & header( ) const {
@@ -154,10 +425,12 @@ namespace daw {
 			}
 
 			iterator begin( ) {
+				invalidate_stats( );
 				return m_items.begin( );
 			}
 
 			iterator end( ) {
+				invalidate_stats( );
 				return m_items.end( );
 			}
 
@@ -178,10 +451,12 @@ namespace daw {
 			}
 
 			reverse_iterator rbegin( ) {
+				invalidate_stats( );
 				return m_items.rbegin( );
 			}
 
 			reverse_iterator rend( ) {
+				invalidate_stats( );
 				return m_items.rend( );
 			}
 
@@ -211,9 +486,16 @@ namespace daw {
 
 			void clear( ) {
 				m_items.clear( );
+				refresh_stats( );
 			}
 		};	// DataColumn
 
-		void convert_column_to_timestamp( DataColumn<std::vector<DataCell>> & column, bool is_nullable = true, boost::string_view format = "%d/%m/%y %H:%M:%S" );
+		using DataColumnDense = DataColumn<std::vector<DataCell, arena_allocator_t<DataCell>>>;
+
+		/// <summary>A column that can store only its cells that are not empty, see sparse_vector_t</summary>
+		using DataColumnSparse = DataColumn<sparse_vector_t<DataCell, arena_allocator_t<DataCell>>>;
+
+		void convert_column_to_timestamp( DataColumnDense & column, bool is_nullable = true, boost::string_view format = "%d/%m/%y %H:%M:%S" );
+		void convert_column_to_timestamp( DataColumnSparse & column, bool is_nullable = true, boost::string_view format = "%d/%m/%y %H:%M:%S" );
 	}	// namespace data
 }	// namespace daw
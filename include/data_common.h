@@ -22,7 +22,27 @@
 
 #pragma once
 
+#include "cancellation_token.h"
+#include "column_sketches.h"
+#include "column_stats.h"
+#include "compressed_column.h"
+#include "data_aggregate.h"
 #include "data_cell.h"
 #include "data_column.h"
+#include "data_expression.h"
+#include "data_join.h"
+#include "data_matrix.h"
+#include "data_sort_key.h"
 #include "data_table.h"
+#include "data_table_view.h"
 #include "data_types.h"
+#include "decimal.h"
+#include "lazy_table.h"
+#include "memory_arena.h"
+#include "packed_column.h"
+#include "parse_async.h"
+#include "parse_files.h"
+#include "parse_stats.h"
+#include "row_index.h"
+#include "sparse_vector.h"
+#include "spill_table.h"
@@ -0,0 +1,90 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "data_table.h"
+#include "data_table_view.h"
+
+namespace daw {
+	namespace data {
+		namespace expression {
+			namespace impl {
+				struct node_t;
+			}
+
+			/// <summary>An immutable expression tree over the columns of a table.  Build with column( ), lag( ), literal( ) and the operators below</summary>
+			class expression_t {
+				std::shared_ptr<impl::node_t const> m_node;
+			public:
+				explicit expression_t( std::shared_ptr<impl::node_t const> node ) noexcept;
+				std::shared_ptr<impl::node_t const> const & node( ) const noexcept;
+			};
+
+			/// <summary>Reference to the value of a column in the current row</summary>
+			expression_t column( std::string name );
+			/// <summary>Reference to the value of a column count rows before the current row.  Null for the first count rows</summary>
+			expression_t lag( std::string name, size_t count = 1 );
+			expression_t literal( int64_t value );
+			expression_t literal( double value );
+
+			/// <summary>Integer results that do not fit in int64_t are null</summary>
+			expression_t operator+( expression_t const & lhs, expression_t const & rhs );
+			expression_t operator-( expression_t const & lhs, expression_t const & rhs );
+			expression_t operator*( expression_t const & lhs, expression_t const & rhs );
+			/// <summary>Always real.  Division by zero is null</summary>
+			expression_t operator/( expression_t const & lhs, expression_t const & rhs );
+			/// <summary>Null for the smallest int64_t, which has no negation</summary>
+			expression_t operator-( expression_t const & value );
+
+			expression_t operator==( expression_t const & lhs, expression_t const & rhs );
+			expression_t operator!=( expression_t const & lhs, expression_t const & rhs );
+			expression_t operator<( expression_t const & lhs, expression_t const & rhs );
+			expression_t operator<=( expression_t const & lhs, expression_t const & rhs );
+			expression_t operator>( expression_t const & lhs, expression_t const & rhs );
+			expression_t operator>=( expression_t const & lhs, expression_t const & rhs );
+
+			/// <summary>Non-zero values are true</summary>
+			expression_t operator&&( expression_t const & lhs, expression_t const & rhs );
+			expression_t operator||( expression_t const & lhs, expression_t const & rhs );
+			expression_t operator!( expression_t const & value );
+
+			// Expressions are evaluated a batch of rows at a time over typed buffers.  Integer cells load as
+			// int64_t, real cells as double and timestamps as microseconds since the epoch.  A column with any
+			// real or decimal cell loads as double in every batch, so a result column has one numeric type.
+			// Any other cell is null and nulls propagate through every operator
+
+			/// <summary>Evaluate expr for every row into a new column named header</summary>
+			DataTable::value_type evaluate_column( DataTable const & table, expression_t const & expr, std::string header = "" );
+			DataTable::value_type evaluate_column( TableView const & table, expression_t const & expr, std::string header = "" );
+
+			/// <summary>Evaluate expr for every row into a mask suitable for TableView::filter.  Null and zero results are 0</summary>
+			std::vector<uint8_t> evaluate_filter( DataTable const & table, expression_t const & expr );
+			std::vector<uint8_t> evaluate_filter( TableView const & table, expression_t const & expr );
+		}	// namespace expression
+	}	// namespace data
+}	// namespace daw
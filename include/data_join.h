@@ -0,0 +1,47 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "data_table.h"
+
+namespace daw {
+	namespace data {
+		namespace algorithm {
+			enum class join_type: int8_t { inner = 0, left = 1, semi = 2 };
+
+			/// <summary>Join two tables on equality of one or more key columns using a partitioned hash table built from right</summary>
+			/// <param name="left">Probe side.  Output rows keep the order of left</param>
+			/// <param name="right">Build side.  Usually the smaller lookup table</param>
+			/// <param name="left_keys">Key column names in left</param>
+			/// <param name="right_keys">Key column names in right, matched positionally with left_keys</param>
+			/// <param name="type">inner and left output the left columns followed by the non-key right columns.  When a right column has the
+			/// same name as a left one they become left.name and right.name.  semi outputs the left columns of rows with at least one match</param>
+			/// <returns>A <c>DataTable</c> whose cells are gathered by row index from left and right.  Empty key cells never match.  integer, real and decimal keys
+			/// match when their values are equal, so 5, 5.0 and a decimal 5.00 are the same key</returns>
+			DataTable hash_join( DataTable const & left, DataTable const & right, std::vector<std::string> const & left_keys, std::vector<std::string> const & right_keys, join_type type = join_type::inner );
+		}	// namespace algorithm
+	}	// namespace data
+}	// namespace daw
@@ -0,0 +1,77 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "data_table.h"
+
+namespace daw {
+	namespace data {
+		enum class matrix_layout: int8_t { row_major = 0, column_major = 1 };
+
+		/// <summary>Dense matrix of doubles whose storage is aligned to numeric_matrix_t::alignment bytes</summary>
+		class numeric_matrix_t final {
+			struct free_t {
+				void operator( )( double * ptr ) const noexcept;
+			};
+			std::unique_ptr<double, free_t> m_data;
+			size_t m_rows;
+			size_t m_columns;
+			matrix_layout m_layout;
+		public:
+			static constexpr size_t const alignment = 64;
+
+			numeric_matrix_t( size_t rows, size_t columns, matrix_layout layout );
+			~numeric_matrix_t( ) = default;
+			numeric_matrix_t( numeric_matrix_t && ) noexcept = default;
+			numeric_matrix_t & operator=( numeric_matrix_t && ) noexcept = default;
+			numeric_matrix_t( numeric_matrix_t const & ) = delete;
+			numeric_matrix_t & operator=( numeric_matrix_t const & ) = delete;
+
+			double * data( ) noexcept;
+			double const * data( ) const noexcept;
+			size_t rows( ) const noexcept;
+			size_t columns( ) const noexcept;
+			matrix_layout layout( ) const noexcept;
+
+			double & operator( )( size_t row, size_t column ) noexcept;
+			double const & operator( )( size_t row, size_t column ) const noexcept;
+		};
+
+		/// <summary>Write the integer, real and decimal cells of columns into out as doubles</summary>
+		/// <param name="columns">Names of the columns to export, in matrix column order</param>
+		/// <param name="out">Room for row count * columns.size( ) doubles</param>
+		/// <param name="layout">row_major puts row r, column c at out[r * columns.size( ) + c], column_major at out[c * row count + r]</param>
+		/// <param name="null_value">Written for empty, string and timestamp cells</param>
+		void export_numeric( DataTable const & table, std::vector<std::string> const & columns, double * out, matrix_layout layout, double null_value = std::numeric_limits<double>::quiet_NaN( ) );
+
+		/// <summary>export_numeric into a newly allocated, aligned matrix</summary>
+		numeric_matrix_t export_numeric( DataTable const & table, std::vector<std::string> const & columns, matrix_layout layout, double null_value = std::numeric_limits<double>::quiet_NaN( ) );
+	}	// namespace data
+}	// namespace daw
@@ -0,0 +1,58 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "data_cell.h"
+#include "data_table.h"
+
+namespace daw {
+	namespace data {
+		// Normalized sort keys are byte strings whose memcmp order is the order of the cells they encode.
+		// Each cell is a type tag followed by an order preserving encoding of its value, so the keys of
+		// several cells can be concatenated and a multi-column comparison becomes a single memcmp.
+		// Empty cells sort first, then integers, reals, timestamps, strings and decimals.
+
+		/// <summary>Append the normalized key of cell to key</summary>
+		/// <param name="descending">Invert the encoding so this cell sorts in descending order</param>
+		void append_sort_key( std::string & key, DataCell const & cell, bool descending = false );
+
+		std::string sort_key( DataCell const & cell, bool descending = false );
+
+		/// <summary>Normalized key of several cells, compared left to right</summary>
+		template<typename... Cells>
+		std::string sort_key( DataCell const & first, DataCell const & second, Cells const &... rest ) {
+			std::string result;
+			for( auto const cell : { &first, &second, &rest... } ) {
+				append_sort_key( result, *cell );
+			}
+			return result;
+		}
+
+		/// <summary>Normalized key of every row of table over columns, built in parallel</summary>
+		/// <param name="descending">Empty or one entry per column</param>
+		std::vector<std::string> sort_keys( DataTable const & table, std::vector<std::string> const & columns, std::vector<bool> const & descending = std::vector<bool>{ } );
+	}	// namespace data
+}	// namespace daw
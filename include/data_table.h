@@ -22,9 +22,11 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <boost/utility/string_view.hpp>
 #include <functional>
 #include <list>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -32,19 +34,20 @@
 #include <daw/daw_expected.h>
 
 #include "defs.h"
-#if defined( USE_SPARSE_VECTOR ) && USE_SPARSE_VECTOR == 1
-#include "sparse_vector.h"
-#endif
 
+#include "cancellation_token.h"
 #include "data_cell.h"
 #include "data_column.h"
 #include "data_types.h"
+#include "memory_arena.h"
+#include "parse_stats.h"
 
 namespace daw {
 	namespace data {
 		struct DataTable {
 			using cell_type = DataCell;
-			using value_type = DataColumn < std::vector<cell_type> > ;
+			using value_type = DataColumnDense;
+			using allocator_type = value_type::allocator_type;
 			//TODO static_assert(daw::traits::is_regular<value_type>::value, "DataColumn isn't regular");
 			using values_type = std::vector < value_type > ;
 			using reference = value_type&;
@@ -85,6 +88,8 @@ namespace daw {
 
 			size_type size( ) const noexcept;
 			bool empty( ) const noexcept;
+			/// <summary>The allocator of the first column, the heap when there are none</summary>
+			allocator_type get_allocator( ) const;
 
 			size_type get_column_index( boost::string_view col ) const;
 
@@ -117,12 +122,24 @@ namespace daw {
 
 		struct parse_csv_data_param final {
 			using column_filter_t = std::function<bool( std::string const & )>;
-			using progress_cb_t = std::function<void( std::string )>;
+			using progress_cb_t = std::function<void( parse_progress const & )>;
 		private:
 			std::string m_file_name;
 			DataTable::size_type m_header_row;
 			column_filter_t m_column_filter;
 			progress_cb_t m_progress_cb;
+			cancellation_token m_cancel_token;
+			boost::optional<parse_clock_t::time_point> m_deadline;
+			boost::optional<size_t> m_row_limit;
+			boost::optional<size_t> m_sample_rows;
+			uint64_t m_sample_seed;
+			bool m_sketches;
+			std::map<std::string, storage_width_t> m_column_widths;
+			std::map<std::string, uint8_t> m_decimal_scales;
+			boost::optional<size_t> m_memory_budget;
+			std::string m_spill_directory;
+			memory_arena_t * m_memory_arena;
+			double m_sparse_threshold;
 		public:
 			parse_csv_data_param( ) = delete;
 			~parse_csv_data_param( ) = default;
@@ -135,19 +152,84 @@ namespace daw {
 			bool operator==( parse_csv_data_param const & ) const = delete;
 
 			std::string const & file_name( ) const noexcept;
+			void set_file_name( std::string file_name );
 			DataTable::size_type const & header_row( ) const noexcept;
 			std::function<bool( std::string const & )> const & column_filter( ) const noexcept;
-			std::function<void( std::string )> const & progress_cb( ) const noexcept;
+			progress_cb_t const & progress_cb( ) const noexcept;
+
+			/// <summary>The parse stops with an operation_cancelled error soon after token.cancel( ) is called</summary>
+			void set_cancel_token( cancellation_token token );
+			cancellation_token const & cancel_token( ) const noexcept;
+			/// <summary>The parse stops with an operation_cancelled error if it is still running at deadline</summary>
+			void set_deadline( parse_clock_t::time_point deadline );
+			boost::optional<parse_clock_t::time_point> const & deadline( ) const noexcept;
+			/// <summary>Stop after rows data rows</summary>
+			void set_row_limit( size_t rows );
+			boost::optional<size_t> const & row_limit( ) const noexcept;
+			/// <summary>Parse the header and up to rows data rows drawn uniformly at random without replacement, kept in file order,
+			/// instead of the whole file.  Rows are found from random byte offsets and only the bytes near them are read, so a
+			/// sample of a huge file is cheap.  Rows whose cell count differs from the header's are never chosen, and fewer rows
+			/// are returned when the file has fewer or too many draws fail</summary>
+			void set_sample( size_t rows, uint64_t seed = 0 );
+			boost::optional<size_t> const & sample_rows( ) const noexcept;
+			uint64_t sample_seed( ) const noexcept;
+			/// <summary>Give every column distinct count and quantile sketches, see DataColumn::enable_sketches</summary>
+			void set_sketches( bool enabled );
+			bool sketches( ) const noexcept;
+			/// <summary>Store the column with this header at width when packed by pack_numeric_columns instead of the inferred one.
+			/// The parsed cells are always integer_t and real_t</summary>
+			void set_column_width( std::string header, storage_width_t width );
+			/// <summary>The width set for header or none</summary>
+			storage_width_t column_width( std::string const & header ) const;
+			/// <summary>Parse the numbers of the column with this header as decimal_t at scale.  Its other cells are detected as usual</summary>
+			void set_decimal_scale( std::string header, uint8_t scale );
+			boost::optional<uint8_t> decimal_scale( std::string const & header ) const;
+			/// <summary>About how many bytes of cells a parse may hold, see cell_resident_size.  Only parse_csv_spill stays
+			/// within it by spilling to disk, and its spill_table_t is read as a DataTable is.  A DataTable holds every cell,
+			/// so parse_csv_data returns an error once the cells pass the budget instead of being killed for running out of
+			/// memory.  parse_csv_lazy does not use it</summary>
+			void set_memory_budget( size_t bytes );
+			boost::optional<size_t> const & memory_budget( ) const noexcept;
+			/// <summary>Where parse_csv_spill creates its spill file, the system temporary directory when empty</summary>
+			void set_spill_directory( std::string directory );
+			std::string const & spill_directory( ) const noexcept;
+			/// <summary>parse_csv_data stores the cells of its columns and the characters of its string cells in arena, which
+			/// must outlive the table.  nullptr, the default, uses the heap.  parse_csv_files gives each file a child arena</summary>
+			void set_memory_arena( memory_arena_t * arena );
+			memory_arena_t * memory_arena( ) const noexcept;
+			/// <summary>parse_csv_sparse stores a column sparse, see DataColumnSparse, when more than this fraction of its cells
+			/// are empty.  0.9 by default, 1 or above never.  The other parses always store DataColumnDense</summary>
+			void set_sparse_threshold( double ratio );
+			double sparse_threshold( ) const noexcept;
 		};
 		//TOOD static_assert(daw::traits::is_regular<parse_csv_data_param>::value, "parse_csv_data_param isn't regular");
 
+		/// <summary>Adapts a callback written for the old text progress messages.  It is passed to_string( progress )</summary>
+		parse_csv_data_param::progress_cb_t text_progress_cb( std::function<void( std::string )> text_cb );
+
 		/// <summary>Parse a CSV File</summary>
 		/// <param name="file_name">Path to CSV Text File with header</param>
 		/// <param name="header_row">Numeric row in file that contains the header.  This will be the first line imported</param>
 		/// <param name="column_filter">A function that returns true if the column name is allowed</param>
+		/// <param name="progress_cb">Called about every 5MB while tokenizing, once when post processing starts and once when complete.  Wrap a callback taking the old text messages with text_progress_cb</param>
 		/// <returns>A <c>DataTable</c> with the contents of the CSV File</returns>
-		expected_t<DataTable> parse_csv_data( const std::string &file_name, const DataTable::size_type header_row, const std::function<bool( const std::string& )> column_filter = nullptr, std::function<void( std::string )> progress_cb = nullptr );
+		expected_t<DataTable> parse_csv_data( const std::string &file_name, const DataTable::size_type header_row, const std::function<bool( const std::string& )> column_filter = nullptr, parse_csv_data_param::progress_cb_t progress_cb = nullptr );
 		expected_t<DataTable> parse_csv_data( const parse_csv_data_param& param );
+		/// <summary>Parse a CSV File and fill stats.  The phase timings read the clock for every cell so they are only taken here</summary>
+		expected_t<DataTable> parse_csv_data( const parse_csv_data_param& param, parse_stats & stats );
+
+		/// <summary>Columns that may each be stored sparse or dense</summary>
+		using sparse_columns_t = std::vector<DataColumnSparse>;
+
+		/// <summary>Move the columns of table to sparse_columns_t, storing sparse those with more than threshold of their cells empty</summary>
+		sparse_columns_t to_sparse_columns( DataTable table, double threshold );
+
+		/// <summary>Parse a CSV File as parse_csv_data does and store sparse the columns with more than param.sparse_threshold( )
+		/// of their cells empty.  The storage is chosen while tokenizing: every column starts sparse and is made dense once
+		/// it has 1024 rows and too few of them are empty, so the empty cells of a sparse column are never held.  Sparse storage
+		/// is opt in as its non-const cell access is an element_reference, not a DataCell &</summary>
+		expected_t<sparse_columns_t> parse_csv_sparse( parse_csv_data_param const & param );
+		expected_t<sparse_columns_t> parse_csv_sparse( parse_csv_data_param const & param, parse_stats & stats );
 
 		namespace algorithm {
 			void erase_row( DataTable& table, const DataTable::size_type row );
@@ -0,0 +1,204 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <boost/utility/string_view.hpp>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "data_table.h"
+
+namespace daw {
+	namespace data {
+		/// <summary>Row positions in the parent table, ascending.  A null selection means every row</summary>
+		using selection_t = std::vector<DataTable::size_type>;
+		using selection_ptr_t = std::shared_ptr<selection_t const>;
+
+		class ColumnView {
+			DataTable::value_type const * m_column;
+			selection_ptr_t m_rows;
+		public:
+			using value_type = DataTable::cell_type;
+			using const_reference = value_type const &;
+			using size_type = DataTable::size_type;
+
+			/// <summary>Holds the column and selection rather than the view, so it stays valid after a temporary ColumnView
+			/// such as the one returned by TableView::operator[] is gone</summary>
+			class const_iterator {
+				DataTable::value_type const * m_column;
+				selection_t const * m_rows;
+				size_type m_pos;
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = ColumnView::value_type;
+				using difference_type = std::ptrdiff_t;
+				using pointer = value_type const *;
+				using reference = value_type const &;
+
+				const_iterator( DataTable::value_type const * column, selection_t const * rows, size_type pos ) noexcept:
+						m_column{ column },
+						m_rows{ rows },
+						m_pos{ pos } { }
+
+				reference operator*( ) const {
+					return (*m_column)[m_rows ? (*m_rows)[m_pos] : m_pos];
+				}
+
+				pointer operator->( ) const {
+					return &**this;
+				}
+
+				const_iterator & operator++( ) noexcept {
+					++m_pos;
+					return *this;
+				}
+
+				const_iterator operator++( int ) noexcept {
+					auto result = *this;
+					++m_pos;
+					return result;
+				}
+
+				bool operator==( const_iterator const & rhs ) const noexcept {
+					return m_pos == rhs.m_pos && m_column == rhs.m_column && m_rows == rhs.m_rows;
+				}
+
+				bool operator!=( const_iterator const & rhs ) const noexcept {
+					return !(*this == rhs);
+				}
+			};
+			using iterator = const_iterator;
+
+			ColumnView( DataTable::value_type const & column, selection_ptr_t rows ) noexcept;
+
+			const_reference operator[]( size_type row ) const {
+				return (*m_column)[m_rows ? (*m_rows)[row] : row];
+			}
+
+			size_type size( ) const noexcept;
+			bool empty( ) const noexcept;
+			std::string const & header( ) const noexcept;
+			DataTable::value_type const & parent( ) const noexcept;
+
+			const_iterator begin( ) const noexcept;
+			const_iterator end( ) const noexcept;
+			const_iterator cbegin( ) const noexcept;
+			const_iterator cend( ) const noexcept;
+		};	// ColumnView
+
+		/// <summary>A filtered and projected view of a DataTable.  No cells are copied until materialize( ) is called.
+		/// The parent table must outlive the view and not be modified while it is in use</summary>
+		class TableView {
+			DataTable const * m_parent;
+			selection_ptr_t m_rows;
+			std::vector<DataTable::size_type> m_columns;	// positions of the projected columns in the parent
+		public:
+			using value_type = ColumnView;
+			using size_type = DataTable::size_type;
+
+			class const_iterator {
+				TableView const * m_view;
+				size_type m_pos;
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = ColumnView;
+				using difference_type = std::ptrdiff_t;
+				using pointer = void;
+				using reference = ColumnView;
+
+				const_iterator( TableView const * view, size_type pos ) noexcept: m_view{ view }, m_pos{ pos } { }
+
+				ColumnView operator*( ) const {
+					return (*m_view)[m_pos];
+				}
+
+				const_iterator & operator++( ) noexcept {
+					++m_pos;
+					return *this;
+				}
+
+				const_iterator operator++( int ) noexcept {
+					auto result = *this;
+					++m_pos;
+					return result;
+				}
+
+				bool operator==( const_iterator const & rhs ) const noexcept {
+					return m_pos == rhs.m_pos && m_view == rhs.m_view;
+				}
+
+				bool operator!=( const_iterator const & rhs ) const noexcept {
+					return !(*this == rhs);
+				}
+			};
+			using iterator = const_iterator;
+
+			explicit TableView( DataTable const & parent );
+			TableView( DataTable const & parent, selection_ptr_t rows, std::vector<size_type> columns );
+
+			ColumnView operator[]( size_type column ) const;
+			ColumnView operator[]( boost::string_view column ) const;
+
+			/// <summary>Number of columns, as with DataTable</summary>
+			size_type size( ) const noexcept;
+			bool empty( ) const noexcept;
+			size_type row_count( ) const noexcept;
+			/// <summary>Position in the parent table of row</summary>
+			size_type parent_row( size_type row ) const noexcept;
+			DataTable const & parent( ) const noexcept;
+
+			const_iterator begin( ) const noexcept;
+			const_iterator end( ) const noexcept;
+			const_iterator cbegin( ) const noexcept;
+			const_iterator cend( ) const noexcept;
+
+			/// <summary>Keep the rows of this view for which pred( row, view ) is true.  Views stack without copying cells</summary>
+			template<typename Predicate>
+			TableView filter( Predicate pred ) const {
+				auto rows = std::make_shared<selection_t>( );
+				for( size_type row = 0; row < row_count( ); ++row ) {
+					if( pred( row, *this ) ) {
+						rows->push_back( parent_row( row ) );
+					}
+				}
+				return TableView{ *m_parent, std::move( rows ), m_columns };
+			}
+
+			/// <summary>Keep the rows of this view whose entry in keep is non-zero.  keep must have row_count( ) entries</summary>
+			TableView filter( std::vector<uint8_t> const & keep ) const;
+
+			/// <summary>Keep the rows of this view at the positions given.  Throws when they are not strictly ascending, so a row is never
+			/// repeated, or are past the end</summary>
+			TableView select_rows( selection_t const & rows ) const;
+
+			/// <summary>Project the named columns, in the order given</summary>
+			TableView select_columns( std::vector<std::string> const & columns ) const;
+
+			/// <summary>Copy the selected cells of the projected columns into a new DataTable</summary>
+			DataTable materialize( ) const;
+		};	// TableView
+	}	// namespace data
+}	// namespace daw
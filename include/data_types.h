@@ -23,18 +23,34 @@
 #pragma once
 
 #include <boost/date_time/posix_time/ptime.hpp>
+#include <cstddef>
 #include <cstdint>
 
 namespace daw {
 	namespace data {
-		using real_t = float;
-		using integer_t = int32_t;
+		// Cells hold the widest values so nothing parsed is lost.  Columns that need less are stored narrower when
+		// packed, see storage_width_t
+		using real_t = double;
+		using integer_t = int64_t;
 		using timestamp_t = boost::posix_time::ptime;
-		enum class DataCellType: int8_t { empty_string = 0, integer = 1, real = 2, string = 3, timestamp = 4 };
+		enum class DataCellType: int8_t { empty_string = 0, integer = 1, real = 2, string = 3, timestamp = 4, decimal = 5 };
+
+		/// <summary>How the values of a numeric column are stored when packed.  none for columns that are not numeric</summary>
+		enum class storage_width_t: int8_t { none = 0, int8 = 1, int16 = 2, int32 = 3, int64 = 4, float32 = 5, float64 = 6 };
+
+		/// <summary>Bytes per value of width</summary>
+		constexpr size_t storage_bytes( storage_width_t width ) noexcept {
+			return storage_width_t::int8 == width ? 1 :
+				storage_width_t::int16 == width ? 2 :
+				storage_width_t::int32 == width || storage_width_t::float32 == width ? 4 :
+				storage_width_t::none == width ? 0 : 8;
+		}
+
+		constexpr bool is_integer_width( storage_width_t width ) noexcept {
+			return storage_width_t::int8 <= width && width <= storage_width_t::int64;
+		}
 
 		class DataCell;
-		class DataColumnDense;
-		class DataColumnSparse;
 		class DataTable;
 	}
 }
@@ -0,0 +1,81 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <boost/utility/string_view.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace daw {
+	namespace data {
+		/// <summary>Fixed point number stored as units / 10^scale in an int64_t, so money adds and compares exactly</summary>
+		class decimal_t final {
+			int64_t m_units;
+			uint8_t m_scale;
+		public:
+			static constexpr uint8_t const max_scale = 18;
+			/// <summary>Longest text format writes, -9.223372036854775808</summary>
+			static constexpr size_t const max_chars = 21;
+
+			constexpr decimal_t( ) noexcept: m_units{ 0 }, m_scale{ 0 } { }
+			/// <summary>units / 10^scale.  Throws when scale is past max_scale</summary>
+			decimal_t( int64_t units, uint8_t scale );
+
+			int64_t units( ) const noexcept;
+			uint8_t scale( ) const noexcept;
+
+			/// <summary>Parse [-+]digits[.digits] by accumulating digits, without floating point.  Fraction digits past
+			/// scale round half away from zero</summary>
+			/// <returns>none when text is not a number of that form or does not fit at scale</returns>
+			static boost::optional<decimal_t> parse( boost::string_view text, uint8_t scale ) noexcept;
+
+			/// <summary>The same value at scale, rounded half away from zero when scale is smaller.  Throws on overflow</summary>
+			decimal_t rescale( uint8_t scale ) const;
+
+			/// <summary>Write the value with exactly scale( ) fraction digits to out, which must have room for max_chars</summary>
+			/// <returns>The number of characters written</returns>
+			size_t format( char * out ) const noexcept;
+			std::string to_string( ) const;
+			double to_double( ) const noexcept;
+
+			/// <summary>Exact for any two scales</summary>
+			static int compare( decimal_t const & lhs, decimal_t const & rhs ) noexcept;
+			/// <summary>Equal values hash the same whatever their scale</summary>
+			std::size_t hash( ) const noexcept;
+		};
+
+		/// <summary>Exact, at the larger scale.  Throws on overflow</summary>
+		decimal_t operator+( decimal_t const & lhs, decimal_t const & rhs );
+		decimal_t operator-( decimal_t const & lhs, decimal_t const & rhs );
+		decimal_t operator-( decimal_t const & value );
+
+		bool operator==( decimal_t const & lhs, decimal_t const & rhs ) noexcept;
+		bool operator!=( decimal_t const & lhs, decimal_t const & rhs ) noexcept;
+		bool operator<( decimal_t const & lhs, decimal_t const & rhs ) noexcept;
+		bool operator>( decimal_t const & lhs, decimal_t const & rhs ) noexcept;
+		bool operator<=( decimal_t const & lhs, decimal_t const & rhs ) noexcept;
+		bool operator>=( decimal_t const & lhs, decimal_t const & rhs ) noexcept;
+	}	// namespace data
+}	// namespace daw
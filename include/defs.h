@@ -22,11 +22,8 @@
 
 #pragma once
 
-#define USE_PPL	0
 #define PACK_VARIANT 0
 
 #ifndef __func__
 #define __func__ __FUNCTION__
 #endif
-
-#define USE_SPARSE_VECTOR 0
@@ -0,0 +1,138 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <boost/utility/string_view.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <daw/daw_expected.h>
+#include <daw/daw_memory_mapped_file.h>
+
+#include "data_table.h"
+
+namespace daw {
+	namespace data {
+		/// <summary>Byte offset and length of every cell in a column, each stored as two varints with the offset a delta
+		/// from the previous cell's.  About 3 bytes a cell for short cells instead of a DataCell</summary>
+		class field_offsets_t final {
+			std::vector<uint8_t> m_bytes;
+			uint64_t m_last_offset;
+			size_t m_size;
+
+			void append_varint( uint64_t value );
+		public:
+			field_offsets_t( );
+
+			/// <summary>Record a cell of length bytes at offset.  Offsets must not decrease.  Length 0 is an empty cell</summary>
+			void append( uint64_t offset, uint64_t length );
+			void append_empty( );
+			/// <summary>Number of cells</summary>
+			size_t size( ) const noexcept;
+			/// <summary>Bytes used by the encoding</summary>
+			size_t encoded_size( ) const noexcept;
+			void shrink_to_fit( );
+
+			/// <summary>Call func( offset, length ) for each cell in order</summary>
+			template<typename Function>
+			void for_each( Function func ) const {
+				uint64_t offset = 0;
+				auto pos = m_bytes.data( );
+				for( size_t n = 0; n < m_size; ++n ) {
+					offset += read_varint( pos );
+					auto const length = read_varint( pos );
+					func( offset, length );
+				}
+			}
+
+			static uint64_t read_varint( uint8_t const * & pos ) noexcept {
+				uint64_t result = 0;
+				int shift = 0;
+				while( 0 != (*pos & 0x80) ) {
+					result |= static_cast<uint64_t>(*pos++ & 0x7F) << shift;
+					shift += 7;
+				}
+				return result | (static_cast<uint64_t>(*pos++) << shift);
+			}
+		};
+
+		/// <summary>A parsed CSV File whose columns are only type detected and converted when first accessed.  Until then a
+		/// column is its field_offsets_t into the mapped file, which is kept open for as long as the table is</summary>
+		class lazy_table_t final {
+		public:
+			using buffer_t = daw::filesystem::memory_mapped_file_t<char>;
+		private:
+			struct column_t {
+				DataTable::value_type values;	// Empty, with the header, width and sketches, until materialized
+				field_offsets_t offsets;
+				std::unique_ptr<std::mutex> mutex;
+				bool materialized;
+			};
+			std::shared_ptr<buffer_t> m_buffer;
+			std::vector<column_t> m_columns;
+			DataTable::size_type m_row_count;
+
+			DataTable::value_type & materialized( DataTable::size_type column );
+		public:
+			/// <param name="columns">Empty columns set up as the materialized ones should be</param>
+			/// <param name="offsets">One per column, all the same size</param>
+			lazy_table_t( std::shared_ptr<buffer_t> buffer, std::vector<DataTable::value_type> columns, std::vector<field_offsets_t> offsets );
+			lazy_table_t( lazy_table_t && ) = default;
+			lazy_table_t & operator=( lazy_table_t && ) = default;
+			lazy_table_t( lazy_table_t const & ) = delete;
+			lazy_table_t & operator=( lazy_table_t const & ) = delete;
+			~lazy_table_t( ) = default;
+
+			/// <summary>Number of columns</summary>
+			DataTable::size_type size( ) const noexcept;
+			bool empty( ) const noexcept;
+			DataTable::size_type row_count( ) const noexcept;
+			std::string const & header( DataTable::size_type column ) const;
+			DataTable::size_type get_column_index( boost::string_view column_name ) const;
+			bool is_materialized( DataTable::size_type column ) const;
+			/// <summary>Bytes used by the offsets of the columns not yet materialized</summary>
+			size_t offsets_size( ) const;
+
+			/// <summary>The column, type detected and converted on first access.  Safe to call from several threads</summary>
+			DataTable::value_type const & operator[]( DataTable::size_type column );
+			DataTable::value_type const & operator[]( boost::string_view column_name );
+
+			/// <summary>Materialize the columns in parallel, one column per task</summary>
+			void materialize( std::vector<DataTable::size_type> const & columns );
+			void materialize( std::vector<std::string> const & column_names );
+			void materialize_all( );
+
+			/// <summary>Materialize every column and move them into a <c>DataTable</c>, leaving this table empty</summary>
+			DataTable release( );
+		};
+
+		/// <summary>Tokenize a CSV File as parse_csv_data does but only record where each cell is.  Statistics are those of
+		/// the tokenizer, none of the cell counts or type timings are known until the columns are materialized</summary>
+		expected_t<lazy_table_t> parse_csv_lazy( parse_csv_data_param const & param );
+		expected_t<lazy_table_t> parse_csv_lazy( parse_csv_data_param const & param, parse_stats & stats );
+	}	// namespace data
+}	// namespace daw
@@ -0,0 +1,132 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace daw {
+	namespace data {
+		/// <summary>A monotonic arena.  Memory is handed out from chunks that are only freed all at once, by release( ) or
+		/// the destructor, so a whole parse is freed in a few deallocations instead of one per cell.  allocate is not
+		/// thread safe, give each thread its own with make_child( )</summary>
+		class memory_arena_t final {
+			struct chunk_t {
+				std::unique_ptr<char[]> data;
+				size_t size;
+			};
+			std::vector<chunk_t> m_chunks;
+			char * m_pos;
+			char * m_end;
+			size_t m_next_chunk_size;
+			size_t m_allocated;
+			std::vector<std::unique_ptr<memory_arena_t>> m_children;
+			std::mutex m_children_mutex;
+
+			void add_chunk( size_t min_size );
+		public:
+			static constexpr size_t const default_chunk_size = 65536;
+
+			explicit memory_arena_t( size_t initial_chunk_size = default_chunk_size );
+			~memory_arena_t( ) = default;
+			memory_arena_t( memory_arena_t const & ) = delete;
+			memory_arena_t & operator=( memory_arena_t const & ) = delete;
+			memory_arena_t( memory_arena_t && ) = delete;
+			memory_arena_t & operator=( memory_arena_t && ) = delete;
+
+			/// <summary>bytes aligned to alignment, which must be a power of two.  Valid until release( )</summary>
+			void * allocate( size_t bytes, size_t alignment = alignof( std::max_align_t ) );
+			/// <summary>A zero terminated copy of length chars at str</summary>
+			char * copy_string( char const * str, size_t length );
+
+			/// <summary>A new arena freed along with this one, for another thread to allocate from.  Safe to call from
+			/// several threads at once</summary>
+			memory_arena_t & make_child( );
+
+			/// <summary>Free every chunk and child arena.  Everything allocated from them is invalid after</summary>
+			void release( ) noexcept;
+
+			/// <summary>Bytes handed out by allocate, not counting children</summary>
+			size_t allocated( ) const noexcept;
+			/// <summary>Bytes of the chunks, not counting children</summary>
+			size_t reserved( ) const noexcept;
+		};
+
+		/// <summary>An allocator drawing from a memory_arena_t, or from the heap when it has none.  deallocate does nothing
+		/// with an arena, so a container growing in one leaves its old storage there until the arena is released.  Copies of
+		/// containers use the heap, they must not outlive an arena they know nothing about</summary>
+		template<typename T>
+		class arena_allocator_t {
+			memory_arena_t * m_arena;
+
+			template<typename U>
+			friend class arena_allocator_t;
+		public:
+			using value_type = T;
+			using propagate_on_container_copy_assignment = std::false_type;
+			using propagate_on_container_move_assignment = std::true_type;
+			using propagate_on_container_swap = std::true_type;
+
+			arena_allocator_t( ) noexcept: m_arena{ nullptr } { }
+			arena_allocator_t( memory_arena_t * arena ) noexcept: m_arena{ arena } { }
+
+			template<typename U>
+			arena_allocator_t( arena_allocator_t<U> const & other ) noexcept: m_arena{ other.m_arena } { }
+
+			T * allocate( size_t count ) {
+				if( nullptr == m_arena ) {
+					return static_cast<T *>(::operator new( count * sizeof( T ) ));
+				}
+				return static_cast<T *>(m_arena->allocate( count * sizeof( T ), alignof( T ) ));
+			}
+
+			void deallocate( T * ptr, size_t ) noexcept {
+				if( nullptr == m_arena ) {
+					::operator delete( ptr );
+				}
+			}
+
+			arena_allocator_t select_on_container_copy_construction( ) const noexcept {
+				return arena_allocator_t{ };
+			}
+
+			memory_arena_t * arena( ) const noexcept {
+				return m_arena;
+			}
+		};
+
+		template<typename T, typename U>
+		bool operator==( arena_allocator_t<T> const & lhs, arena_allocator_t<U> const & rhs ) noexcept {
+			return lhs.arena( ) == rhs.arena( );
+		}
+
+		template<typename T, typename U>
+		bool operator!=( arena_allocator_t<T> const & lhs, arena_allocator_t<U> const & rhs ) noexcept {
+			return lhs.arena( ) != rhs.arena( );
+		}
+	}	// namespace data
+}	// namespace daw
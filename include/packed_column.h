@@ -0,0 +1,125 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <boost/variant.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <daw/daw_exception.h>
+
+#include "data_table.h"
+#include "data_types.h"
+
+namespace daw {
+	namespace data {
+		/// <summary>storage_width_of<T>::value is the width stored as T</summary>
+		template<typename T>
+		struct storage_width_of;
+
+		template<> struct storage_width_of<int8_t>: std::integral_constant<storage_width_t, storage_width_t::int8> { };
+		template<> struct storage_width_of<int16_t>: std::integral_constant<storage_width_t, storage_width_t::int16> { };
+		template<> struct storage_width_of<int32_t>: std::integral_constant<storage_width_t, storage_width_t::int32> { };
+		template<> struct storage_width_of<int64_t>: std::integral_constant<storage_width_t, storage_width_t::int64> { };
+		template<> struct storage_width_of<float>: std::integral_constant<storage_width_t, storage_width_t::float32> { };
+		template<> struct storage_width_of<double>: std::integral_constant<storage_width_t, storage_width_t::float64> { };
+
+		/// <summary>A numeric column stored at its storage width, with a byte per row null mask only when a row is null.
+		/// Values read back widened to integer_t or real_t.  Parsing always produces integer_t and real_t cells, so a
+		/// column is packed from a parsed one, see pack_numeric_columns, and the cells are needed until then</summary>
+		class packed_column_t final {
+			using values_t = boost::variant<std::vector<int8_t>, std::vector<int16_t>, std::vector<int32_t>, std::vector<int64_t>, std::vector<float>, std::vector<double>>;
+
+			std::string m_header;
+			storage_width_t m_width;
+			size_t m_size;
+			values_t m_values;	// Holds the vector of the type width is stored as
+			std::vector<uint8_t> m_valid;	// 1 when the row has a value.  Empty when no row is null
+
+			template<typename T>
+			void pack( DataTable::value_type const & column );
+		public:
+			packed_column_t( );
+
+			/// <summary>Pack the cells of column at column.width( ).  Throws when that is none, when a cell is not numeric,
+			/// or when a value does not fit a forced integer width.  A forced float32 width rounds</summary>
+			explicit packed_column_t( DataTable::value_type const & column );
+
+			std::string const & header( ) const noexcept;
+			storage_width_t width( ) const noexcept;
+			size_t size( ) const noexcept;
+			bool empty( ) const noexcept;
+			/// <summary>Bytes of values and null mask</summary>
+			size_t memory_size( ) const noexcept;
+
+			bool is_null( size_t row ) const noexcept;
+			/// <summary>The null mask as the aggregate kernels take it, nullptr when no row is null</summary>
+			uint8_t const * valid( ) const noexcept;
+
+			/// <summary>The value at row.  Throws for float widths</summary>
+			integer_t integer( size_t row ) const;
+			/// <summary>The value at row as real_t, whatever the width</summary>
+			real_t real( size_t row ) const;
+			/// <summary>An integer cell for integer widths, a real cell for float widths and an empty cell for null rows</summary>
+			DataCell cell( size_t row ) const;
+
+			/// <summary>The values when stored as T</summary>
+			template<typename T>
+			T const * data( ) const {
+				daw::exception::daw_throw_on_false( storage_width_of<T>::value == m_width, "{0}: Values are not stored as that type", __func__ );
+				return boost::get<std::vector<T>>( m_values ).data( );
+			}
+
+			/// <summary>func( values ) with values an int8_t through int64_t, float or double pointer to suit width( ).  Every
+			/// instantiation of func must return the same type</summary>
+			template<typename Function>
+			decltype(auto) visit( Function func ) const {
+				switch( m_width ) {
+				case storage_width_t::int8:
+					return func( data<int8_t>( ) );
+				case storage_width_t::int16:
+					return func( data<int16_t>( ) );
+				case storage_width_t::int32:
+					return func( data<int32_t>( ) );
+				case storage_width_t::int64:
+					return func( data<int64_t>( ) );
+				case storage_width_t::float32:
+					return func( data<float>( ) );
+				case storage_width_t::float64:
+				case storage_width_t::none:
+					break;
+				}
+				return func( data<double>( ) );
+			}
+
+			/// <summary>Back to a column of cells</summary>
+			DataTable::value_type unpack( ) const;
+		};
+
+		/// <summary>Pack the columns of table whose width is not none.  The table is left as it is</summary>
+		std::vector<packed_column_t> pack_numeric_columns( DataTable const & table );
+	}	// namespace data
+}	// namespace daw
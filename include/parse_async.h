@@ -0,0 +1,51 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <functional>
+#include <future>
+
+#include <daw/daw_expected.h>
+
+#include "data_table.h"
+
+namespace daw {
+	namespace data {
+		/// <summary>Runs a task at some later time on some thread.  It must run it exactly once</summary>
+		using parse_executor_t = std::function<void( std::function<void( )> )>;
+		using parse_complete_cb_t = std::function<void( expected_t<DataTable> const & )>;
+
+		/// <summary>Executor that runs tasks on a library owned task_scheduler kept apart from get_task_scheduler( ), so a long
+		/// parse neither holds a worker of the parallel algorithms nor runs inside an unrelated task_group::wait.  Parses still
+		/// running at exit are finished and their threads joined</summary>
+		parse_executor_t default_parse_executor( );
+
+		/// <summary>Start parse_csv_data( param ) on executor and return without waiting for it</summary>
+		/// <param name="param">File options.  The progress callback, cancel token and deadline apply as in parse_csv_data and the callback runs on the executor's thread</param>
+		/// <param name="executor">Where to run the parse.  nullptr uses default_parse_executor( )</param>
+		/// <param name="on_complete">Optional.  Called on the executor's thread with the result before the future becomes ready.  If it throws, the future holds that exception</param>
+		/// <returns>A future of the result.  Parse errors are in the expected_t.  The future only holds an exception when on_complete
+		/// or executor throws</returns>
+		std::future<expected_t<DataTable>> parse_csv_data_async( parse_csv_data_param param, parse_executor_t executor = nullptr, parse_complete_cb_t on_complete = nullptr );
+	}	// namespace data
+}	// namespace daw
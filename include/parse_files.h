@@ -0,0 +1,51 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <daw/daw_expected.h>
+
+#include "data_table.h"
+
+namespace daw {
+	namespace data {
+		/// <summary>Regular files in directory whose names match pattern, sorted by name</summary>
+		/// <param name="pattern">File name pattern where * matches any run of characters and ? matches one character</param>
+		std::vector<std::string> find_files( std::string const & directory, std::string const & pattern );
+
+		/// <summary>Append the rows of every table to the first, in order, by moving the cells</summary>
+		/// <returns>A <c>DataTable</c> with the columns of tables[0] presized to the total row count.  Throws if the column headers differ</returns>
+		DataTable concat_tables( std::vector<DataTable> tables );
+
+		/// <summary>Parse several CSV Files with the same header at once and append them in file order</summary>
+		/// <param name="file_names">Files to load.  The result follows this order whichever finishes first</param>
+		/// <param name="options">Applied to every file.  The file name is ignored.  The progress callback is called for each file, possibly from several threads at once</param>
+		/// <returns>A <c>DataTable</c> of all the rows or the error of the first file, in file order, that failed.  Mismatched headers are an error</returns>
+		expected_t<DataTable> parse_csv_files( std::vector<std::string> const & file_names, parse_csv_data_param const & options );
+
+		/// <summary>parse_csv_files( find_files( directory, pattern ), options )</summary>
+		expected_t<DataTable> parse_csv_files( std::string const & directory, std::string const & pattern, parse_csv_data_param const & options );
+	}	// namespace data
+}	// namespace daw
@@ -0,0 +1,89 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace daw {
+	namespace data {
+		using parse_clock_t = std::chrono::steady_clock;
+
+		enum class parse_phase: int8_t { tokenizing = 0, post_processing = 1, complete = 2 };
+
+		/// <summary>Snapshot of a running parse passed to the progress callback</summary>
+		struct parse_progress {
+			parse_phase phase = parse_phase::tokenizing;
+			uint64_t bytes_processed = 0;
+			uint64_t bytes_total = 0;
+			uint64_t rows = 0;
+			double elapsed_seconds = 0.0;
+			/// <summary>0 until enough time has passed to measure a rate</summary>
+			double bytes_per_second = 0.0;
+			double seconds_remaining = 0.0;
+		};
+
+		/// <summary>Human readable progress line, e.g. "Loading CSV Data... 5.00MB of 1.00GB (250.00MB/s) 00:00:04 left"</summary>
+		std::string to_string( parse_progress const & progress );
+
+		/// <summary>Counters and per phase timings of one call to parse_csv_data</summary>
+		struct parse_stats {
+			uint64_t bytes = 0;
+			/// <summary>Data rows, not counting the header or the rows before it</summary>
+			uint64_t rows = 0;
+			uint64_t columns = 0;
+
+			uint64_t empty_cells = 0;
+			uint64_t integer_cells = 0;
+			uint64_t real_cells = 0;
+			uint64_t timestamp_cells = 0;
+			uint64_t string_cells = 0;
+			uint64_t decimal_cells = 0;
+
+			/// <summary>Data rows whose cell count differs from the header's.  The columns they leave short are padded with empty cells</summary>
+			uint64_t ragged_rows = 0;
+			/// <summary>An estimate of the heap allocations made by the parser, counting one per non-empty string cell and one per
+			/// change of a column's capacity.  It is not measured, so allocations inside value conversion or the allocator are not
+			/// seen.  The benchmarks count the real number with a replaced operator new</summary>
+			uint64_t estimated_allocations = 0;
+			/// <summary>Columns stored sparse by parse_csv_sparse, see parse_csv_data_param::set_sparse_threshold</summary>
+			uint64_t sparse_columns = 0;
+
+			/// <summary>Scanning for delimiters and quotes.  The loop time not spent in type detection or conversion</summary>
+			double tokenize_seconds = 0.0;
+			double type_detect_seconds = 0.0;
+			/// <summary>Copying the cell text, converting it to its value and appending it to the column</summary>
+			double convert_seconds = 0.0;
+			/// <summary>Removing hidden columns, padding short columns and making columns sparse</summary>
+			double post_process_seconds = 0.0;
+			double total_seconds = 0.0;
+
+			uint64_t cells( ) const noexcept;
+		};
+
+		inline double to_seconds( parse_clock_t::duration duration ) noexcept {
+			return std::chrono::duration<double>( duration ).count( );
+		}
+	}	// namespace data
+}	// namespace daw
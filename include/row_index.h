@@ -0,0 +1,88 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <daw/daw_expected.h>
+
+#include "data_table.h"
+
+namespace daw {
+	namespace data {
+		/// <summary>Byte offsets of every stride'th data row of a CSV File so a few rows can be parsed without reading the rest</summary>
+		class row_index_t final {
+			uint64_t m_file_size;
+			int64_t m_file_time;
+			uint64_t m_head_hash;
+			uint64_t m_stride;
+			uint64_t m_row_count;
+			uint64_t m_header_first;
+			uint64_t m_header_last;
+			std::vector<uint64_t> m_offsets;	// m_offsets[n] is the start of data row n * m_stride
+		public:
+			row_index_t( );
+			row_index_t( uint64_t file_size, int64_t file_time, uint64_t head_hash, uint64_t stride, uint64_t row_count, uint64_t header_first, uint64_t header_last, std::vector<uint64_t> offsets );
+
+			/// <summary>Size of the indexed file.  A file of another size is not the one indexed</summary>
+			uint64_t file_size( ) const noexcept;
+			/// <summary>Last write time of the indexed file as a time_t</summary>
+			int64_t file_time( ) const noexcept;
+			/// <summary>head_hash( ) of the indexed file.  Catches a rewrite that kept the size and time</summary>
+			uint64_t head_hash( ) const noexcept;
+			/// <summary>Rows between stored offsets.  1 is an exact index</summary>
+			uint64_t stride( ) const noexcept;
+			/// <summary>Newline terminated data rows after the header</summary>
+			uint64_t row_count( ) const noexcept;
+			uint64_t header_first( ) const noexcept;
+			uint64_t header_last( ) const noexcept;
+			std::vector<uint64_t> const & offsets( ) const noexcept;
+
+			/// <summary>Write the index in a native endian binary format</summary>
+			void save( std::string const & index_file_name ) const;
+			static row_index_t load( std::string const & index_file_name );
+
+			/// <summary>FNV-1a of the first 64KB of data, which covers the header and first rows</summary>
+			static uint64_t head_hash( char const * data, size_t size ) noexcept;
+			/// <summary>Whether a file with these attributes is still the one indexed</summary>
+			bool matches( uint64_t file_size, int64_t file_time, uint64_t head_hash ) const noexcept;
+		};
+
+		/// <summary>Where the index of file_name is kept by convention, next to it</summary>
+		std::string row_index_file_name( std::string const & file_name );
+
+		/// <summary>Index a CSV File with a quote aware scan that does not tokenize cells</summary>
+		/// <param name="header_row">Numeric row in file that contains the header, as for parse_csv_data</param>
+		/// <param name="stride">Keep the offset of every stride'th row.  1 for an exact index, larger for a smaller one</param>
+		row_index_t build_row_index( std::string const & file_name, size_t header_row, size_t stride = 1024 );
+
+		/// <summary>Parse the header and data rows [first, first + count) of a CSV File, scanning at most stride - 1 rows to reach first</summary>
+		/// <param name="options">Everything but the file name, header row and sampling applies</param>
+		/// <returns>A <c>DataTable</c> of the rows, fewer if the file ends first.  An error if the file's size, last write time or first block differs from the index</returns>
+		expected_t<DataTable> read_rows( std::string const & file_name, row_index_t const & index, size_t first, size_t count, parse_csv_data_param const & options );
+		expected_t<DataTable> read_rows( std::string const & file_name, row_index_t const & index, size_t first, size_t count );
+	}	// namespace data
+}	// namespace daw
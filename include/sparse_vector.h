@@ -0,0 +1,587 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace daw {
+	namespace data {
+		/// <summary>Default emptiness test of sparse_vector_t, value.empty( )</summary>
+		struct is_empty_value_t {
+			template<typename T>
+			bool operator( )( T const & value ) const noexcept( noexcept( value.empty( ) ) ) {
+				return value.empty( );
+			}
+		};
+
+		/// <summary>A vector that can store only its elements that are not empty.  Dense it is a std::vector.  After
+		/// make_sparse( ) it holds the positions and values of those elements in two sorted arrays, so reading an element
+		/// is a binary search, reading in order with an iterator is O(1) a step and appending keeps it sparse.  Non-const
+		/// access gives an element_reference, which reads without changing the storage and writes the one element.  Only
+		/// inserting before end( ) makes it dense again</summary>
+		template<typename T, typename Allocator = std::allocator<T>, typename IsEmpty = is_empty_value_t>
+		class sparse_vector_t {
+		public:
+			using value_type = T;
+			using allocator_type = Allocator;
+			using size_type = size_t;
+			using difference_type = std::ptrdiff_t;
+			using const_reference = value_type const &;
+			class element_reference;
+			using reference = element_reference;
+		private:
+			using values_t = std::vector<T, Allocator>;
+			using indexes_t = std::vector<size_type, typename std::allocator_traits<Allocator>::template rebind_alloc<size_type>>;
+
+			values_t m_values;	// All of them when dense, else those that are not empty
+			indexes_t m_indexes;	// Position of each of m_values when sparse
+			size_type m_size;
+			bool m_sparse;
+
+			static const_reference empty_value( ) {
+				static value_type const result{ };
+				return result;
+			}
+
+			/// <summary>The first slot of m_indexes at or after pos</summary>
+			size_type slot_of( size_type pos ) const noexcept {
+				return static_cast<size_type>(std::lower_bound( m_indexes.begin( ), m_indexes.end( ), pos ) - m_indexes.begin( ));
+			}
+
+			/// <summary>slot_of( pos ), checking hint first.  A hint cached before an element was written may be stale</summary>
+			size_type slot_of( size_type pos, size_type hint ) const noexcept {
+				if( hint <= m_indexes.size( ) && (hint == m_indexes.size( ) || pos <= m_indexes[hint]) && (0 == hint || m_indexes[hint - 1] < pos) ) {
+					return hint;
+				}
+				return slot_of( pos );
+			}
+
+			/// <summary>Store value at pos, adding or removing its slot when sparse</summary>
+			void assign( size_type pos, size_type hint, value_type value ) {
+				if( !m_sparse ) {
+					m_values[pos] = std::move( value );
+					return;
+				}
+				auto const slot = slot_of( pos, hint );
+				auto const where = static_cast<difference_type>(slot);
+				auto const stored = slot < m_indexes.size( ) && m_indexes[slot] == pos;
+				if( IsEmpty{ }( value ) ) {
+					if( stored ) {
+						m_values.erase( m_values.begin( ) + where );
+						m_indexes.erase( m_indexes.begin( ) + where );
+					}
+				} else if( stored ) {
+					m_values[slot] = std::move( value );
+				} else {
+					m_indexes.insert( m_indexes.begin( ) + where, pos );
+					try {
+						m_values.insert( m_values.begin( ) + where, std::move( value ) );
+					} catch( ... ) {
+						m_indexes.erase( m_indexes.begin( ) + where );
+						throw;
+					}
+				}
+			}
+
+			template<typename Vector, typename Reference>
+			class iterator_t {
+				Vector * m_vector;
+				size_type m_pos;
+				size_type m_slot;	// slot_of( m_pos ) when sparse, so stepping does not search
+
+				template<typename, typename>
+				friend class iterator_t;
+			public:
+				using iterator_category = std::random_access_iterator_tag;
+				using value_type = T;
+				using difference_type = std::ptrdiff_t;
+				using pointer = value_type const *;
+				using reference = Reference;
+
+				iterator_t( ) noexcept: m_vector{ nullptr }, m_pos{ 0 }, m_slot{ 0 } { }
+				iterator_t( Vector * vector, size_type pos ):
+						m_vector{ vector },
+						m_pos{ pos },
+						m_slot{ vector->m_sparse ? vector->slot_of( pos ) : 0 } { }
+
+				/// <summary>iterator to const_iterator</summary>
+				template<typename OtherVector, typename OtherReference, typename = typename std::enable_if<std::is_convertible<OtherVector *, Vector *>::value>::type>
+				iterator_t( iterator_t<OtherVector, OtherReference> const & other ) noexcept:
+						m_vector{ other.m_vector },
+						m_pos{ other.m_pos },
+						m_slot{ other.m_slot } { }
+
+				size_type position( ) const noexcept {
+					return m_pos;
+				}
+
+				reference operator*( ) const {
+					return m_vector->at_slot( m_pos, m_slot );
+				}
+
+				pointer operator->( ) const {
+					const_reference value = **this;
+					return &value;
+				}
+
+				reference operator[]( difference_type n ) const {
+					return *(*this + n);
+				}
+
+				iterator_t & operator++( ) noexcept {
+					if( m_vector->m_sparse && m_slot < m_vector->m_indexes.size( ) && m_vector->m_indexes[m_slot] == m_pos ) {
+						++m_slot;
+					}
+					++m_pos;
+					return *this;
+				}
+
+				iterator_t operator++( int ) noexcept {
+					auto result = *this;
+					++(*this);
+					return result;
+				}
+
+				iterator_t & operator--( ) noexcept {
+					--m_pos;
+					if( m_vector->m_sparse && 0 < m_slot && m_slot <= m_vector->m_indexes.size( ) && m_vector->m_indexes[m_slot - 1] == m_pos ) {
+						--m_slot;
+					}
+					return *this;
+				}
+
+				iterator_t operator--( int ) noexcept {
+					auto result = *this;
+					--(*this);
+					return result;
+				}
+
+				iterator_t & operator+=( difference_type n ) {
+					m_pos = static_cast<size_type>(static_cast<difference_type>(m_pos) + n);
+					m_slot = m_vector->m_sparse ? m_vector->slot_of( m_pos ) : 0;
+					return *this;
+				}
+
+				iterator_t & operator-=( difference_type n ) {
+					return *this += -n;
+				}
+
+				friend iterator_t operator+( iterator_t it, difference_type n ) {
+					return it += n;
+				}
+
+				friend iterator_t operator+( difference_type n, iterator_t it ) {
+					return it += n;
+				}
+
+				friend iterator_t operator-( iterator_t it, difference_type n ) {
+					return it -= n;
+				}
+
+				friend difference_type operator-( iterator_t const & lhs, iterator_t const & rhs ) noexcept {
+					return static_cast<difference_type>(lhs.m_pos) - static_cast<difference_type>(rhs.m_pos);
+				}
+
+				friend bool operator==( iterator_t const & lhs, iterator_t const & rhs ) noexcept {
+					return lhs.m_pos == rhs.m_pos;
+				}
+
+				friend bool operator!=( iterator_t const & lhs, iterator_t const & rhs ) noexcept {
+					return lhs.m_pos != rhs.m_pos;
+				}
+
+				friend bool operator<( iterator_t const & lhs, iterator_t const & rhs ) noexcept {
+					return lhs.m_pos < rhs.m_pos;
+				}
+
+				friend bool operator>( iterator_t const & lhs, iterator_t const & rhs ) noexcept {
+					return lhs.m_pos > rhs.m_pos;
+				}
+
+				friend bool operator<=( iterator_t const & lhs, iterator_t const & rhs ) noexcept {
+					return lhs.m_pos <= rhs.m_pos;
+				}
+
+				friend bool operator>=( iterator_t const & lhs, iterator_t const & rhs ) noexcept {
+					return lhs.m_pos >= rhs.m_pos;
+				}
+			};
+
+			const_reference at_slot( size_type pos, size_type slot ) const {
+				if( !m_sparse ) {
+					return m_values[pos];
+				}
+				slot = slot_of( pos, slot );
+				if( slot < m_indexes.size( ) && m_indexes[slot] == pos ) {
+					return m_values[slot];
+				}
+				return empty_value( );
+			}
+
+			reference at_slot( size_type pos, size_type slot ) noexcept {
+				return reference{ this, pos, slot };
+			}
+		public:
+			/// <summary>What non-const access to an element gives.  It converts to const_reference and assigning to it
+			/// stores the one element, so neither makes a sparse vector dense</summary>
+			class element_reference {
+				sparse_vector_t * m_vector;
+				size_type m_pos;
+				size_type m_slot;	// Where the element is or would be stored, a hint
+			public:
+				element_reference( sparse_vector_t * vector, size_type pos, size_type slot ) noexcept:
+						m_vector{ vector },
+						m_pos{ pos },
+						m_slot{ slot } { }
+
+				element_reference( element_reference const & ) = default;
+				~element_reference( ) = default;
+
+				const_reference get( ) const {
+					return static_cast<sparse_vector_t const *>(m_vector)->at_slot( m_pos, m_slot );
+				}
+
+				operator const_reference( ) const {
+					return get( );
+				}
+
+				element_reference & operator=( value_type value ) {
+					m_vector->assign( m_pos, m_slot, std::move( value ) );
+					return *this;
+				}
+
+				/// <summary>Assigns the element referred to, not the reference</summary>
+				element_reference & operator=( element_reference const & rhs ) {
+					return *this = value_type{ rhs.get( ) };
+				}
+
+				friend void swap( element_reference lhs, element_reference rhs ) {
+					value_type tmp{ lhs.get( ) };
+					lhs = rhs.get( );
+					rhs = std::move( tmp );
+				}
+			};
+
+			using iterator = iterator_t<sparse_vector_t, reference>;
+			using const_iterator = iterator_t<sparse_vector_t const, const_reference>;
+			using reverse_iterator = std::reverse_iterator<iterator>;
+			using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+			sparse_vector_t( ) noexcept( noexcept( Allocator( ) ) ): sparse_vector_t( Allocator( ) ) { }
+
+			explicit sparse_vector_t( Allocator const & alloc ) noexcept:
+					m_values( alloc ),
+					m_indexes( alloc ),
+					m_size{ 0 },
+					m_sparse{ false } { }
+
+			sparse_vector_t( sparse_vector_t const & other ):
+					m_values( other.m_values ),
+					m_indexes( other.m_indexes ),
+					m_size{ other.m_size },
+					m_sparse{ other.m_sparse } { }
+
+			sparse_vector_t( sparse_vector_t && other ) noexcept:
+					m_values( std::move( other.m_values ) ),
+					m_indexes( std::move( other.m_indexes ) ),
+					m_size{ std::exchange( other.m_size, 0 ) },
+					m_sparse{ std::exchange( other.m_sparse, false ) } { }
+
+			sparse_vector_t & operator=( sparse_vector_t const & rhs ) {
+				if( this != &rhs ) {
+					m_values = rhs.m_values;
+					m_indexes = rhs.m_indexes;
+					m_size = rhs.m_size;
+					m_sparse = rhs.m_sparse;
+				}
+				return *this;
+			}
+
+			sparse_vector_t & operator=( sparse_vector_t && rhs ) noexcept {
+				if( this != &rhs ) {
+					m_values = std::move( rhs.m_values );
+					m_indexes = std::move( rhs.m_indexes );
+					m_size = std::exchange( rhs.m_size, 0 );
+					m_sparse = std::exchange( rhs.m_sparse, false );
+				}
+				return *this;
+			}
+
+			~sparse_vector_t( ) = default;
+
+			friend void swap( sparse_vector_t & lhs, sparse_vector_t & rhs ) noexcept {
+				using std::swap;
+				swap( lhs.m_values, rhs.m_values );
+				swap( lhs.m_indexes, rhs.m_indexes );
+				swap( lhs.m_size, rhs.m_size );
+				swap( lhs.m_sparse, rhs.m_sparse );
+			}
+
+			bool is_sparse( ) const noexcept {
+				return m_sparse;
+			}
+
+			/// <summary>Keep only the elements that are not empty</summary>
+			void make_sparse( ) {
+				if( m_sparse ) {
+					return;
+				}
+				indexes_t indexes( m_values.get_allocator( ) );
+				size_type count = 0;
+				for( size_type pos = 0; pos < m_values.size( ); ++pos ) {
+					if( !IsEmpty{ }( m_values[pos] ) ) {
+						indexes.push_back( pos );
+						if( count != pos ) {
+							m_values[count] = std::move( m_values[pos] );
+						}
+						++count;
+					}
+				}
+				m_values.erase( m_values.begin( ) + static_cast<difference_type>(count), m_values.end( ) );
+				m_values.shrink_to_fit( );
+				indexes.shrink_to_fit( );
+				m_indexes = std::move( indexes );
+				m_sparse = true;
+			}
+
+			void make_dense( ) {
+				if( !m_sparse ) {
+					return;
+				}
+				values_t values( m_values.get_allocator( ) );
+				values.resize( m_size );
+				for( size_type slot = 0; slot < m_indexes.size( ); ++slot ) {
+					values[m_indexes[slot]] = std::move( m_values[slot] );
+				}
+				m_values = std::move( values );
+				indexes_t{ m_indexes.get_allocator( ) }.swap( m_indexes );
+				m_sparse = false;
+			}
+
+			/// <summary>Number of elements that are not empty.  Counts them when dense</summary>
+			size_type stored_count( ) const {
+				if( m_sparse ) {
+					return m_values.size( );
+				}
+				return static_cast<size_type>(std::count_if( m_values.begin( ), m_values.end( ), []( T const & value ) {
+					return !IsEmpty{ }( value );
+				} ));
+			}
+
+			/// <summary>Bytes held by the arrays</summary>
+			size_type storage_size( ) const noexcept {
+				return m_values.capacity( ) * sizeof( T ) + m_indexes.capacity( ) * sizeof( size_type );
+			}
+
+			allocator_type get_allocator( ) const {
+				return m_values.get_allocator( );
+			}
+
+			size_type size( ) const noexcept {
+				return m_size;
+			}
+
+			bool empty( ) const noexcept {
+				return 0 == m_size;
+			}
+
+			size_type capacity( ) const noexcept {
+				return m_values.capacity( );
+			}
+
+			void reserve( size_type count ) {
+				if( !m_sparse ) {
+					m_values.reserve( count );
+				}
+			}
+
+			void shrink_to_fit( ) {
+				m_values.shrink_to_fit( );
+				m_indexes.shrink_to_fit( );
+			}
+
+			void clear( ) noexcept {
+				m_values.clear( );
+				m_indexes.clear( );
+				m_size = 0;
+			}
+
+			const_reference operator[]( size_type pos ) const {
+				if( !m_sparse ) {
+					return m_values[pos];
+				}
+				return at_slot( pos, slot_of( pos ) );
+			}
+
+			reference operator[]( size_type pos ) {
+				return reference{ this, pos, m_sparse ? slot_of( pos ) : 0 };
+			}
+
+			/// <summary>Store value at pos.  A sparse vector stays sparse</summary>
+			void set( size_type pos, value_type value ) {
+				assign( pos, m_sparse ? slot_of( pos ) : 0, std::move( value ) );
+			}
+
+			void push_back( value_type const & value ) {
+				if( !m_sparse ) {
+					m_values.push_back( value );
+				} else if( !IsEmpty{ }( value ) ) {
+					m_indexes.push_back( m_size );
+					m_values.push_back( value );
+				}
+				++m_size;
+			}
+
+			void push_back( value_type && value ) {
+				if( !m_sparse ) {
+					m_values.push_back( std::move( value ) );
+				} else if( !IsEmpty{ }( value ) ) {
+					m_indexes.push_back( m_size );
+					m_values.push_back( std::move( value ) );
+				}
+				++m_size;
+			}
+
+			/// <summary>Move the elements of other to the end and leave it empty.  A sparse vector stays sparse and a sparse
+			/// other is not made dense</summary>
+			void append( sparse_vector_t && other ) {
+				if( !other.m_sparse ) {
+					reserve( m_size + other.m_size );
+					for( auto & value : other.m_values ) {
+						push_back( std::move( value ) );
+					}
+				} else if( !m_sparse ) {
+					m_values.resize( m_size + other.m_size );
+					for( size_type slot = 0; slot < other.m_indexes.size( ); ++slot ) {
+						m_values[m_size + other.m_indexes[slot]] = std::move( other.m_values[slot] );
+					}
+					m_size += other.m_size;
+				} else {
+					m_values.reserve( m_values.size( ) + other.m_values.size( ) );
+					m_indexes.reserve( m_indexes.size( ) + other.m_indexes.size( ) );
+					for( size_type slot = 0; slot < other.m_indexes.size( ); ++slot ) {
+						m_values.push_back( std::move( other.m_values[slot] ) );
+						m_indexes.push_back( m_size + other.m_indexes[slot] );
+					}
+					m_size += other.m_size;
+				}
+				other.clear( );
+			}
+
+			/// <summary>Appending at end( ) keeps a sparse vector sparse, inserting anywhere else makes it dense</summary>
+			template<typename Iterator>
+			iterator insert( const_iterator where, Iterator first, Iterator last ) {
+				auto const pos = where.position( );
+				if( pos == m_size ) {
+					for( ; first != last; ++first ) {
+						push_back( *first );
+					}
+				} else {
+					make_dense( );
+					auto const old_size = m_values.size( );
+					m_values.insert( m_values.begin( ) + static_cast<difference_type>(pos), first, last );
+					m_size += m_values.size( ) - old_size;
+				}
+				return iterator{ this, pos };
+			}
+
+			/// <summary>Erasing keeps a sparse vector sparse</summary>
+			iterator erase( const_iterator first, const_iterator last ) {
+				auto const first_pos = first.position( );
+				auto const last_pos = last.position( );
+				auto const count = last_pos - first_pos;
+				if( !m_sparse ) {
+					m_values.erase( m_values.begin( ) + static_cast<difference_type>(first_pos), m_values.begin( ) + static_cast<difference_type>(last_pos) );
+				} else {
+					auto const first_slot = slot_of( first_pos );
+					auto const last_slot = slot_of( last_pos );
+					m_values.erase( m_values.begin( ) + static_cast<difference_type>(first_slot), m_values.begin( ) + static_cast<difference_type>(last_slot) );
+					m_indexes.erase( m_indexes.begin( ) + static_cast<difference_type>(first_slot), m_indexes.begin( ) + static_cast<difference_type>(last_slot) );
+					for( auto slot = first_slot; slot < m_indexes.size( ); ++slot ) {
+						m_indexes[slot] -= count;
+					}
+				}
+				m_size -= count;
+				return iterator{ this, first_pos };
+			}
+
+			iterator erase( const_iterator where ) {
+				return erase( where, where + 1 );
+			}
+
+			iterator begin( ) {
+				return iterator{ this, 0 };
+			}
+
+			iterator end( ) {
+				return iterator{ this, m_size };
+			}
+
+			const_iterator begin( ) const {
+				return const_iterator{ this, 0 };
+			}
+
+			const_iterator end( ) const {
+				return const_iterator{ this, m_size };
+			}
+
+			const_iterator cbegin( ) const {
+				return begin( );
+			}
+
+			const_iterator cend( ) const {
+				return end( );
+			}
+
+			reverse_iterator rbegin( ) {
+				return reverse_iterator{ end( ) };
+			}
+
+			reverse_iterator rend( ) {
+				return reverse_iterator{ begin( ) };
+			}
+
+			const_reverse_iterator rbegin( ) const {
+				return const_reverse_iterator{ end( ) };
+			}
+
+			const_reverse_iterator rend( ) const {
+				return const_reverse_iterator{ begin( ) };
+			}
+
+			const_reverse_iterator crbegin( ) const {
+				return rbegin( );
+			}
+
+			const_reverse_iterator crend( ) const {
+				return rend( );
+			}
+		};
+	}	// namespace data
+}	// namespace daw
@@ -0,0 +1,216 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <boost/utility/string_view.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <daw/daw_expected.h>
+#include <daw/daw_memory_mapped_file.h>
+
+#include "data_table.h"
+
+namespace daw {
+	namespace data {
+		/// <summary>Estimate of the heap a cell holds, the DataCell and the characters of a string</summary>
+		size_t cell_resident_size( DataTable::cell_type const & cell ) noexcept;
+
+		/// <summary>Where the bytes of a spilled segment are in its spill_file_t</summary>
+		struct spill_extent_t {
+			uint64_t offset;
+			uint64_t size;
+			size_t rows;
+		};
+
+		/// <summary>A temporary file of column segments in a compact binary form.  Segments are appended while parsing, then
+		/// the file is mapped read-only by finish( ) and removed when this is destroyed.  Each segment is a table of uint32_t
+		/// cell offsets followed by the cells, each a type byte and a varint, double or string payload, so any cell can be
+		/// read without reading the rest</summary>
+		class spill_file_t final {
+		public:
+			using buffer_t = daw::filesystem::memory_mapped_file_t<char>;
+		private:
+			std::string m_path;
+			std::ofstream m_out;
+			uint64_t m_size;
+			std::unique_ptr<buffer_t> m_buffer;
+			std::vector<char> m_scratch;
+
+			char const * segment_data( spill_extent_t const & extent ) const;
+		public:
+			/// <param name="directory">Where to create the file, the system temporary directory when empty</param>
+			explicit spill_file_t( std::string const & directory );
+			~spill_file_t( );
+			spill_file_t( spill_file_t const & ) = delete;
+			spill_file_t & operator=( spill_file_t const & ) = delete;
+			spill_file_t( spill_file_t && ) = delete;
+			spill_file_t & operator=( spill_file_t && ) = delete;
+
+			std::string const & path( ) const noexcept;
+			/// <summary>Bytes written</summary>
+			uint64_t size( ) const noexcept;
+
+			/// <summary>Append the cells of segment.  Only before finish( )</summary>
+			spill_extent_t write( DataTable::value_type const & segment );
+			/// <summary>Close the file for writing and map it read-only</summary>
+			void finish( );
+
+			/// <summary>Cell row of the segment at extent.  Only after finish( )</summary>
+			DataTable::cell_type cell( spill_extent_t const & extent, size_t row ) const;
+			/// <summary>Append the cells of the segment at extent to out.  Only after finish( )</summary>
+			void read( spill_extent_t const & extent, DataTable::value_type & out ) const;
+		};
+
+		class spill_column_t;
+
+		/// <summary>A parsed CSV File whose columns are held in segments of segment_rows( ) cells.  While parsing, completed
+		/// segments are written to a spill_file_t, oldest first, whenever the cells held in memory exceed the memory budget
+		/// of the parse, so a table larger than memory can be loaded.  Spilled cells are read back from the mapped file on
+		/// each access</summary>
+		class spill_table_t final {
+		public:
+			static constexpr size_t const min_segment_rows = 1024;
+			static constexpr size_t const max_segment_rows = 65536;
+
+			/// <summary>The cells of a segment when resident, else where they were spilled</summary>
+			struct segment_t {
+				DataTable::value_type cells;
+				boost::optional<spill_extent_t> extent;
+			};
+		private:
+			struct column_t {
+				DataTable::value_type prototype;	// Empty, with the header, width and decimal scale
+				std::vector<segment_t> segments;
+			};
+			std::vector<column_t> m_columns;
+			std::shared_ptr<spill_file_t> m_file;
+			size_t m_segment_rows;
+			DataTable::size_type m_row_count;
+
+			column_t const & column_at( DataTable::size_type column ) const;
+			segment_t const & segment_at( DataTable::size_type column, size_t segment ) const;
+		public:
+			/// <param name="segment_rows">Cells in every segment but the last of a column</param>
+			/// <param name="columns">Empty columns set up as the loaded ones should be</param>
+			/// <param name="segments">One list per column, each with the same number of cells and every segment but the last
+			/// of segment_rows cells</param>
+			/// <param name="file">Where the spilled segments are, finished.  May be null when nothing spilled</param>
+			spill_table_t( size_t segment_rows, std::vector<DataTable::value_type> columns, std::vector<std::vector<segment_t>> segments, std::shared_ptr<spill_file_t> file );
+			spill_table_t( spill_table_t && ) = default;
+			spill_table_t & operator=( spill_table_t && ) = default;
+			spill_table_t( spill_table_t const & ) = delete;
+			spill_table_t & operator=( spill_table_t const & ) = delete;
+			~spill_table_t( ) = default;
+
+			/// <summary>Number of columns</summary>
+			DataTable::size_type size( ) const noexcept;
+			bool empty( ) const noexcept;
+			DataTable::size_type row_count( ) const noexcept;
+			std::string const & header( DataTable::size_type column ) const;
+			DataTable::size_type get_column_index( boost::string_view column_name ) const;
+
+			/// <summary>The column, read as a DataTable column is.  It refers to this table</summary>
+			spill_column_t item( DataTable::size_type column ) const;
+			spill_column_t item( boost::string_view column ) const;
+			spill_column_t operator[]( DataTable::size_type column ) const;
+			spill_column_t operator[]( boost::string_view column ) const;
+
+			size_t segment_rows( ) const noexcept;
+			size_t segment_count( ) const noexcept;
+			bool is_spilled( DataTable::size_type column, size_t segment ) const;
+			/// <summary>Estimate of the heap held by the resident cells, see cell_resident_size</summary>
+			size_t resident_size( ) const noexcept;
+			/// <summary>Bytes of the spill file</summary>
+			uint64_t spilled_size( ) const noexcept;
+
+			/// <summary>A copy of the cell, read from the spill file when its segment was spilled</summary>
+			DataTable::cell_type cell( DataTable::size_type column, DataTable::size_type row ) const;
+			/// <summary>The cells of one segment, loaded into memory</summary>
+			DataTable::value_type segment( DataTable::size_type column, size_t segment ) const;
+			/// <summary>The whole column loaded into memory</summary>
+			DataTable::value_type column( DataTable::size_type column ) const;
+			/// <summary>Every column loaded into memory, for when the table turns out to fit</summary>
+			DataTable load( ) const;
+
+			/// <summary>Call func( cell ) for each row of column in order, with at most one spilled segment in memory at a time</summary>
+			template<typename Function>
+			void for_each( DataTable::size_type column, Function func ) const {
+				for( size_t n = 0; n < segment_count( ); ++n ) {
+					auto const & current = segment_at( column, n );
+					if( !current.extent ) {
+						for( auto const & cell : current.cells ) {
+							func( cell );
+						}
+					} else {
+						auto const cells = segment( column, n );
+						for( auto const & cell : cells ) {
+							func( cell );
+						}
+					}
+				}
+			}
+		};
+
+		/// <summary>A column of a spill_table_t with the const cell access of DataTable::value_type, but cells are returned by
+		/// value as spilled ones are read from the spill file</summary>
+		class spill_column_t final {
+			spill_table_t const * m_table;
+			DataTable::size_type m_column;
+		public:
+			spill_column_t( spill_table_t const & table, DataTable::size_type column );
+
+			std::string const & header( ) const;
+			DataTable::size_type size( ) const noexcept;
+			bool empty( ) const noexcept;
+
+			DataTable::cell_type item( DataTable::size_type row ) const;
+			DataTable::cell_type operator[]( DataTable::size_type row ) const;
+
+			/// <summary>See spill_table_t::for_each</summary>
+			template<typename Function>
+			void for_each( Function func ) const {
+				m_table->for_each( m_column, std::move( func ) );
+			}
+
+			/// <summary>The column loaded into memory</summary>
+			DataTable::value_type load( ) const;
+		};
+
+		/// <summary>Rows per segment so that the segments being filled, one per column, take about half of memory_budget and
+		/// completed segments the rest.  Kept within [min_segment_rows, max_segment_rows], max_segment_rows without a budget</summary>
+		size_t spill_segment_rows( boost::optional<size_t> const & memory_budget, size_t columns ) noexcept;
+
+		/// <summary>Tokenize and convert a CSV File as parse_csv_data does, spilling completed segments to a temporary file
+		/// in param.spill_directory( ) while the cells in memory exceed param.memory_budget( ).  Segments are sized by
+		/// spill_segment_rows so memory use stays about the budget, unless even min_segment_rows rows of every column do
+		/// not fit in it</summary>
+		expected_t<spill_table_t> parse_csv_spill( parse_csv_data_param const & param );
+		expected_t<spill_table_t> parse_csv_spill( parse_csv_data_param const & param, parse_stats & stats );
+	}	// namespace data
+}	// namespace daw
@@ -28,8 +28,12 @@
 
 namespace daw {
 	namespace string {
+		// These are safe to call from several threads at once.  The timestamp streams and facets are kept per thread
+
 		/// See http://www.boost.org/doc/libs/1_55_0/doc/html/date_time/date_time_io.html for formatting info
 		std::string ptime_to_string( const boost::posix_time::ptime& value, const std::string& format = "%Y-%m-%d %H:%M:%S %Z", const std::string locale_str = "" );
 		std::string ptime_to_string( const boost::posix_time::time_duration& value, bool show_seconds = true );
+		/// <summary>Parse value with format, see ptime_to_string.  not_a_date_time when it does not match</summary>
+		boost::posix_time::ptime string_to_ptime( const std::string& value, const std::string& format );
 	}
 }
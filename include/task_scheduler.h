@@ -0,0 +1,204 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace daw {
+	namespace data {
+		class task_group;
+
+		/// <summary>A pool of std::threads, each with its own task deque.  Workers run their own tasks newest first
+		/// and steal the oldest tasks of the others when idle</summary>
+		class task_scheduler final {
+		public:
+			using task_t = std::function<void( )>;
+		private:
+			struct queued_task_t {
+				task_t task;
+				task_group const * group;	// nullptr when the task is not part of a group
+			};
+
+			struct task_queue_t {
+				std::mutex mutex;
+				std::deque<queued_task_t> tasks;
+			};
+			std::vector<std::unique_ptr<task_queue_t>> m_queues;
+			std::vector<std::thread> m_threads;
+			std::mutex m_wake_mutex;
+			std::condition_variable m_wake;
+			std::atomic<size_t> m_pending;
+			std::atomic<size_t> m_next_queue;
+			std::atomic<bool> m_stop;
+			std::mutex m_error_mutex;
+			std::exception_ptr m_error;
+
+			void run_task( task_t & task ) noexcept;
+			bool pop_task( size_t home, task_t & task );
+			bool pop_group_task( size_t home, task_group const & group, task_t & task );
+			void add_task( task_t task, task_group const * group );
+			void worker( size_t index );
+		public:
+			/// <param name="thread_count">Number of worker threads.  0 uses std::thread::hardware_concurrency( )</param>
+			explicit task_scheduler( size_t thread_count = 0 );
+			/// <summary>Runs every task still queued, including those they add, then joins the workers.  Must not be
+			/// called from one of this scheduler's own tasks</summary>
+			~task_scheduler( );
+
+			task_scheduler( task_scheduler const & ) = delete;
+			task_scheduler( task_scheduler && ) = delete;
+			task_scheduler & operator=( task_scheduler const & ) = delete;
+			task_scheduler & operator=( task_scheduler && ) = delete;
+
+			size_t size( ) const noexcept;
+			/// <summary>Queue a task.  An exception it throws does not escape the thread running it, the first one is kept
+			/// until take_error( )</summary>
+			void add_task( task_t task );
+			/// <summary>Queue a task that task_group::wait( ) of group may run on the waiting thread</summary>
+			void add_task( task_t task, task_group const & group );
+			/// <summary>Run one queued task on the calling thread</summary>
+			/// <returns>false if there was nothing to run</returns>
+			bool run_one( );
+			/// <summary>Run one queued task of group on the calling thread</summary>
+			/// <returns>false if none of its tasks are queued</returns>
+			bool run_one( task_group const & group );
+			/// <returns>The first exception thrown by a task since the last call, or nullptr if none was</returns>
+			std::exception_ptr take_error( );
+		};	// task_scheduler
+
+		/// <summary>The scheduler used by every parallel algorithm in the library</summary>
+		std::shared_ptr<task_scheduler> get_task_scheduler( );
+
+		/// <summary>Replace the library scheduler with one of thread_count workers.  Callers already holding the old one
+		/// keep using it, and it runs every task queued on it before it is destroyed with its last reference.  When that
+		/// is this call, it blocks until those tasks are done</summary>
+		void set_task_scheduler_thread_count( size_t thread_count );
+
+		/// <summary>Tasks that are waited on together.  The waiting thread runs the group's own queued tasks instead of blocking,
+		/// so groups may nest without tying up workers.  It never runs other tasks, so nesting is only as deep as the groups
+		/// themselves and a wait is not held up by an unrelated long task</summary>
+		class task_group final {
+			task_scheduler & m_scheduler;
+			size_t m_remaining;
+			size_t m_queued;	// Tasks of m_remaining that have not started
+			std::mutex m_mutex;
+			std::condition_variable m_done;
+			std::exception_ptr m_error;
+
+			void finish_task( ) {
+				std::lock_guard<std::mutex> lock{ m_mutex };
+				if( 0 == --m_remaining ) {
+					m_done.notify_all( );
+				}
+			}
+
+			bool is_done( ) {
+				std::lock_guard<std::mutex> lock{ m_mutex };
+				return 0 == m_remaining;
+			}
+
+			/// <summary>Run the group's queued tasks and block while all of its unfinished tasks are running elsewhere.  m_done
+			/// is notified when a task is queued as well as when the last one finishes</summary>
+			void wait_for_tasks( ) {
+				while( !is_done( ) ) {
+					if( !m_scheduler.run_one( *this ) ) {
+						std::unique_lock<std::mutex> lock{ m_mutex };
+						m_done.wait( lock, [this]( ) {
+							return 0 == m_remaining || 0 < m_queued;
+						} );
+					}
+				}
+			}
+		public:
+			explicit task_group( task_scheduler & scheduler ) noexcept:
+					m_scheduler( scheduler ),
+					m_remaining{ 0 },
+					m_queued{ 0 },
+					m_mutex{ },
+					m_done{ },
+					m_error{ } { }
+
+			task_group( task_group const & ) = delete;
+			task_group & operator=( task_group const & ) = delete;
+
+			/// <summary>Waits for the tasks still queued, as they may refer to objects being destroyed with the group when
+			/// unwinding.  Their exceptions are dropped, call wait( ) to see them</summary>
+			~task_group( ) {
+				wait_for_tasks( );	// The group's tasks store their exceptions rather than throw
+			}
+
+			/// <summary>func must stay alive until wait( ) returns</summary>
+			template<typename Function>
+			void run( Function & func ) {
+				{
+					std::lock_guard<std::mutex> lock{ m_mutex };
+					++m_remaining;
+					++m_queued;
+				}
+				try {
+					m_scheduler.add_task( [this, &func]( ) {
+						{
+							std::lock_guard<std::mutex> lock{ m_mutex };
+							--m_queued;
+						}
+						try {
+							func( );
+						} catch( ... ) {
+							std::lock_guard<std::mutex> lock{ m_mutex };
+							if( !m_error ) {
+								m_error = std::current_exception( );
+							}
+						}
+						finish_task( );
+					}, *this );
+				} catch( ... ) {
+					{
+						std::lock_guard<std::mutex> lock{ m_mutex };
+						--m_queued;
+					}
+					finish_task( );	// It was never queued
+					throw;
+				}
+				std::lock_guard<std::mutex> lock{ m_mutex };
+				m_done.notify_all( );	// A waiter blocked on running tasks may run this one
+			}
+
+			/// <summary>Wait for every task and rethrow the first exception thrown by one</summary>
+			void wait( ) {
+				wait_for_tasks( );
+				if( m_error ) {
+					std::rethrow_exception( m_error );
+				}
+			}
+		};	// task_group
+	}	// namespace data
+}	// namespace daw
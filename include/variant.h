@@ -24,7 +24,9 @@
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/shared_array.hpp>
+#include <boost/utility/string_view.hpp>
 #include <cinttypes>
+#include <cstddef>
 
 #include <daw/daw_cstring.h>
 #include <daw/daw_traits.h>
@@ -32,6 +34,7 @@
 #include <daw/daw_variant.h>
 
 #include "data_types.h"
+#include "decimal.h"
 #include "defs.h"
 
 namespace boost { namespace posix_time {
@@ -42,14 +45,15 @@ namespace daw {
 	namespace data {
 		class Variant {
 			DataCellType m_type;
-			using value_t = daw::variant_t<integer_t, real_t, timestamp_t, daw::cstring>;
+			using value_t = daw::variant_t<integer_t, real_t, timestamp_t, daw::cstring, decimal_t>;
 			value_t m_value;
 		public:
 			Variant( );
 			~Variant( );
 
-			Variant( Variant const & other ) = default;
-			Variant& operator=(Variant const & rhs) = default;
+			/// <summary>Copies own their characters, even when other borrows them</summary>
+			Variant( Variant const & other );
+			Variant& operator=(Variant const & rhs);
 
 			Variant( Variant&& value ) noexcept;
 			Variant& operator=(Variant && rhs) noexcept;
@@ -58,6 +62,10 @@ namespace daw {
 			explicit Variant( real_t value );
 			explicit Variant( timestamp_t value );
 			explicit Variant( daw::cstring value );
+			explicit Variant( decimal_t value );
+			/// <summary>A string that points at the characters of value without copying or owning them.  They must outlive
+			/// this and anything it is moved to, as those of a memory_arena_t do</summary>
+			static Variant borrowed( daw::cstring value );
 
 			bool empty( ) const noexcept;
 			DataCellType type( ) const noexcept;
@@ -65,12 +73,20 @@ namespace daw {
 			integer_t const & integer( ) const;
 			real_t const & real( ) const;
 			timestamp_t const & timestamp( ) const;
+			decimal_t const & decimal( ) const;
 
 			std::string string( std::string locale = "" ) const;
+			/// <summary>View of the stored characters of a string value.  Empty for all other types</summary>
+			boost::string_view string_view( ) const noexcept;
 
 			static int compare( Variant const & lhs, Variant const & rhs );
 			int compare( Variant const & rhs ) const;
 
+			/// <summary>Hash of the stored value.  Equal values have equal hashes</summary>
+			std::size_t hash( ) const;
+			/// <summary>Equality on the stored values without converting to std::string</summary>
+			static bool equal( Variant const & lhs, Variant const & rhs );
+
 			void swap( Variant & rhs ) noexcept;
 		};	// Variant
 
@@ -0,0 +1,47 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "cancellation_token.h"
+
+namespace daw {
+	namespace data {
+		cancellation_token::cancellation_token( ): m_cancelled{ std::make_shared<std::atomic<bool>>( false ) } { }
+
+		void cancellation_token::cancel( ) noexcept {
+			m_cancelled->store( true, std::memory_order_release );
+		}
+
+		bool cancellation_token::is_cancelled( ) const noexcept {
+			return m_cancelled->load( std::memory_order_acquire );
+		}
+
+		operation_cancelled::operation_cancelled( reason_t reason, std::string const & message ): std::runtime_error{ message }, m_reason{ reason } { }
+
+		operation_cancelled::reason_t operation_cancelled::reason( ) const noexcept {
+			return m_reason;
+		}
+	}	// namespace data
+}	// namespace daw
@@ -0,0 +1,278 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <boost/optional.hpp>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <daw/daw_exception.h>
+
+#include "column_sketches.h"
+
+namespace daw {
+	namespace data {
+		namespace {
+			/// <summary>splitmix64 finalizer.  Cell hashes are not mixed well enough for HyperLogLog on their own</summary>
+			uint64_t mix( uint64_t value ) noexcept {
+				value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+				value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+				return value ^ (value >> 31);
+			}
+
+			uint8_t leading_zeros( uint64_t value ) noexcept {
+#if defined( __GNUC__ ) || defined( __clang__ )
+				return 0 == value ? 64 : static_cast<uint8_t>(__builtin_clzll( value ));
+#else
+				uint8_t result = 0;
+				for( uint64_t bit = 1ULL << 63; 0 != bit && 0 == (value & bit); bit >>= 1 ) {
+					++result;
+				}
+				return result;
+#endif
+			}
+		}	// namespace anonymous
+
+		// hyperloglog_t
+		hyperloglog_t::hyperloglog_t( uint8_t precision ):
+				m_precision{ precision },
+				m_registers{ } {
+
+			daw::exception::daw_throw_on_false( 4 <= precision && precision <= 18, "{0}: precision must be from 4 to 18", __func__ );
+			m_registers.resize( size_t{ 1 } << precision, 0 );
+		}
+
+		void hyperloglog_t::add_hash( uint64_t hash ) noexcept {
+			auto const index = static_cast<size_t>(hash >> (64 - m_precision));
+			auto const rest = hash << m_precision;
+			auto const rank = static_cast<uint8_t>(std::min<uint8_t>( leading_zeros( rest ), static_cast<uint8_t>(64 - m_precision) ) + 1);
+			if( rank > m_registers[index] ) {
+				m_registers[index] = rank;
+			}
+		}
+
+		void hyperloglog_t::merge( hyperloglog_t const & other ) {
+			daw::exception::daw_throw_on_false( m_precision == other.m_precision, "{0}: Cannot merge sketches of different precision", __func__ );
+			for( size_t n = 0; n < m_registers.size( ); ++n ) {
+				m_registers[n] = std::max( m_registers[n], other.m_registers[n] );
+			}
+		}
+
+		double hyperloglog_t::estimate( ) const {
+			auto const m = static_cast<double>(m_registers.size( ));
+			double sum = 0.0;
+			size_t zeros = 0;
+			for( auto const reg : m_registers ) {
+				sum += std::ldexp( 1.0, -static_cast<int>(reg) );
+				zeros += 0 == reg ? 1 : 0;
+			}
+			auto const alpha = 0.7213 / (1.0 + 1.079 / m);
+			auto const result = alpha * m * m / sum;
+			if( result <= 2.5 * m && 0 < zeros ) {	// Linear counting is more accurate for small sets
+				return m * std::log( m / static_cast<double>(zeros) );
+			}
+			return result;
+		}
+
+		uint8_t hyperloglog_t::precision( ) const noexcept {
+			return m_precision;
+		}
+
+		// kll_sketch_t
+		kll_sketch_t::kll_sketch_t( size_t k ):
+				m_k{ std::max<size_t>( 8, k ) },
+				m_count{ 0 },
+				m_min{ std::numeric_limits<double>::infinity( ) },
+				m_max{ -std::numeric_limits<double>::infinity( ) },
+				m_random{ 0x9e3779b97f4a7c15ULL },
+				m_levels( 1 ) { }
+
+		size_t kll_sketch_t::capacity( size_t level ) const noexcept {
+			// Lower levels shrink geometrically by 2/3 from k at the top
+			auto const depth = m_levels.size( ) - 1 - level;
+			return std::max<size_t>( 2, static_cast<size_t>(std::ceil( static_cast<double>(m_k) * std::pow( 2.0 / 3.0, static_cast<double>(depth) ) )) );
+		}
+
+		bool kll_sketch_t::over_capacity( ) const noexcept {
+			for( size_t level = 0; level < m_levels.size( ); ++level ) {
+				if( m_levels[level].size( ) >= capacity( level ) ) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void kll_sketch_t::compress( ) {
+			for( size_t level = 0; level < m_levels.size( ); ++level ) {
+				if( m_levels[level].size( ) < capacity( level ) ) {
+					continue;
+				}
+				if( level + 1 == m_levels.size( ) ) {
+					m_levels.emplace_back( );
+				}
+				auto & items = m_levels[level];
+				std::sort( items.begin( ), items.end( ) );
+				boost::optional<double> odd_item;
+				if( 0 != items.size( ) % 2 ) {
+					odd_item = items.back( );
+					items.pop_back( );
+				}
+				// xorshift64 picks which half survives so the error is unbiased
+				m_random ^= m_random << 13;
+				m_random ^= m_random >> 7;
+				m_random ^= m_random << 17;
+				auto & next = m_levels[level + 1];
+				for( auto n = static_cast<size_t>(m_random & 1); n < items.size( ); n += 2 ) {
+					next.push_back( items[n] );
+				}
+				items.clear( );
+				if( odd_item ) {
+					items.push_back( *odd_item );
+				}
+			}
+		}
+
+		void kll_sketch_t::add( double value ) {
+			if( std::isnan( value ) ) {
+				return;
+			}
+			++m_count;
+			m_min = std::min( m_min, value );
+			m_max = std::max( m_max, value );
+			m_levels.front( ).push_back( value );
+			if( m_levels.front( ).size( ) >= capacity( 0 ) ) {
+				compress( );
+			}
+		}
+
+		void kll_sketch_t::merge( kll_sketch_t const & other ) {
+			if( 0 == other.m_count ) {
+				return;
+			}
+			if( m_levels.size( ) < other.m_levels.size( ) ) {
+				m_levels.resize( other.m_levels.size( ) );
+			}
+			for( size_t level = 0; level < other.m_levels.size( ); ++level ) {
+				m_levels[level].insert( m_levels[level].end( ), other.m_levels[level].begin( ), other.m_levels[level].end( ) );
+			}
+			m_count += other.m_count;
+			m_min = std::min( m_min, other.m_min );
+			m_max = std::max( m_max, other.m_max );
+			// Merged levels can be several times over capacity and each pass only halves them
+			while( over_capacity( ) ) {
+				compress( );
+			}
+		}
+
+		uint64_t kll_sketch_t::count( ) const noexcept {
+			return m_count;
+		}
+
+		size_t kll_sketch_t::k( ) const noexcept {
+			return m_k;
+		}
+
+		double kll_sketch_t::quantile( double q ) const {
+			if( 0 == m_count ) {
+				return std::numeric_limits<double>::quiet_NaN( );
+			}
+			if( q <= 0.0 ) {
+				return m_min;
+			}
+			if( q >= 1.0 ) {
+				return m_max;
+			}
+			std::vector<std::pair<double, uint64_t>> weighted;
+			uint64_t total = 0;
+			for( size_t level = 0; level < m_levels.size( ); ++level ) {
+				for( auto const value : m_levels[level] ) {
+					weighted.emplace_back( value, uint64_t{ 1 } << level );
+					total += uint64_t{ 1 } << level;
+				}
+			}
+			std::sort( weighted.begin( ), weighted.end( ) );
+			auto const target = q * static_cast<double>(total);
+			uint64_t cumulative = 0;
+			for( auto const & item : weighted ) {
+				cumulative += item.second;
+				if( static_cast<double>(cumulative) >= target ) {
+					return item.first;
+				}
+			}
+			return m_max;
+		}
+
+		double kll_sketch_t::rank( double value ) const {
+			uint64_t below = 0;
+			uint64_t total = 0;
+			for( size_t level = 0; level < m_levels.size( ); ++level ) {
+				for( auto const item : m_levels[level] ) {
+					total += uint64_t{ 1 } << level;
+					if( item <= value ) {
+						below += uint64_t{ 1 } << level;
+					}
+				}
+			}
+			return 0 == total ? std::numeric_limits<double>::quiet_NaN( ) : static_cast<double>(below) / static_cast<double>(total);
+		}
+
+		size_t kll_sketch_t::retained( ) const noexcept {
+			size_t result = 0;
+			for( auto const & items : m_levels ) {
+				result += items.size( );
+			}
+			return result;
+		}
+
+		// column_sketches
+		column_sketches::column_sketches( uint8_t precision, size_t k ):
+				distinct{ precision },
+				quantiles{ k } { }
+
+		void column_sketches::add( DataCell const & cell ) {
+			if( cell.empty( ) ) {
+				return;
+			}
+			distinct.add_hash( mix( static_cast<uint64_t>(cell.hash( )) ) );
+			switch( cell.type( ) ) {
+			case DataCellType::integer:
+				quantiles.add( static_cast<double>(cell.integer( )) );
+				break;
+			case DataCellType::real:
+				quantiles.add( static_cast<double>(cell.real( )) );
+				break;
+			case DataCellType::decimal:
+				quantiles.add( cell.decimal( ).to_double( ) );
+				break;
+			default:
+				break;
+			}
+		}
+
+		void column_sketches::merge( column_sketches const & other ) {
+			distinct.merge( other.distinct );
+			quantiles.merge( other.quantiles );
+		}
+	}	// namespace data
+}	// namespace daw
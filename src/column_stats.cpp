@@ -0,0 +1,195 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "column_stats.h"
+
+namespace daw {
+	namespace data {
+		constexpr size_t const value_range_t::no_row;
+		constexpr size_t const column_stats::zone_rows;
+
+		bool value_range_t::may_contain( double lo, double hi ) const noexcept {
+			return numeric_min <= hi && lo <= numeric_max;
+		}
+
+		bool value_range_t::may_contain( timestamp_t const & lo, timestamp_t const & hi ) const {
+			return !timestamp_min.is_not_a_date_time( ) && timestamp_min <= hi && lo <= timestamp_max;
+		}
+
+		bool value_range_t::has_nulls( ) const noexcept {
+			return 0 < null_count;
+		}
+
+		void value_range_t::add_value( DataCell const & cell ) {
+			switch( cell.type( ) ) {
+			case DataCellType::integer:
+			case DataCellType::real: {
+				auto const value = DataCellType::integer == cell.type( ) ? static_cast<double>(cell.integer( )) : static_cast<double>(cell.real( ));
+				numeric_min = std::min( numeric_min, value );
+				numeric_max = std::max( numeric_max, value );
+				break;
+			}
+			case DataCellType::decimal: {
+				auto const value = cell.decimal( ).to_double( );
+				numeric_min = std::min( numeric_min, value );
+				numeric_max = std::max( numeric_max, value );
+				break;
+			}
+			case DataCellType::timestamp: {
+				auto const value = cell.timestamp( );
+				if( timestamp_min.is_not_a_date_time( ) || value < timestamp_min ) {
+					timestamp_min = value;
+				}
+				if( timestamp_max.is_not_a_date_time( ) || value > timestamp_max ) {
+					timestamp_max = value;
+				}
+				break;
+			}
+			case DataCellType::empty_string:
+			case DataCellType::string:
+				break;
+			}
+		}
+
+		column_stats::column_stats( ):
+				m_totals{ },
+				m_type_counts{ },
+				m_string_bytes{ 0 },
+				m_zones{ },
+				m_integer_min{ std::numeric_limits<integer_t>::max( ) },
+				m_integer_max{ std::numeric_limits<integer_t>::min( ) },
+				m_reals_fit_float{ true } { }
+
+		void column_stats::add_numeric( DataCell const & cell ) {
+			if( DataCellType::integer == cell.type( ) ) {
+				m_integer_min = std::min( m_integer_min, cell.integer( ) );
+				m_integer_max = std::max( m_integer_max, cell.integer( ) );
+			} else if( m_reals_fit_float ) {
+				auto const value = cell.real( );
+				m_reals_fit_float = std::isnan( value ) || static_cast<real_t>(static_cast<float>(value)) == value;
+			}
+		}
+
+		void column_stats::clear( ) {
+			m_totals = value_range_t{ };
+			m_type_counts.fill( 0 );
+			m_string_bytes = 0;
+			m_zones.clear( );
+			m_integer_min = std::numeric_limits<integer_t>::max( );
+			m_integer_max = std::numeric_limits<integer_t>::min( );
+			m_reals_fit_float = true;
+		}
+
+		value_range_t const & column_stats::totals( ) const noexcept {
+			return m_totals;
+		}
+
+		size_t column_stats::row_count( ) const noexcept {
+			return m_totals.count;
+		}
+
+		size_t column_stats::null_count( ) const noexcept {
+			return m_totals.null_count;
+		}
+
+		size_t column_stats::type_count( DataCellType type ) const noexcept {
+			return m_type_counts[static_cast<size_t>(type)];
+		}
+
+		uint64_t column_stats::string_bytes( ) const noexcept {
+			return m_string_bytes;
+		}
+
+		std::vector<value_range_t> const & column_stats::zones( ) const noexcept {
+			return m_zones;
+		}
+
+		boost::optional<double> column_stats::numeric_min( ) const {
+			if( m_totals.numeric_min > m_totals.numeric_max ) {
+				return boost::none;
+			}
+			return m_totals.numeric_min;
+		}
+
+		boost::optional<double> column_stats::numeric_max( ) const {
+			if( m_totals.numeric_min > m_totals.numeric_max ) {
+				return boost::none;
+			}
+			return m_totals.numeric_max;
+		}
+
+		boost::optional<integer_t> column_stats::integer_min( ) const {
+			if( 0 == type_count( DataCellType::integer ) ) {
+				return boost::none;
+			}
+			return m_integer_min;
+		}
+
+		boost::optional<integer_t> column_stats::integer_max( ) const {
+			if( 0 == type_count( DataCellType::integer ) ) {
+				return boost::none;
+			}
+			return m_integer_max;
+		}
+
+		storage_width_t column_stats::width( ) const noexcept {
+			auto const integers = type_count( DataCellType::integer );
+			auto const reals = type_count( DataCellType::real );
+			if( 0 == integers + reals || integers + reals + null_count( ) != row_count( ) ) {
+				return storage_width_t::none;
+			}
+			if( 0 == reals ) {
+				return narrowest_integer_width( m_integer_min, m_integer_max );
+			}
+			auto const integers_within = [&]( integer_t limit ) {
+				return 0 == integers || (-limit <= m_integer_min && m_integer_max <= limit);
+			};
+			if( m_reals_fit_float && integers_within( integer_t{ 1 } << 24 ) ) {
+				return storage_width_t::float32;
+			}
+			if( integers_within( integer_t{ 1 } << 53 ) ) {
+				return storage_width_t::float64;
+			}
+			return storage_width_t::none;
+		}
+
+		storage_width_t narrowest_integer_width( integer_t min, integer_t max ) noexcept {
+			auto const within = [min, max]( integer_t lo, integer_t hi ) {
+				return lo <= min && max <= hi;
+			};
+			if( within( std::numeric_limits<int8_t>::min( ), std::numeric_limits<int8_t>::max( ) ) ) {
+				return storage_width_t::int8;
+			}
+			if( within( std::numeric_limits<int16_t>::min( ), std::numeric_limits<int16_t>::max( ) ) ) {
+				return storage_width_t::int16;
+			}
+			if( within( std::numeric_limits<int32_t>::min( ), std::numeric_limits<int32_t>::max( ) ) ) {
+				return storage_width_t::int32;
+			}
+			return storage_width_t::int64;
+		}
+	}	// namespace data
+}	// namespace daw
@@ -0,0 +1,469 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <daw/daw_exception.h>
+
+#include "compressed_column.h"
+
+namespace daw {
+	namespace data {
+		namespace {
+			boost::posix_time::ptime const & epoch( ) {
+				static boost::posix_time::ptime const result{ boost::gregorian::date{ 1970, 1, 1 } };
+				return result;
+			}
+
+			/// <summary>Microseconds since the epoch, the infinities as the reserved values.  Throws for not_a_date_time</summary>
+			int64_t to_microseconds( timestamp_t const & value ) {
+				if( value.is_neg_infinity( ) ) {
+					return compressed_column_t::neg_infinity_value;
+				}
+				if( value.is_pos_infinity( ) ) {
+					return compressed_column_t::pos_infinity_value;
+				}
+				daw::exception::daw_throw_on_true( value.is_special( ), "{0}: Timestamp is not a date and time", __func__ );
+				return (value - epoch( )).total_microseconds( );
+			}
+
+			timestamp_t from_microseconds( int64_t value ) {
+				if( compressed_column_t::neg_infinity_value == value ) {
+					return timestamp_t{ boost::posix_time::neg_infin };
+				}
+				if( compressed_column_t::pos_infinity_value == value ) {
+					return timestamp_t{ boost::posix_time::pos_infin };
+				}
+				return epoch( ) + boost::posix_time::microseconds( value );
+			}
+
+			/// <summary>Stored as a null</summary>
+			bool is_null_cell( DataCell const & cell, DataCellType type ) {
+				return cell.empty( ) || (DataCellType::timestamp == type && cell.timestamp( ).is_not_a_date_time( ));
+			}
+
+			DataCellType stored_type( DataTable::value_type const & column ) {
+				auto const & stats = column.stats( );
+				auto const nulls = stats.type_count( DataCellType::empty_string );
+				for( auto const type : { DataCellType::integer, DataCellType::timestamp } ) {
+					if( stats.type_count( type ) + nulls == column.size( ) ) {
+						return type;
+					}
+				}
+				daw::exception::daw_throw_on_true( true, "{0}: Column {1} is not all integers or all timestamps", __func__, column.header( ) );
+				return DataCellType::integer;
+			}
+
+			constexpr size_t const block_rows = 1024;	// Rows unpacked at a time by the scans
+
+			uint8_t bits_for( uint64_t range ) noexcept {
+				uint8_t result = 0;
+				for( ; 0 != range; range >>= 1 ) {
+					++result;
+				}
+				return result;
+			}
+		}	// namespace anonymous
+
+		constexpr int64_t const compressed_column_t::neg_infinity_value;
+		constexpr int64_t const compressed_column_t::pos_infinity_value;
+
+		compressed_column_t::compressed_column_t( ):
+				m_header{ },
+				m_encoding{ column_encoding_t::run_length },
+				m_type{ DataCellType::integer },
+				m_size{ 0 },
+				m_null_count{ 0 },
+				m_min{ },
+				m_max{ },
+				m_run_values{ },
+				m_run_ends{ },
+				m_run_valid{ },
+				m_bits{ 0 },
+				m_packed{ },
+				m_valid{ } { }
+
+		compressed_column_t::compressed_column_t( DataTable::value_type const & column ):
+				compressed_column_t{ } {
+
+			std::vector<int64_t> values;
+			std::vector<uint8_t> valid;
+			auto const runs = load( column, values, valid );
+			// Pick the smaller, as encode would lay them out
+			auto const has_nulls = 0 < m_null_count;
+			auto const run_bytes = runs * (sizeof( int64_t ) + sizeof( uint64_t ) + (has_nulls ? 1 : 0));
+			auto const bits = m_min ? bits_for( static_cast<uint64_t>(*m_max) - static_cast<uint64_t>(*m_min) ) : 0;
+			auto const packed_bytes = (static_cast<uint64_t>(m_size) * bits + 63) / 64 * sizeof( uint64_t ) + (has_nulls ? m_size : 0);
+			encode( values, valid, run_bytes <= packed_bytes ? column_encoding_t::run_length : column_encoding_t::frame_of_reference );
+		}
+
+		compressed_column_t::compressed_column_t( DataTable::value_type const & column, column_encoding_t encoding ):
+				compressed_column_t{ } {
+
+			std::vector<int64_t> values;
+			std::vector<uint8_t> valid;
+			load( column, values, valid );
+			encode( values, valid, encoding );
+		}
+
+		size_t compressed_column_t::load( DataTable::value_type const & column, std::vector<int64_t> & values, std::vector<uint8_t> & valid ) {
+			m_header = column.header( );
+			m_type = stored_type( column );
+			m_size = column.size( );
+			values.assign( m_size, 0 );
+			valid.assign( m_size, 0 );
+			size_t runs = 0;
+			for( size_t row = 0; row < m_size; ++row ) {
+				auto const & cell = column[row];
+				if( is_null_cell( cell, m_type ) ) {
+					++m_null_count;
+				} else {
+					values[row] = DataCellType::integer == m_type ? cell.integer( ) : to_microseconds( cell.timestamp( ) );
+					valid[row] = 1;
+					if( !m_min || values[row] < *m_min ) {
+						m_min = values[row];
+					}
+					if( !m_max || values[row] > *m_max ) {
+						m_max = values[row];
+					}
+				}
+				if( 0 == row || valid[row] != valid[row - 1] || values[row] != values[row - 1] ) {
+					++runs;
+				}
+			}
+			return runs;
+		}
+
+		void compressed_column_t::encode( std::vector<int64_t> const & values, std::vector<uint8_t> const & valid, column_encoding_t encoding ) {
+			m_encoding = encoding;
+			auto const has_nulls = 0 < m_null_count;
+			if( column_encoding_t::run_length == encoding ) {
+				for( size_t row = 0; row < m_size; ++row ) {
+					if( 0 == row || valid[row] != valid[row - 1] || values[row] != values[row - 1] ) {
+						m_run_values.push_back( values[row] );
+						m_run_ends.push_back( row + 1 );
+						if( has_nulls ) {
+							m_run_valid.push_back( valid[row] );
+						}
+					} else {
+						++m_run_ends.back( );
+					}
+				}
+				m_run_values.shrink_to_fit( );
+				m_run_ends.shrink_to_fit( );
+				m_run_valid.shrink_to_fit( );
+				return;
+			}
+			if( !m_min ) {	// Nothing but nulls
+				m_valid = valid;
+				return;
+			}
+			auto const base = static_cast<uint64_t>(*m_min);
+			m_bits = bits_for( static_cast<uint64_t>(*m_max) - base );
+			if( 0 < m_bits ) {
+				m_packed.resize( static_cast<size_t>((static_cast<uint64_t>(m_size) * m_bits + 63) / 64) );
+				for( size_t row = 0; row < m_size; ++row ) {
+					if( 0 == valid[row] ) {
+						continue;
+					}
+					auto const offset = static_cast<uint64_t>(values[row]) - base;
+					auto const bit = static_cast<uint64_t>(row) * m_bits;
+					auto const word = static_cast<size_t>(bit / 64);
+					auto const shift = static_cast<unsigned>(bit % 64);
+					m_packed[word] |= offset << shift;
+					if( shift + m_bits > 64 ) {
+						m_packed[word + 1] |= offset >> (64 - shift);
+					}
+				}
+			}
+			if( has_nulls ) {
+				m_valid = valid;
+			}
+		}
+
+		size_t compressed_column_t::run_of( size_t row ) const {
+			return static_cast<size_t>(std::upper_bound( m_run_ends.begin( ), m_run_ends.end( ), static_cast<uint64_t>(row) ) - m_run_ends.begin( ));
+		}
+
+		void compressed_column_t::unpack_offsets( size_t first, size_t count, uint64_t * out ) const noexcept {
+			if( 0 == m_bits ) {
+				std::fill( out, out + count, uint64_t{ 0 } );
+				return;
+			}
+			auto const mask = 64 == m_bits ? ~uint64_t{ 0 } : (uint64_t{ 1 } << m_bits) - 1;
+			auto bit = static_cast<uint64_t>(first) * m_bits;
+			for( size_t n = 0; n < count; ++n, bit += m_bits ) {
+				auto const word = static_cast<size_t>(bit / 64);
+				auto const shift = static_cast<unsigned>(bit % 64);
+				auto value = m_packed[word] >> shift;
+				if( shift + m_bits > 64 ) {
+					value |= m_packed[word + 1] << (64 - shift);
+				}
+				out[n] = value & mask;
+			}
+		}
+
+		std::string const & compressed_column_t::header( ) const noexcept {
+			return m_header;
+		}
+
+		column_encoding_t compressed_column_t::encoding( ) const noexcept {
+			return m_encoding;
+		}
+
+		DataCellType compressed_column_t::type( ) const noexcept {
+			return m_type;
+		}
+
+		size_t compressed_column_t::size( ) const noexcept {
+			return m_size;
+		}
+
+		bool compressed_column_t::empty( ) const noexcept {
+			return 0 == m_size;
+		}
+
+		size_t compressed_column_t::memory_size( ) const noexcept {
+			return m_run_values.size( ) * sizeof( int64_t ) + m_run_ends.size( ) * sizeof( uint64_t ) + m_run_valid.size( ) + m_packed.size( ) * sizeof( uint64_t ) + m_valid.size( );
+		}
+
+		size_t compressed_column_t::run_count( ) const noexcept {
+			return column_encoding_t::run_length == m_encoding ? m_run_ends.size( ) : m_size;
+		}
+
+		uint8_t compressed_column_t::bits( ) const noexcept {
+			return m_bits;
+		}
+
+		bool compressed_column_t::is_null( size_t row ) const {
+			if( column_encoding_t::run_length == m_encoding ) {
+				return !m_run_valid.empty( ) && 0 == m_run_valid[run_of( row )];
+			}
+			return !row_is_valid( row );
+		}
+
+		int64_t compressed_column_t::value( size_t row ) const {
+			if( column_encoding_t::run_length == m_encoding ) {
+				return m_run_values[run_of( row )];
+			}
+			if( !row_is_valid( row ) ) {
+				return 0;
+			}
+			return static_cast<int64_t>(static_cast<uint64_t>(*m_min) + offset_of( row ));
+		}
+
+		DataCell compressed_column_t::cell( size_t row ) const {
+			if( is_null( row ) ) {
+				return DataCell{ };
+			}
+			if( DataCellType::integer == m_type ) {
+				return DataCell{ value( row ) };
+			}
+			return DataCell{ from_microseconds( value( row ) ) };
+		}
+
+		void compressed_column_t::decode( size_t first, size_t count, int64_t * out ) const {
+			daw::exception::daw_throw_on_true( first + count > m_size, "{0}: Rows are past the end of the column", __func__ );
+			if( 0 == count ) {
+				return;
+			}
+			if( column_encoding_t::run_length == m_encoding ) {
+				auto run = run_of( first );
+				for( auto row = first; row < first + count; ++row ) {
+					if( row >= m_run_ends[run] ) {
+						++run;
+					}
+					*out++ = m_run_values[run];
+				}
+				return;
+			}
+			if( !m_min ) {
+				std::fill( out, out + count, int64_t{ 0 } );
+				return;
+			}
+			auto const base = static_cast<uint64_t>(*m_min);
+			uint64_t offsets[block_rows];
+			for( size_t block = 0; block < count; block += block_rows ) {
+				auto const rows = std::min( block_rows, count - block );
+				unpack_offsets( first + block, rows, offsets );
+				for( size_t n = 0; n < rows; ++n ) {
+					out[block + n] = row_is_valid( first + block + n ) ? static_cast<int64_t>(base + offsets[n]) : 0;
+				}
+			}
+		}
+
+		size_t compressed_column_t::count( ) const noexcept {
+			return m_size - m_null_count;
+		}
+
+		int64_t compressed_column_t::sum( ) const {
+			int64_t result = 0;
+			if( column_encoding_t::run_length == m_encoding ) {
+				for_each_run( [&result]( size_t, size_t rows, int64_t value ) {
+					int64_t product = 0;
+					daw::exception::daw_throw_on_true( __builtin_mul_overflow( value, static_cast<int64_t>(rows), &product ) || __builtin_add_overflow( result, product, &result ), "{0}: Integer overflow", __func__ );
+				} );
+				return result;
+			}
+			if( !m_min ) {
+				return 0;
+			}
+			auto const base = static_cast<uint64_t>(*m_min);
+			uint64_t offsets[block_rows];
+			for( size_t first = 0; first < m_size; first += block_rows ) {
+				auto const rows = std::min( block_rows, m_size - first );
+				unpack_offsets( first, rows, offsets );
+				for( size_t n = 0; n < rows; ++n ) {
+					if( row_is_valid( first + n ) ) {
+						daw::exception::daw_throw_on_true( __builtin_add_overflow( result, static_cast<int64_t>(base + offsets[n]), &result ), "{0}: Integer overflow", __func__ );
+					}
+				}
+			}
+			return result;
+		}
+
+		boost::optional<int64_t> const & compressed_column_t::min( ) const noexcept {
+			return m_min;
+		}
+
+		boost::optional<int64_t> const & compressed_column_t::max( ) const noexcept {
+			return m_max;
+		}
+
+		double compressed_column_t::mean( ) const {
+			if( !m_min ) {
+				return std::numeric_limits<double>::quiet_NaN( );
+			}
+			if( DataCellType::timestamp == m_type && (neg_infinity_value == *m_min || pos_infinity_value == *m_max) ) {
+				if( neg_infinity_value == *m_min && pos_infinity_value == *m_max ) {
+					return std::numeric_limits<double>::quiet_NaN( );
+				}
+				return neg_infinity_value == *m_min ? -std::numeric_limits<double>::infinity( ) : std::numeric_limits<double>::infinity( );
+			}
+			// Offsets from the minimum, so large values such as timestamps keep their precision
+			double total = 0.0;
+			if( column_encoding_t::run_length == m_encoding ) {
+				auto const base = *m_min;
+				for_each_run( [&total, base]( size_t, size_t rows, int64_t value ) {
+					total += static_cast<double>(static_cast<uint64_t>(value) - static_cast<uint64_t>(base)) * static_cast<double>(rows);
+				} );
+			} else {
+				uint64_t offsets[block_rows];
+				for( size_t first = 0; first < m_size; first += block_rows ) {
+					auto const rows = std::min( block_rows, m_size - first );
+					unpack_offsets( first, rows, offsets );
+					for( size_t n = 0; n < rows; ++n ) {
+						if( row_is_valid( first + n ) ) {
+							total += static_cast<double>(offsets[n]);
+						}
+					}
+				}
+			}
+			return static_cast<double>(*m_min) + total / static_cast<double>(count( ));
+		}
+
+		std::vector<uint8_t> compressed_column_t::filter_between( int64_t low, int64_t high ) const {
+			std::vector<uint8_t> result( m_size );
+			if( !m_min || low > high || high < *m_min || low > *m_max ) {
+				return result;
+			}
+			if( column_encoding_t::run_length == m_encoding ) {
+				for_each_run( [&result, low, high]( size_t first, size_t rows, int64_t value ) {
+					if( low <= value && value <= high ) {
+						std::fill_n( result.begin( ) + static_cast<std::ptrdiff_t>(first), rows, uint8_t{ 1 } );
+					}
+				} );
+				return result;
+			}
+			// Compare offsets from the minimum so the values are never rebuilt
+			auto const base = static_cast<uint64_t>(*m_min);
+			auto const first_offset = low <= *m_min ? uint64_t{ 0 } : static_cast<uint64_t>(low) - base;
+			auto const last_offset = (high >= *m_max ? static_cast<uint64_t>(*m_max) : static_cast<uint64_t>(high)) - base;
+			uint64_t offsets[block_rows];
+			for( size_t first = 0; first < m_size; first += block_rows ) {
+				auto const rows = std::min( block_rows, m_size - first );
+				unpack_offsets( first, rows, offsets );
+				auto const out = result.data( ) + first;
+				for( size_t n = 0; n < rows; ++n ) {
+					out[n] = static_cast<uint8_t>((first_offset <= offsets[n]) & (offsets[n] <= last_offset));
+				}
+				if( !m_valid.empty( ) ) {
+					for( size_t n = 0; n < rows; ++n ) {
+						out[n] &= m_valid[first + n];
+					}
+				}
+			}
+			return result;
+		}
+
+		std::vector<uint8_t> compressed_column_t::filter_between( timestamp_t const & low, timestamp_t const & high ) const {
+			return filter_between( to_microseconds( low ), to_microseconds( high ) );
+		}
+
+		std::vector<uint8_t> compressed_column_t::filter_equal( int64_t value ) const {
+			return filter_between( value, value );
+		}
+
+		DataTable::value_type compressed_column_t::decompress( ) const {
+			DataTable::value_type result{ m_header };
+			result.reserve( m_size );
+			if( column_encoding_t::run_length == m_encoding ) {
+				uint64_t first = 0;
+				for( size_t run = 0; run < m_run_ends.size( ); ++run ) {
+					DataCell cell;
+					if( m_run_valid.empty( ) || 0 != m_run_valid[run] ) {
+						cell = DataCellType::integer == m_type ? DataCell{ m_run_values[run] } : DataCell{ from_microseconds( m_run_values[run] ) };
+					}
+					for( auto row = first; row < m_run_ends[run]; ++row ) {
+						result.append( cell );
+					}
+					first = m_run_ends[run];
+				}
+				return result;
+			}
+			for( size_t row = 0; row < m_size; ++row ) {
+				result.append( cell( row ) );
+			}
+			return result;
+		}
+
+		std::vector<compressed_column_t> compress_columns( DataTable const & table ) {
+			std::vector<compressed_column_t> result;
+			for( auto const & column : table ) {
+				auto const & stats = column.stats( );
+				auto const nulls = stats.type_count( DataCellType::empty_string );
+				for( auto const type : { DataCellType::integer, DataCellType::timestamp } ) {
+					if( 0 < stats.type_count( type ) && stats.type_count( type ) + nulls == column.size( ) ) {
+						result.emplace_back( column );
+						break;
+					}
+				}
+			}
+			return result;
+		}
+	}	// namespace data
+}	// namespace daw
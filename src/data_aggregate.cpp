@@ -0,0 +1,504 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#endif
+
+#include <daw/daw_exception.h>
+
+#include "data_aggregate.h"
+#include "data_algorithms.h"
+
+namespace daw {
+	namespace data {
+		namespace aggregate {
+			namespace {
+				constexpr size_t min_parallel_block = 65536;
+
+				/// <summary>Run func( first, last ) over row blocks, in parallel when there is enough work, and fold the results</summary>
+				template<typename Result, typename Function, typename Combine>
+				Result reduce_blocks( size_t const size, Result const init, Function func, Combine combine ) {
+					return algorithm::parallel_reduce( 0, size, init, func, combine, min_parallel_block );
+				}
+
+				inline bool is_valid( uint8_t const * valid, size_t const n ) noexcept {
+					return nullptr == valid || 0 != valid[n];
+				}
+
+				inline uint8_t const * offset( uint8_t const * valid, size_t const first ) noexcept {
+					return nullptr == valid ? nullptr : valid + first;
+				}
+
+				template<typename T>
+				struct min_max_t {
+					T min;
+					T max;
+
+					/// <summary>The identity of min/max.  Infinities for floating point so that infinite values are not clamped</summary>
+					static min_max_t identity( ) noexcept {
+						return identity( std::is_floating_point<T>{ } );
+					}
+				private:
+					static min_max_t identity( std::true_type ) noexcept {
+						return min_max_t{ std::numeric_limits<T>::infinity( ), -std::numeric_limits<T>::infinity( ) };
+					}
+
+					static min_max_t identity( std::false_type ) noexcept {
+						return min_max_t{ std::numeric_limits<T>::max( ), std::numeric_limits<T>::lowest( ) };
+					}
+				};
+
+				template<typename T>
+				inline bool is_nan( T const value, std::true_type ) noexcept {
+					return value != value;
+				}
+
+				template<typename T>
+				inline bool is_nan( T const, std::false_type ) noexcept {
+					return false;
+				}
+
+				/// <summary>lhs + rhs, or none when that does not fit in int64_t</summary>
+				inline boost::optional<int64_t> checked_add( int64_t const lhs, int64_t const rhs ) noexcept {
+					if( (0 < rhs && lhs > std::numeric_limits<int64_t>::max( ) - rhs) || (0 > rhs && lhs < std::numeric_limits<int64_t>::min( ) - rhs) ) {
+						return boost::none;
+					}
+					return lhs + rhs;
+				}
+
+				inline boost::optional<int64_t> checked_add( boost::optional<int64_t> const & lhs, boost::optional<int64_t> const & rhs ) noexcept {
+					if( !lhs || !rhs ) {
+						return boost::none;
+					}
+					return checked_add( *lhs, *rhs );
+				}
+
+#if defined( __AVX2__ )
+				inline __m256d mask4( uint8_t const * valid ) noexcept {
+					if( nullptr == valid ) {
+						return _mm256_castsi256_pd( _mm256_set1_epi64x( -1 ) );
+					}
+					int32_t bytes;
+					std::memcpy( &bytes, valid, sizeof( bytes ) );
+					auto const wide = _mm256_cvtepu8_epi64( _mm_cvtsi32_si128( bytes ) );
+					return _mm256_castsi256_pd( _mm256_cmpgt_epi64( wide, _mm256_setzero_si256( ) ) );
+				}
+
+				inline __m256i mask8( uint8_t const * valid ) noexcept {
+					if( nullptr == valid ) {
+						return _mm256_set1_epi32( -1 );
+					}
+					auto const wide = _mm256_cvtepu8_epi32( _mm_loadl_epi64( reinterpret_cast<__m128i const *>(valid) ) );
+					return _mm256_cmpgt_epi32( wide, _mm256_setzero_si256( ) );
+				}
+
+				inline __m256d load4( int8_t const * values ) noexcept {
+					int32_t bytes;
+					std::memcpy( &bytes, values, sizeof( bytes ) );
+					return _mm256_cvtepi32_pd( _mm_cvtepi8_epi32( _mm_cvtsi32_si128( bytes ) ) );
+				}
+
+				inline __m256d load4( int16_t const * values ) noexcept {
+					return _mm256_cvtepi32_pd( _mm_cvtepi16_epi32( _mm_loadl_epi64( reinterpret_cast<__m128i const *>(values) ) ) );
+				}
+
+				inline __m256d load4( int32_t const * values ) noexcept {
+					return _mm256_cvtepi32_pd( _mm_loadu_si128( reinterpret_cast<__m128i const *>(values) ) );
+				}
+
+				/// <summary>Inexact past 2^53, so only used where simd_exact is true</summary>
+				inline __m256d load4( int64_t const * values ) noexcept {
+					return _mm256_set_pd( static_cast<double>(values[3]), static_cast<double>(values[2]), static_cast<double>(values[1]), static_cast<double>(values[0]) );
+				}
+
+				inline __m256d load4( float const * values ) noexcept {
+					return _mm256_cvtps_pd( _mm_loadu_ps( values ) );
+				}
+
+				inline __m256d load4( double const * values ) noexcept {
+					return _mm256_loadu_pd( values );
+				}
+
+				inline double horizontal_sum( __m256d value ) noexcept {
+					alignas( 32 ) double lanes[4];
+					_mm256_store_pd( lanes, value );
+					return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+				}
+#endif
+
+				size_t count_block( uint8_t const * valid, size_t const size ) {
+					if( nullptr == valid ) {
+						return size;
+					}
+					size_t result = 0;
+					size_t n = 0;
+#if defined( __AVX2__ )
+					for( ; n + 32 <= size; n += 32 ) {
+						auto const bytes = _mm256_loadu_si256( reinterpret_cast<__m256i const *>(valid + n) );
+						auto const nulls = static_cast<uint32_t>(_mm256_movemask_epi8( _mm256_cmpeq_epi8( bytes, _mm256_setzero_si256( ) ) ));
+						result += 32 - std::bitset<32>( nulls ).count( );
+					}
+#endif
+					for( ; n < size; ++n ) {
+						result += 0 != valid[n] ? 1 : 0;
+					}
+					return result;
+				}
+
+				/// <summary>Does every value of T convert to double exactly, so comparisons can be done there</summary>
+				template<typename T>
+				using simd_exact = std::integral_constant<bool, !std::is_same<T, int64_t>::value>;
+
+				/// <summary>Narrow values cannot overflow the int64_t lanes within a block of fewer than 2^32 rows</summary>
+				boost::optional<int64_t> sum_block( int32_t const * values, uint8_t const * valid, size_t const size, std::true_type ) {
+					int64_t result = 0;
+					size_t n = 0;
+#if defined( __AVX2__ )
+					auto acc_lo = _mm256_setzero_si256( );
+					auto acc_hi = _mm256_setzero_si256( );
+					for( ; n + 8 <= size; n += 8 ) {
+						auto const v = _mm256_and_si256( _mm256_loadu_si256( reinterpret_cast<__m256i const *>(values + n) ), mask8( offset( valid, n ) ) );
+						acc_lo = _mm256_add_epi64( acc_lo, _mm256_cvtepi32_epi64( _mm256_castsi256_si128( v ) ) );
+						acc_hi = _mm256_add_epi64( acc_hi, _mm256_cvtepi32_epi64( _mm256_extracti128_si256( v, 1 ) ) );
+					}
+					alignas( 32 ) int64_t lanes[4];
+					_mm256_store_si256( reinterpret_cast<__m256i *>(lanes), _mm256_add_epi64( acc_lo, acc_hi ) );
+					result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+					for( ; n < size; ++n ) {
+						if( is_valid( valid, n ) ) {
+							result += values[n];
+						}
+					}
+					return result;
+				}
+
+				template<typename T>
+				boost::optional<int64_t> sum_block( T const * values, uint8_t const * valid, size_t const size, std::true_type ) {
+					int64_t result = 0;
+					for( size_t n = 0; n < size; ++n ) {
+						if( is_valid( valid, n ) ) {
+							result += values[n];
+						}
+					}
+					return result;
+				}
+
+				boost::optional<int64_t> sum_block( int64_t const * values, uint8_t const * valid, size_t const size, std::true_type ) {
+					int64_t result = 0;
+					for( size_t n = 0; n < size; ++n ) {
+						if( is_valid( valid, n ) ) {
+							auto const next = checked_add( result, values[n] );
+							if( !next ) {
+								return boost::none;
+							}
+							result = *next;
+						}
+					}
+					return result;
+				}
+
+				/// <summary>Sum in long double, which holds the total of any int64_t column, if not always exactly</summary>
+				template<typename T>
+				long double wide_sum_block( T const * values, uint8_t const * valid, size_t const size ) {
+					long double result = 0;
+					for( size_t n = 0; n < size; ++n ) {
+						if( is_valid( valid, n ) ) {
+							result += static_cast<long double>(values[n]);
+						}
+					}
+					return result;
+				}
+
+				template<typename T>
+				double sum_block( T const * values, uint8_t const * valid, size_t const size, std::false_type ) {
+					double result = 0;
+					size_t n = 0;
+#if defined( __AVX2__ )
+					auto acc = _mm256_setzero_pd( );
+					for( ; n + 4 <= size; n += 4 ) {
+						acc = _mm256_add_pd( acc, _mm256_and_pd( load4( values + n ), mask4( offset( valid, n ) ) ) );
+					}
+					result = horizontal_sum( acc );
+#endif
+					for( ; n < size; ++n ) {
+						if( is_valid( valid, n ) ) {
+							result += static_cast<double>(values[n]);
+						}
+					}
+					return result;
+				}
+
+				/// <summary>Sum of squared deviations from mean, the second pass of the variance</summary>
+				template<typename T>
+				double sum_squared_deviation_block( T const * values, uint8_t const * valid, size_t const size, double const mean ) {
+					double result = 0;
+					size_t n = 0;
+#if defined( __AVX2__ )
+					auto const mean4 = _mm256_set1_pd( mean );
+					auto acc = _mm256_setzero_pd( );
+					for( ; n + 4 <= size; n += 4 ) {
+						auto const deviation = _mm256_and_pd( _mm256_sub_pd( load4( values + n ), mean4 ), mask4( offset( valid, n ) ) );
+						acc = _mm256_add_pd( acc, _mm256_mul_pd( deviation, deviation ) );
+					}
+					result = horizontal_sum( acc );
+#endif
+					for( ; n < size; ++n ) {
+						if( is_valid( valid, n ) ) {
+							auto const deviation = static_cast<double>(values[n]) - mean;
+							result += deviation * deviation;
+						}
+					}
+					return result;
+				}
+
+				/// <summary>Null and NaN rows are replaced by the identity of min/max.  Only meaningful when count > 0</summary>
+				template<typename T>
+				min_max_t<T> min_max_block( T const * values, uint8_t const * valid, size_t const size ) {
+					auto result = min_max_t<T>::identity( );
+					size_t n = 0;
+#if defined( __AVX2__ )
+					// Compare in double and convert back at the end
+					if( simd_exact<T>::value ) {
+						auto const identity_min = _mm256_set1_pd( static_cast<double>(result.min) );
+						auto const identity_max = _mm256_set1_pd( static_cast<double>(result.max) );
+						auto acc_min = identity_min;
+						auto acc_max = identity_max;
+						for( ; n + 4 <= size; n += 4 ) {
+							auto const v = load4( values + n );
+							auto const mask = mask4( offset( valid, n ) );
+							// min_pd/max_pd return the second operand when either is NaN, which skips NaN rows
+							acc_min = _mm256_min_pd( _mm256_blendv_pd( identity_min, v, mask ), acc_min );
+							acc_max = _mm256_max_pd( _mm256_blendv_pd( identity_max, v, mask ), acc_max );
+						}
+						alignas( 32 ) double lanes_min[4];
+						alignas( 32 ) double lanes_max[4];
+						_mm256_store_pd( lanes_min, acc_min );
+						_mm256_store_pd( lanes_max, acc_max );
+						result.min = static_cast<T>(*std::min_element( lanes_min, lanes_min + 4 ));
+						result.max = static_cast<T>(*std::max_element( lanes_max, lanes_max + 4 ));
+					}
+#endif
+					for( ; n < size; ++n ) {
+						if( is_valid( valid, n ) && !is_nan( values[n], std::is_floating_point<T>{ } ) ) {
+							result.min = std::min( result.min, values[n] );
+							result.max = std::max( result.max, values[n] );
+						}
+					}
+					return result;
+				}
+
+				/// <summary>When every non-null value is NaN both are NaN</summary>
+				template<typename T>
+				min_max_t<T> min_max( T const * values, uint8_t const * valid, size_t const size ) {
+					auto result = reduce_blocks( size, min_max_t<T>::identity( ), [&]( size_t first, size_t last ) {
+						return min_max_block( values + first, offset( valid, first ), last - first );
+					}, []( min_max_t<T> const & lhs, min_max_t<T> const & rhs ) {
+						return min_max_t<T>{ std::min( lhs.min, rhs.min ), std::max( lhs.max, rhs.max ) };
+					} );
+					if( std::is_floating_point<T>::value && result.max < result.min ) {	// Still the identity, so nothing but NaN was seen
+						result.min = result.max = std::numeric_limits<T>::quiet_NaN( );
+					}
+					return result;
+				}
+
+				template<typename T>
+				boost::optional<int64_t> checked_sum( T const * values, uint8_t const * valid, size_t const size ) {
+					return reduce_blocks( size, boost::optional<int64_t>{ 0 }, [values, valid]( size_t first, size_t last ) {
+						return sum_block( values + first, offset( valid, first ), last - first, std::true_type{ } );
+					}, []( boost::optional<int64_t> const & lhs, boost::optional<int64_t> const & rhs ) {
+						return checked_add( lhs, rhs );
+					} );
+				}
+
+				/// <summary>The sum as a double for mean and variance.  An integer sum that overflows int64_t is redone in long double</summary>
+				template<typename T>
+				double sum_as_double( T const * values, uint8_t const * valid, size_t const size, std::true_type ) {
+					auto const exact = checked_sum( values, valid, size );
+					if( exact ) {
+						return static_cast<double>(*exact);
+					}
+					return static_cast<double>(reduce_blocks( size, 0.0L, [values, valid]( size_t first, size_t last ) {
+						return wide_sum_block( values + first, offset( valid, first ), last - first );
+					}, []( long double lhs, long double rhs ) {
+						return lhs + rhs;
+					} ));
+				}
+
+				template<typename T>
+				double sum_as_double( T const * values, uint8_t const * valid, size_t const size, std::false_type ) {
+					return reduce_blocks( size, 0.0, [values, valid]( size_t first, size_t last ) {
+						return sum_block( values + first, offset( valid, first ), last - first, std::false_type{ } );
+					}, []( double lhs, double rhs ) {
+						return lhs + rhs;
+					} );
+				}
+
+				template<typename T>
+				accumulator_t<T> sum( T const * values, uint8_t const * valid, size_t const size, std::true_type ) {
+					auto const result = checked_sum( values, valid, size );
+					daw::exception::daw_throw_on_false( static_cast<bool>( result ), "{0}: Integer overflow", __func__ );
+					return *result;
+				}
+
+				template<typename T>
+				accumulator_t<T> sum( T const * values, uint8_t const * valid, size_t const size, std::false_type ) {
+					return sum_as_double( values, valid, size, std::false_type{ } );
+				}
+
+				template<typename T, typename Function>
+				numeric_buffer_t<T> extract( DataTable::value_type const & column, Function to_value ) {
+					numeric_buffer_t<T> result;
+					result.values.resize( column.size( ) );
+					result.valid.resize( column.size( ) );
+					algorithm::parallel_for( 0, column.size( ), [&]( size_t first, size_t last ) {
+						for( auto n = first; n < last; ++n ) {
+							result.valid[n] = to_value( column[n], result.values[n] ) ? 1 : 0;
+						}
+					} );
+					return result;
+				}
+			}	// namespace anonymous
+
+			numeric_buffer_t<integer_t> integer_values( DataTable::value_type const & column ) {
+				return extract<integer_t>( column, []( DataCell const & cell, integer_t & value ) {
+					if( DataCellType::integer != cell.type( ) ) {
+						value = 0;
+						return false;
+					}
+					value = cell.integer( );
+					return true;
+				} );
+			}
+
+			numeric_buffer_t<double> numeric_values( DataTable::value_type const & column ) {
+				return extract<double>( column, []( DataCell const & cell, double & value ) {
+					switch( cell.type( ) ) {
+					case DataCellType::integer:
+						value = static_cast<double>(cell.integer( ));
+						return true;
+					case DataCellType::real:
+						value = static_cast<double>(cell.real( ));
+						return true;
+					case DataCellType::decimal:
+						value = cell.decimal( ).to_double( );
+						return true;
+					default:
+						value = 0;
+						return false;
+					}
+				} );
+			}
+
+			decimal_t decimal_sum( DataTable::value_type const & column ) {
+				return reduce_blocks( column.size( ), decimal_t{ }, [&column]( size_t first, size_t last ) {
+					decimal_t result{ };
+					for( auto n = first; n < last; ++n ) {
+						if( DataCellType::decimal == column[n].type( ) ) {
+							result = result + column[n].decimal( );
+						}
+					}
+					return result;
+				}, []( decimal_t const & lhs, decimal_t const & rhs ) {
+					return lhs + rhs;
+				} );
+			}
+
+			size_t count( uint8_t const * valid, size_t size ) {
+				return reduce_blocks( size, size_t{ 0 }, [valid]( size_t first, size_t last ) {
+					return count_block( offset( valid, first ), last - first );
+				}, []( size_t lhs, size_t rhs ) {
+					return lhs + rhs;
+				} );
+			}
+
+			template<typename T>
+			accumulator_t<T> sum( T const * values, uint8_t const * valid, size_t size ) {
+				return sum( values, valid, size, std::is_integral<T>{ } );
+			}
+
+			template<typename T>
+			boost::optional<T> min( T const * values, uint8_t const * valid, size_t size ) {
+				if( 0 == count( valid, size ) ) {
+					return boost::none;
+				}
+				return min_max( values, valid, size ).min;
+			}
+
+			template<typename T>
+			boost::optional<T> max( T const * values, uint8_t const * valid, size_t size ) {
+				if( 0 == count( valid, size ) ) {
+					return boost::none;
+				}
+				return min_max( values, valid, size ).max;
+			}
+
+			template<typename T>
+			double mean( T const * values, uint8_t const * valid, size_t size ) {
+				auto const n = count( valid, size );
+				if( 0 == n ) {
+					return std::numeric_limits<double>::quiet_NaN( );
+				}
+				return sum_as_double( values, valid, size, std::is_integral<T>{ } ) / static_cast<double>(n);
+			}
+
+			template<typename T>
+			double variance( T const * values, uint8_t const * valid, size_t size ) {
+				auto const n = count( valid, size );
+				if( 2 > n ) {
+					return std::numeric_limits<double>::quiet_NaN( );
+				}
+				auto const average = sum_as_double( values, valid, size, std::is_integral<T>{ } ) / static_cast<double>(n);
+				auto const squared_deviation = reduce_blocks( size, 0.0, [values, valid, average]( size_t first, size_t last ) {
+					return sum_squared_deviation_block( values + first, offset( valid, first ), last - first, average );
+				}, []( double lhs, double rhs ) {
+					return lhs + rhs;
+				} );
+				return squared_deviation / static_cast<double>(n - 1);
+			}
+
+#define DAW_AGGREGATE_INSTANTIATE( T ) \
+			template accumulator_t<T> sum<T>( T const *, uint8_t const *, size_t ); \
+			template boost::optional<T> min<T>( T const *, uint8_t const *, size_t ); \
+			template boost::optional<T> max<T>( T const *, uint8_t const *, size_t ); \
+			template double mean<T>( T const *, uint8_t const *, size_t ); \
+			template double variance<T>( T const *, uint8_t const *, size_t );
+
+			DAW_AGGREGATE_INSTANTIATE( int8_t )
+			DAW_AGGREGATE_INSTANTIATE( int16_t )
+			DAW_AGGREGATE_INSTANTIATE( int32_t )
+			DAW_AGGREGATE_INSTANTIATE( int64_t )
+			DAW_AGGREGATE_INSTANTIATE( float )
+			DAW_AGGREGATE_INSTANTIATE( double )
+
+#undef DAW_AGGREGATE_INSTANTIATE
+		}	// namespace aggregate
+	}	// namespace data
+}	// namespace daw
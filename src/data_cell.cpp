@@ -22,6 +22,7 @@
 
 #include <boost/date_time.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/lexical_cast.hpp>
 #include <cassert>
 #include <ctime>
 #include <exception>
@@ -48,7 +49,7 @@ namespace daw {
 			const std::string s_emptystring = std::string( );
 			const std::string s_default_timestamp_format = "%Y-%m-%d %H:%M:%S %Z";
 
-			DataCellType get_cell_type( daw::cstring & value, std::string locale_str ) {
+			DataCellType get_cell_type( daw::cstring const & value, std::string locale_str ) {
 				// DAW erase
 
 				if( value.is_null( ) ) {
@@ -130,6 +131,7 @@ namespace daw {
 		DataCell::DataCell( integer_t value ) : m_item( std::move( value ) ) { }
 		DataCell::DataCell( real_t value ) : m_item( std::move( value ) ) { }
 		DataCell::DataCell( timestamp_t value ) : m_item( std::move( value ) ) { }
+		DataCell::DataCell( decimal_t value ) : m_item( std::move( value ) ) { }
 
 		DataCell::operator bool( ) const noexcept {
 			return !empty( );
@@ -152,6 +154,9 @@ namespace daw {
 			case DataCellType::timestamp:
 				convertToString( timestamp( ), result );
 				break;
+			case DataCellType::decimal:
+				result = decimal( ).to_string( );
+				break;
 			default:
 				throw daw::exception::FatalError( string_join( __func__, ": Unexpected Error" ) );
 			}
@@ -174,14 +179,24 @@ namespace daw {
 			return m_item.timestamp( );
 		}
 
+		decimal_t DataCell::decimal( ) const {
+			return m_item.decimal( );
+		}
+
 		std::string DataCell::string( ) const {
 			return m_item.string( );
 		}
 
+		boost::string_view DataCell::string_view( ) const noexcept {
+			return m_item.string_view( );
+		}
+
 		real_t DataCell::numeric( ) const {
 			dbg_throw_on_false( daw::data::is_numeric( type( ) ), "Tried to call numeric( ) on a non-numeric datatype" );
 			if( type( ) == DataCellType::real ) {
 				return real( );
+			} else if( type( ) == DataCellType::decimal ) {
+				return decimal( ).to_double( );
 			} else {
 				return static_cast<real_t>(integer( ));
 			}
@@ -191,12 +206,24 @@ namespace daw {
 			return m_item.empty( );
 		}
 
-			DataCell DataCell::from_string( daw::cstring value, std::string locale_str ) {
-			// Check if is integer
-			const auto ct = get_cell_type( value, locale_str );
-			switch( ct ) {
+		DataCell DataCell::from_string( daw::cstring value, std::string locale_str ) {
+			auto const ct = get_cell_type( value, locale_str );
+			return from_string_as( std::move( value ), ct );
+		}
+
+		DataCellType DataCell::detect_type( daw::cstring const & value, std::string locale_str ) {
+			return get_cell_type( value, locale_str );
+		}
+
+		DataCell DataCell::from_string_as( daw::cstring value, DataCellType type ) {
+			switch( type ) {
 			case DataCellType::integer: {
-				return DataCell( boost::lexical_cast<integer_t>(value.get( )) );
+				integer_t result = 0;
+				if( boost::conversion::try_lexical_convert( value.get( ), result ) ) {
+					return DataCell( result );
+				}
+				// Too many digits for integer_t, keep the magnitude
+				return DataCell( boost::lexical_cast<real_t>(value.get( )) );
 			}
 			case DataCellType::real: {
 				return DataCell( boost::lexical_cast<real_t>(value.get( )) );
@@ -208,31 +235,38 @@ namespace daw {
 			}
 			case DataCellType::timestamp:
 				throw daw::exception::NotImplemented( string_join( __func__, ": Use from_time_string( std::string, std::string ) for time/data types" ) );
+			case DataCellType::decimal:
+				throw daw::exception::NotImplemented( string_join( __func__, ": Use from_decimal_string( daw::cstring, uint8_t ) for decimal types" ) );
 			}
 			// This should never happen.  It should default to string
 			throw daw::exception::FatalError( string_join( __func__, ": Could not determine data type in string" ) );
 		}
 
+		DataCell DataCell::from_decimal_string( daw::cstring value, uint8_t scale ) {
+			if( !value.is_null( ) ) {
+				auto result = decimal_t::parse( boost::string_view{ value.get( ), value.size( ) }, scale );
+				if( result ) {
+					return DataCell( *result );
+				}
+			}
+			return from_string( std::move( value ) );
+		}
+
+		DataCell DataCell::borrowed_string( daw::cstring value ) {
+			DataCell result;
+			result.m_item = Variant::borrowed( std::move( value ) );
+			return result;
+		}
+
 		/// See http://www.boost.org/doc/libs/1_55_0/doc/html/date_time/date_time_io.html for formatting info
 		DataCell DataCell::from_time_string( std::string value, std::string format ) {
 			if( 0 == value.size( ) ) {
 				return DataCell( );
 			}
-			static std::stringstream ss;
-			static std::unique_ptr<boost::posix_time::time_input_facet> facet;
-			if( !facet ) {
-				facet = std::make_unique<boost::posix_time::time_input_facet>( 1u );
-				ss.imbue( std::locale( std::locale( ), facet.get( ) ) );
-			}
-			clear( ss );
 			if( format.empty( ) ) {
 				format = s_default_timestamp_format;
 			}
-			facet->format( format.c_str( ) );
-			ss.str( value );
-
-			timestamp_t result;
-			ss >> result;
+			auto const result = daw::string::string_to_ptime( value, format );
 			if( result == boost::posix_time::not_a_date_time ) {
 				throw std::runtime_error( string_join( __func__, ": Format conversion error in from_time_string" ) );
 			}
@@ -253,14 +287,20 @@ namespace daw {
 				return []( DataCell const & A, DataCell const & B ) { return A.timestamp( ) < B.timestamp( ); };
 			}
 
+			cmp_t gen_cmp_decimal( ) {
+				return []( DataCell const & A, DataCell const & B ) { return A.decimal( ) < B.decimal( ); };
+			}
+
 			cmp_t gen_cmp_other( ) {
-				return []( DataCell const & A, DataCell const & B ) { return A.to_string( ).compare( B.to_string( ) ) < 0;  };
+				// Empty cells give an empty view, so string and empty_string pairs compare without allocating
+				return []( DataCell const & A, DataCell const & B ) { return A.string_view( ).compare( B.string_view( ) ) < 0; };
 			}
 		}
 
 		const std::function<bool( DataCell const &, DataCell const & )> DataCell::cmp_integer = gen_cmp_integer( );
 		const std::function<bool( DataCell const &, DataCell const & )> DataCell::cmp_real = gen_cmp_real( );
 		const std::function<bool( DataCell const &, DataCell const & )> DataCell::cmp_timestamp = gen_cmp_timestamp( );
+		const std::function<bool( DataCell const &, DataCell const & )> DataCell::cmp_decimal = gen_cmp_decimal( );
 		const std::function<bool( DataCell const &, DataCell const & )> DataCell::cmp_other = gen_cmp_other( );
 
 		const std::function<bool( DataCell const &, DataCell const & )> DataCell::get_compare( DataCell const & cell ) {
@@ -271,6 +311,8 @@ namespace daw {
 				return cmp_real;
 			case DataCellType::timestamp:
 				return cmp_timestamp;
+			case DataCellType::decimal:
+				return cmp_decimal;
 			case DataCellType::empty_string:
 			case DataCellType::string:
 			default:
@@ -282,6 +324,14 @@ namespace daw {
 			return Variant::compare( lhs.m_item, rhs.m_item );
 		}
 
+		bool DataCell::equal( DataCell const & lhs, DataCell const & rhs ) {
+			return Variant::equal( lhs.m_item, rhs.m_item );
+		}
+
+		std::size_t DataCell::hash( ) const {
+			return m_item.hash( );
+		}
+
 		bool DataCell::operator==(DataCell const & rhs) const {
 			return compare( *this, rhs ) == 0;
 		}
@@ -307,7 +357,7 @@ namespace daw {
 		}
 
 		bool is_numeric( daw::data::DataCellType const & ct ) {
-			return daw::data::DataCellType::integer == ct || daw::data::DataCellType::real == ct;
+			return daw::data::DataCellType::integer == ct || daw::data::DataCellType::real == ct || daw::data::DataCellType::decimal == ct;
 		}
 
 		bool is_numeric( daw::data::DataCell const & value ) {
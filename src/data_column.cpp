@@ -30,14 +30,27 @@
 
 namespace daw {
 	namespace data {
-		void convert_column_to_timestamp( DataColumn<std::vector<DataCell>> & column, bool is_nullable, boost::string_view format ) {
-			std::transform( column.begin( ), column.end( ), column.begin( ), [format, is_nullable]( DataCell const & cell ) -> daw::data::DataCell {
-				if( cell.empty( ) && is_nullable ) {
-					return cell;
-				}
-				return DataCell::from_time_string( cell.string( ), format.to_string( ) );
-			} );			
-		}	
+		namespace {
+			template<typename Column>
+			void convert_cells_to_timestamp( Column & column, bool is_nullable, boost::string_view format ) {
+				std::transform( column.begin( ), column.end( ), column.begin( ), [format, is_nullable]( DataCell const & cell ) -> daw::data::DataCell {
+					if( cell.empty( ) && is_nullable ) {
+						return cell;
+					}
+					return DataCell::from_time_string( cell.string( ), format.to_string( ) );
+				} );
+			}
+		}	// namespace anonymous
+
+		void convert_column_to_timestamp( DataColumnDense & column, bool is_nullable, boost::string_view format ) {
+			convert_cells_to_timestamp( column, is_nullable, format );
+			column.refresh_stats( );
+		}
+
+		void convert_column_to_timestamp( DataColumnSparse & column, bool is_nullable, boost::string_view format ) {
+			convert_cells_to_timestamp( column, is_nullable, format );	// Assigning the cells keeps a sparse column sparse
+			column.refresh_stats( );
+		}
 	}
 }
 
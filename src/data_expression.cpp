@@ -0,0 +1,557 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+#include <daw/daw_exception.h>
+
+#include "data_algorithms.h"
+#include "data_expression.h"
+
+namespace daw {
+	namespace data {
+		namespace expression {
+			namespace impl {
+				enum class op_t: uint8_t {
+					column, literal,
+					add, subtract, multiply, divide, negate,
+					equal, not_equal, less, less_equal, greater, greater_equal,
+					logical_and, logical_or, logical_not
+				};
+
+				struct node_t {
+					op_t op;
+					std::string name;	// column
+					size_t lag;	// column
+					bool is_real;	// literal
+					int64_t integer;	// literal
+					double real;	// literal
+					std::shared_ptr<node_t const> lhs;
+					std::shared_ptr<node_t const> rhs;
+
+					explicit node_t( op_t oper ) noexcept:
+							op{ oper },
+							name{ },
+							lag{ 0 },
+							is_real{ false },
+							integer{ 0 },
+							real{ 0 },
+							lhs{ },
+							rhs{ } { }
+				};
+			}	// namespace impl
+
+			namespace {
+				using impl::node_t;
+				using impl::op_t;
+
+				/// <summary>Rows evaluated at a time.  Keeps the typed buffers of a whole expression in cache</summary>
+				constexpr size_t batch_size = 1024;
+
+				expression_t make_unary( op_t op, expression_t const & value ) {
+					auto node = std::make_shared<node_t>( op );
+					node->lhs = value.node( );
+					return expression_t{ std::move( node ) };
+				}
+
+				expression_t make_binary( op_t op, expression_t const & lhs, expression_t const & rhs ) {
+					auto node = std::make_shared<node_t>( op );
+					node->lhs = lhs.node( );
+					node->rhs = rhs.node( );
+					return expression_t{ std::move( node ) };
+				}
+
+				/// <summary>Typed values of one node for one batch.  Boolean results are integers of 0 or 1</summary>
+				struct batch_t {
+					bool is_real = false;
+					std::vector<int64_t> integers;
+					std::vector<double> reals;
+					std::vector<uint8_t> valid;
+
+					size_t size( ) const noexcept {
+						return valid.size( );
+					}
+
+					void resize( size_t count ) {
+						integers.resize( count );
+						reals.resize( count );
+						valid.resize( count );
+					}
+
+					void to_real( ) {
+						if( !is_real ) {
+							std::transform( integers.begin( ), integers.end( ), reals.begin( ), []( int64_t value ) {
+								return static_cast<double>(value);
+							} );
+							is_real = true;
+						}
+					}
+
+					void to_boolean( ) {
+						if( is_real ) {
+							std::transform( reals.begin( ), reals.end( ), integers.begin( ), []( double value ) -> int64_t {
+								return 0 != value ? 1 : 0;
+							} );
+							is_real = false;
+						} else {
+							std::transform( integers.begin( ), integers.end( ), integers.begin( ), []( int64_t value ) -> int64_t {
+								return 0 != value ? 1 : 0;
+							} );
+						}
+					}
+				};
+
+				// Column access is the same for a DataTable and a TableView after binding
+				DataTable::value_type const * find_column( DataTable const & table, std::string const & name ) {
+					return &table[name];
+				}
+
+				ColumnView find_column( TableView const & table, std::string const & name ) {
+					return table[name];
+				}
+
+				DataCell const & cell_at( DataTable::value_type const * column, size_t row ) {
+					return (*column)[row];
+				}
+
+				DataCell const & cell_at( ColumnView const & column, size_t row ) {
+					return column[row];
+				}
+
+				size_t row_count( DataTable const & table ) noexcept {
+					return table.empty( ) ? 0 : table[0].size( );
+				}
+
+				size_t row_count( TableView const & table ) noexcept {
+					return table.row_count( );
+				}
+
+				template<typename Table>
+				using column_ref_t = decltype( find_column( std::declval<Table const &>( ), std::string{ } ) );
+
+				DataTable::value_type const & whole_column( DataTable::value_type const * column ) noexcept {
+					return *column;
+				}
+
+				DataTable::value_type const & whole_column( ColumnView const & column ) noexcept {
+					return column.parent( );
+				}
+
+				template<typename Table>
+				struct binding_t {
+					column_ref_t<Table> column;
+					bool is_real;	// Loaded as reals in every batch when the column has any real or decimal cell
+				};
+
+				template<typename Table>
+				using bindings_t = std::unordered_map<node_t const *, binding_t<Table>>;
+
+				/// <summary>Resolve every column reference, and the type it loads as, once before evaluation</summary>
+				template<typename Table>
+				void bind( node_t const & node, Table const & table, bindings_t<Table> & bindings ) {
+					if( op_t::column == node.op ) {
+						auto column = find_column( table, node.name );
+						auto const & stats = whole_column( column ).stats( );
+						auto const is_real = 0 < stats.type_count( DataCellType::real ) + stats.type_count( DataCellType::decimal );
+						bindings.emplace( &node, binding_t<Table>{ std::move( column ), is_real } );
+					}
+					if( node.lhs ) {
+						bind( *node.lhs, table, bindings );
+					}
+					if( node.rhs ) {
+						bind( *node.rhs, table, bindings );
+					}
+				}
+
+				int64_t to_microseconds( timestamp_t const & value ) {
+					static boost::posix_time::ptime const epoch{ boost::gregorian::date{ 1970, 1, 1 } };
+					return (value - epoch).total_microseconds( );
+				}
+
+				template<typename Column>
+				void load_column( Column const & column, bool const is_real, size_t const lag, size_t const first, batch_t & out ) {
+					for( size_t n = 0; n < out.size( ); ++n ) {
+						out.valid[n] = 0;
+						auto const row = first + n;
+						if( row < lag ) {
+							continue;
+						}
+						auto const & cell = cell_at( column, row - lag );
+						switch( cell.type( ) ) {
+						case DataCellType::integer:
+							out.integers[n] = cell.integer( );
+							out.reals[n] = static_cast<double>(out.integers[n]);
+							out.valid[n] = 1;
+							break;
+						case DataCellType::real:
+							out.reals[n] = static_cast<double>(cell.real( ));
+							out.valid[n] = 1;
+							break;
+						case DataCellType::decimal:
+							out.reals[n] = cell.decimal( ).to_double( );
+							out.valid[n] = 1;
+							break;
+						case DataCellType::timestamp:
+							if( !cell.timestamp( ).is_special( ) ) {
+								out.integers[n] = to_microseconds( cell.timestamp( ) );
+								out.reals[n] = static_cast<double>(out.integers[n]);
+								out.valid[n] = 1;
+							}
+							break;
+						default:
+							break;
+						}
+					}
+					out.is_real = is_real;
+				}
+
+				void load_literal( node_t const & node, batch_t & out ) {
+					std::fill( out.valid.begin( ), out.valid.end( ), 1 );
+					out.is_real = node.is_real;
+					if( node.is_real ) {
+						std::fill( out.reals.begin( ), out.reals.end( ), node.real );
+					} else {
+						std::fill( out.integers.begin( ), out.integers.end( ), node.integer );
+					}
+				}
+
+				void merge_valid( batch_t & lhs, batch_t const & rhs ) {
+					for( size_t n = 0; n < lhs.size( ); ++n ) {
+						lhs.valid[n] &= rhs.valid[n];
+					}
+				}
+
+				/// <summary>lhs = op( lhs, rhs ), in integers when both sides are integers.  integer_op( a, b, &result ) returns
+				/// true when the result does not fit in int64_t, and that row is null</summary>
+				template<typename IntegerOperator, typename RealOperator>
+				void arithmetic( batch_t & lhs, batch_t & rhs, IntegerOperator integer_op, RealOperator real_op ) {
+					merge_valid( lhs, rhs );
+					if( !lhs.is_real && !rhs.is_real ) {
+						for( size_t n = 0; n < lhs.size( ); ++n ) {
+							if( integer_op( lhs.integers[n], rhs.integers[n], &lhs.integers[n] ) ) {
+								lhs.valid[n] = 0;
+							}
+						}
+						return;
+					}
+					lhs.to_real( );
+					rhs.to_real( );
+					for( size_t n = 0; n < lhs.size( ); ++n ) {
+						lhs.reals[n] = real_op( lhs.reals[n], rhs.reals[n] );
+					}
+				}
+
+				void divide( batch_t & lhs, batch_t & rhs ) {
+					merge_valid( lhs, rhs );
+					lhs.to_real( );
+					rhs.to_real( );
+					for( size_t n = 0; n < lhs.size( ); ++n ) {
+						lhs.valid[n] &= 0 != rhs.reals[n] ? 1 : 0;
+						lhs.reals[n] = 0 != rhs.reals[n] ? lhs.reals[n] / rhs.reals[n] : 0;
+					}
+				}
+
+				/// <summary>lhs = op( lhs, rhs ) as 0 or 1</summary>
+				template<typename Operator>
+				void comparison( batch_t & lhs, batch_t & rhs, Operator op ) {
+					merge_valid( lhs, rhs );
+					if( !lhs.is_real && !rhs.is_real ) {
+						for( size_t n = 0; n < lhs.size( ); ++n ) {
+							lhs.integers[n] = op( lhs.integers[n], rhs.integers[n] ) ? 1 : 0;
+						}
+						return;
+					}
+					lhs.to_real( );
+					rhs.to_real( );
+					for( size_t n = 0; n < lhs.size( ); ++n ) {
+						lhs.integers[n] = op( lhs.reals[n], rhs.reals[n] ) ? 1 : 0;
+					}
+					lhs.is_real = false;
+				}
+
+				template<typename Operator>
+				void logical( batch_t & lhs, batch_t & rhs, Operator op ) {
+					merge_valid( lhs, rhs );
+					lhs.to_boolean( );
+					rhs.to_boolean( );
+					for( size_t n = 0; n < lhs.size( ); ++n ) {
+						lhs.integers[n] = op( lhs.integers[n], rhs.integers[n] );
+					}
+				}
+
+				struct scratch_t {
+					std::deque<batch_t> batches;	// deque so references survive growth
+					size_t depth = 0;
+				};
+
+				template<typename Table>
+				void evaluate( node_t const & node, bindings_t<Table> const & bindings, size_t const first, batch_t & out, scratch_t & scratch ) {
+					switch( node.op ) {
+					case op_t::column: {
+						auto const & binding = bindings.at( &node );
+						load_column( binding.column, binding.is_real, node.lag, first, out );
+						return;
+					}
+					case op_t::literal:
+						load_literal( node, out );
+						return;
+					case op_t::negate:
+						evaluate<Table>( *node.lhs, bindings, first, out, scratch );
+						if( out.is_real ) {
+							std::transform( out.reals.begin( ), out.reals.end( ), out.reals.begin( ), []( double value ) { return -value; } );
+						} else {
+							for( size_t n = 0; n < out.size( ); ++n ) {
+								if( __builtin_sub_overflow( int64_t{ 0 }, out.integers[n], &out.integers[n] ) ) {
+									out.valid[n] = 0;
+								}
+							}
+						}
+						return;
+					case op_t::logical_not:
+						evaluate<Table>( *node.lhs, bindings, first, out, scratch );
+						out.to_boolean( );
+						std::transform( out.integers.begin( ), out.integers.end( ), out.integers.begin( ), []( int64_t value ) -> int64_t { return 1 - value; } );
+						return;
+					default:
+						break;
+					}
+
+					// Binary operators evaluate the right side into a scratch batch reused across batches
+					evaluate<Table>( *node.lhs, bindings, first, out, scratch );
+					if( scratch.batches.size( ) <= scratch.depth ) {
+						scratch.batches.emplace_back( );
+					}
+					auto & rhs = scratch.batches[scratch.depth];
+					rhs.resize( out.size( ) );
+					++scratch.depth;
+					evaluate<Table>( *node.rhs, bindings, first, rhs, scratch );
+					--scratch.depth;
+
+					switch( node.op ) {
+					case op_t::add:
+						arithmetic( out, rhs, []( int64_t a, int64_t b, int64_t * result ) { return __builtin_add_overflow( a, b, result ); }, []( double a, double b ) { return a + b; } );
+						break;
+					case op_t::subtract:
+						arithmetic( out, rhs, []( int64_t a, int64_t b, int64_t * result ) { return __builtin_sub_overflow( a, b, result ); }, []( double a, double b ) { return a - b; } );
+						break;
+					case op_t::multiply:
+						arithmetic( out, rhs, []( int64_t a, int64_t b, int64_t * result ) { return __builtin_mul_overflow( a, b, result ); }, []( double a, double b ) { return a * b; } );
+						break;
+					case op_t::divide:
+						divide( out, rhs );
+						break;
+					case op_t::equal:
+						comparison( out, rhs, []( auto a, auto b ) { return a == b; } );
+						break;
+					case op_t::not_equal:
+						comparison( out, rhs, []( auto a, auto b ) { return a != b; } );
+						break;
+					case op_t::less:
+						comparison( out, rhs, []( auto a, auto b ) { return a < b; } );
+						break;
+					case op_t::less_equal:
+						comparison( out, rhs, []( auto a, auto b ) { return a <= b; } );
+						break;
+					case op_t::greater:
+						comparison( out, rhs, []( auto a, auto b ) { return a > b; } );
+						break;
+					case op_t::greater_equal:
+						comparison( out, rhs, []( auto a, auto b ) { return a >= b; } );
+						break;
+					case op_t::logical_and:
+						logical( out, rhs, []( int64_t a, int64_t b ) { return a & b; } );
+						break;
+					case op_t::logical_or:
+						logical( out, rhs, []( int64_t a, int64_t b ) { return a | b; } );
+						break;
+					default:
+						throw daw::exception::AssertException( "Unexpected expression operator.  This should never happen" );
+					}
+				}
+
+				/// <summary>Evaluate expr a batch at a time, in parallel across blocks of batches, calling on_batch( first_row, batch )</summary>
+				template<typename Table, typename Function>
+				void for_each_batch( Table const & table, expression_t const & expr, Function on_batch ) {
+					bindings_t<Table> bindings;
+					bind( *expr.node( ), table, bindings );
+					auto const rows = row_count( table );
+					auto const batch_count = (rows + batch_size - 1) / batch_size;
+					algorithm::parallel_for( 0, batch_count, [&]( size_t first_batch, size_t last_batch ) {
+						batch_t batch;
+						scratch_t scratch;
+						for( auto n = first_batch; n < last_batch; ++n ) {
+							auto const first = n * batch_size;
+							batch.resize( std::min( rows, first + batch_size ) - first );
+							evaluate<Table>( *expr.node( ), bindings, first, batch, scratch );
+							on_batch( first, batch );
+						}
+					} );
+				}
+
+				DataCell to_cell( batch_t const & batch, size_t n ) {
+					if( 0 == batch.valid[n] ) {
+						return DataCell{ };
+					}
+					if( batch.is_real ) {
+						return DataCell{ static_cast<real_t>(batch.reals[n]) };
+					}
+					return DataCell{ static_cast<integer_t>(batch.integers[n]) };
+				}
+
+				template<typename Table>
+				DataTable::value_type evaluate_column_impl( Table const & table, expression_t const & expr, std::string header ) {
+					std::vector<DataCell> cells( row_count( table ) );
+					for_each_batch( table, expr, [&cells]( size_t first, batch_t const & batch ) {
+						for( size_t n = 0; n < batch.size( ); ++n ) {
+							cells[first + n] = to_cell( batch, n );
+						}
+					} );
+					DataTable::value_type result{ std::move( header ) };
+					result.reserve( cells.size( ) );
+					for( auto & cell : cells ) {
+						result.append( std::move( cell ) );
+					}
+					return result;
+				}
+
+				template<typename Table>
+				std::vector<uint8_t> evaluate_filter_impl( Table const & table, expression_t const & expr ) {
+					std::vector<uint8_t> result( row_count( table ), 0 );
+					for_each_batch( table, expr, [&result]( size_t first, batch_t const & batch ) {
+						for( size_t n = 0; n < batch.size( ); ++n ) {
+							auto const truthy = batch.is_real ? 0 != batch.reals[n] : 0 != batch.integers[n];
+							result[first + n] = 0 != batch.valid[n] && truthy ? 1 : 0;
+						}
+					} );
+					return result;
+				}
+			}	// namespace anonymous
+
+			expression_t::expression_t( std::shared_ptr<impl::node_t const> node ) noexcept: m_node{ std::move( node ) } { }
+
+			std::shared_ptr<impl::node_t const> const & expression_t::node( ) const noexcept {
+				return m_node;
+			}
+
+			expression_t column( std::string name ) {
+				return lag( std::move( name ), 0 );
+			}
+
+			expression_t lag( std::string name, size_t count ) {
+				auto node = std::make_shared<node_t>( op_t::column );
+				node->name = std::move( name );
+				node->lag = count;
+				return expression_t{ std::move( node ) };
+			}
+
+			expression_t literal( int64_t value ) {
+				auto node = std::make_shared<node_t>( op_t::literal );
+				node->integer = value;
+				return expression_t{ std::move( node ) };
+			}
+
+			expression_t literal( double value ) {
+				auto node = std::make_shared<node_t>( op_t::literal );
+				node->is_real = true;
+				node->real = value;
+				return expression_t{ std::move( node ) };
+			}
+
+			expression_t operator+( expression_t const & lhs, expression_t const & rhs ) {
+				return make_binary( op_t::add, lhs, rhs );
+			}
+
+			expression_t operator-( expression_t const & lhs, expression_t const & rhs ) {
+				return make_binary( op_t::subtract, lhs, rhs );
+			}
+
+			expression_t operator*( expression_t const & lhs, expression_t const & rhs ) {
+				return make_binary( op_t::multiply, lhs, rhs );
+			}
+
+			expression_t operator/( expression_t const & lhs, expression_t const & rhs ) {
+				return make_binary( op_t::divide, lhs, rhs );
+			}
+
+			expression_t operator-( expression_t const & value ) {
+				return make_unary( op_t::negate, value );
+			}
+
+			expression_t operator==( expression_t const & lhs, expression_t const & rhs ) {
+				return make_binary( op_t::equal, lhs, rhs );
+			}
+
+			expression_t operator!=( expression_t const & lhs, expression_t const & rhs ) {
+				return make_binary( op_t::not_equal, lhs, rhs );
+			}
+
+			expression_t operator<( expression_t const & lhs, expression_t const & rhs ) {
+				return make_binary( op_t::less, lhs, rhs );
+			}
+
+			expression_t operator<=( expression_t const & lhs, expression_t const & rhs ) {
+				return make_binary( op_t::less_equal, lhs, rhs );
+			}
+
+			expression_t operator>( expression_t const & lhs, expression_t const & rhs ) {
+				return make_binary( op_t::greater, lhs, rhs );
+			}
+
+			expression_t operator>=( expression_t const & lhs, expression_t const & rhs ) {
+				return make_binary( op_t::greater_equal, lhs, rhs );
+			}
+
+			expression_t operator&&( expression_t const & lhs, expression_t const & rhs ) {
+				return make_binary( op_t::logical_and, lhs, rhs );
+			}
+
+			expression_t operator||( expression_t const & lhs, expression_t const & rhs ) {
+				return make_binary( op_t::logical_or, lhs, rhs );
+			}
+
+			expression_t operator!( expression_t const & value ) {
+				return make_unary( op_t::logical_not, value );
+			}
+
+			DataTable::value_type evaluate_column( DataTable const & table, expression_t const & expr, std::string header ) {
+				return evaluate_column_impl( table, expr, std::move( header ) );
+			}
+
+			DataTable::value_type evaluate_column( TableView const & table, expression_t const & expr, std::string header ) {
+				return evaluate_column_impl( table, expr, std::move( header ) );
+			}
+
+			std::vector<uint8_t> evaluate_filter( DataTable const & table, expression_t const & expr ) {
+				return evaluate_filter_impl( table, expr );
+			}
+
+			std::vector<uint8_t> evaluate_filter( TableView const & table, expression_t const & expr ) {
+				return evaluate_filter_impl( table, expr );
+			}
+		}	// namespace expression
+	}	// namespace data
+}	// namespace daw
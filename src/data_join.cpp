@@ -0,0 +1,337 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <boost/functional/hash.hpp>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <daw/daw_exception.h>
+
+#include "data_algorithms.h"
+#include "data_join.h"
+#include "decimal.h"
+
+namespace daw {
+	namespace data {
+		namespace algorithm {
+			namespace {
+				using size_type = DataTable::size_type;
+				using column_refs_t = std::vector<DataTable::value_type const *>;
+				using match_t = std::pair<size_type, size_type>;
+				using hash_table_t = std::unordered_multimap<size_t, size_type>;
+
+				constexpr size_type no_match = std::numeric_limits<size_type>::max( );
+
+				size_type row_count( DataTable const & table ) {
+					return table.empty( ) ? 0 : table[0].size( );
+				}
+
+				/// <summary>integer, real and decimal keys match by value, so each is compared as a decimal_t when it is one.
+				/// A real with no decimal equal, e.g. 1e300, only matches an equal real</summary>
+				boost::optional<decimal_t> numeric_key( DataCell const & cell );
+
+				/// <summary>The key columns of one side of the join.  The numeric_key of every cell is worked out once up front as
+				/// the probe compares a row with each candidate in its bucket</summary>
+				class join_keys_t {
+					column_refs_t m_columns;
+					std::vector<std::vector<boost::optional<decimal_t>>> m_numbers;	// [key][row]
+				public:
+					join_keys_t( DataTable const & table, std::vector<std::string> const & keys, size_type const rows ):
+							m_columns{ },
+							m_numbers( keys.size( ) ) {
+
+						m_columns.reserve( keys.size( ) );
+						for( auto const & key : keys ) {
+							m_columns.push_back( &table[key] );
+						}
+						for( auto & numbers : m_numbers ) {
+							numbers.resize( rows );
+						}
+						parallel_for( 0, rows, [&]( size_t first, size_t last ) {
+							for( size_t key = 0; key < m_columns.size( ); ++key ) {
+								auto const & column = *m_columns[key];
+								auto & numbers = m_numbers[key];
+								for( auto row = first; row < last; ++row ) {
+									numbers[row] = numeric_key( column[row] );
+								}
+							}
+						} );
+					}
+
+					column_refs_t const & columns( ) const noexcept {
+						return m_columns;
+					}
+
+					size_t size( ) const noexcept {
+						return m_columns.size( );
+					}
+
+					DataCell const & cell( size_t const key, size_type const row ) const {
+						return (*m_columns[key])[row];
+					}
+
+					boost::optional<decimal_t> const & number( size_t const key, size_type const row ) const {
+						return m_numbers[key][row];
+					}
+
+					bool has_empty_key( size_type const row ) const {
+						for( size_t key = 0; key < size( ); ++key ) {
+							if( !number( key, row ) && cell( key, row ).empty( ) ) {
+								return true;
+							}
+						}
+						return false;
+					}
+
+					size_t hash_row( size_type const row ) const {
+						size_t result = 0;
+						for( size_t key = 0; key < size( ); ++key ) {
+							auto const & value = number( key, row );
+							boost::hash_combine( result, value ? value->hash( ) : cell( key, row ).hash( ) );	// Equal numbers hash the same whatever their scale
+						}
+						return result;
+					}
+				};
+
+				/// <summary>The decimal equal to value or none when there is none within decimal_t's range and scale</summary>
+				boost::optional<decimal_t> exact_decimal( real_t const value ) {
+					if( !std::isfinite( value ) ) {
+						return boost::none;
+					}
+					if( std::trunc( value ) == value ) {
+						if( -9223372036854775808.0 <= value && value < 9223372036854775808.0 ) {
+							return decimal_t{ static_cast<int64_t>(value), 0 };
+						}
+						return boost::none;
+					}
+					// Past 2^53 units no longer convert to real_t exactly, so the round trip check below could pass wrongly
+					constexpr real_t const max_exact_units = 9007199254740992.0;
+					real_t pow10 = 1.0;
+					for( uint8_t scale = 0; scale <= decimal_t::max_scale; ++scale, pow10 *= 10.0 ) {
+						auto const units = std::round( value * pow10 );
+						if( std::abs( units ) > max_exact_units ) {
+							break;
+						}
+						if( units / pow10 == value ) {
+							return decimal_t{ static_cast<int64_t>(units), scale };
+						}
+					}
+					return boost::none;
+				}
+
+				boost::optional<decimal_t> numeric_key( DataCell const & cell ) {
+					switch( cell.type( ) ) {
+					case DataCellType::integer:
+						return decimal_t{ cell.integer( ), 0 };
+					case DataCellType::decimal:
+						return cell.decimal( );
+					case DataCellType::real:
+						return exact_decimal( cell.real( ) );
+					default:
+						return boost::none;
+					}
+				}
+
+				bool keys_equal( join_keys_t const & lhs, size_type const lhs_row, join_keys_t const & rhs, size_type const rhs_row ) {
+					for( size_t key = 0; key < lhs.size( ); ++key ) {
+						auto const & lhs_number = lhs.number( key, lhs_row );
+						auto const & rhs_number = rhs.number( key, rhs_row );
+						if( lhs_number && rhs_number ) {
+							if( *lhs_number != *rhs_number ) {
+								return false;
+							}
+						} else if( lhs_number || rhs_number || !DataCell::equal( lhs.cell( key, lhs_row ), rhs.cell( key, rhs_row ) ) ) {
+							return false;
+						}
+					}
+					return true;
+				}
+
+				/// <summary>Use the high bits so partitions are independent of the bucket chosen inside each hash table</summary>
+				size_t partition_of( size_t const hash, size_t const partition_count ) noexcept {
+					return static_cast<size_t>((static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ULL) >> 32) % partition_count;
+				}
+
+				/// <summary>Radix partition the build rows by key hash, then build one hash table per partition in parallel</summary>
+				std::vector<hash_table_t> build_partitions( join_keys_t const & keys, size_type const rows ) {
+					auto const partition_count = impl::thread_count( );
+					std::vector<size_t> hashes( rows );
+					std::vector<uint8_t> valid( rows );
+					parallel_for( 0, rows, [&]( size_t first, size_t last ) {
+						for( auto row = first; row < last; ++row ) {
+							valid[row] = keys.has_empty_key( row ) ? 0 : 1;
+							if( valid[row] ) {
+								hashes[row] = keys.hash_row( row );
+							}
+						}
+					} );
+
+					// counts and offsets are laid out [block][partition]
+					std::vector<size_type> offsets( partition_count * partition_count, 0 );
+					impl::parallel_blocks( rows, [&]( size_t block, size_t first, size_t last ) {
+						auto const block_offsets = &offsets[block * partition_count];
+						for( auto row = first; row < last; ++row ) {
+							if( valid[row] ) {
+								++block_offsets[partition_of( hashes[row], partition_count )];
+							}
+						}
+					}, partition_count );
+
+					std::vector<size_type> partition_first( partition_count + 1, 0 );
+					size_type total = 0;
+					for( size_t partition = 0; partition < partition_count; ++partition ) {
+						partition_first[partition] = total;
+						for( size_t block = 0; block < partition_count; ++block ) {
+							auto & offset = offsets[block * partition_count + partition];
+							auto const count = offset;
+							offset = total;
+							total += count;
+						}
+					}
+					partition_first[partition_count] = total;
+
+					std::vector<size_type> partitioned_rows( total );
+					impl::parallel_blocks( rows, [&]( size_t block, size_t first, size_t last ) {
+						auto const block_offsets = &offsets[block * partition_count];
+						for( auto row = first; row < last; ++row ) {
+							if( valid[row] ) {
+								partitioned_rows[block_offsets[partition_of( hashes[row], partition_count )]++] = row;
+							}
+						}
+					}, partition_count );
+
+					std::vector<hash_table_t> result( partition_count );
+					parallel_for( 0, partition_count, [&]( size_t first, size_t last ) {
+						for( auto partition = first; partition < last; ++partition ) {
+							auto & table = result[partition];
+							table.reserve( partition_first[partition + 1] - partition_first[partition] );
+							for( auto n = partition_first[partition]; n < partition_first[partition + 1]; ++n ) {
+								auto const row = partitioned_rows[n];
+								table.emplace( hashes[row], row );
+							}
+						}
+					} );
+					return result;
+				}
+
+				std::vector<match_t> probe( join_keys_t const & probe_keys, size_type const rows, join_keys_t const & build_keys, std::vector<hash_table_t> const & tables, join_type const type ) {
+					std::vector<std::vector<match_t>> block_matches( impl::thread_count( ) );
+					auto const block_count = impl::parallel_blocks( rows, [&]( size_t block, size_t first, size_t last ) {
+						auto & matches = block_matches[block];
+						for( auto row = first; row < last; ++row ) {
+							bool found = false;
+							if( !probe_keys.has_empty_key( row ) ) {
+								auto const hash = probe_keys.hash_row( row );
+								auto const range = tables[partition_of( hash, tables.size( ) )].equal_range( hash );
+								for( auto it = range.first; it != range.second; ++it ) {
+									if( keys_equal( probe_keys, row, build_keys, it->second ) ) {
+										found = true;
+										if( join_type::semi == type ) {
+											break;
+										}
+										matches.emplace_back( row, it->second );
+									}
+								}
+							}
+							if( (found && join_type::semi == type) || (!found && join_type::left == type) ) {
+								matches.emplace_back( row, no_match );
+							}
+						}
+					}, block_matches.size( ) );
+
+					size_t total = 0;
+					for( size_t block = 0; block < block_count; ++block ) {
+						total += block_matches[block].size( );
+					}
+					std::vector<match_t> result;
+					result.reserve( total );
+					for( size_t block = 0; block < block_count; ++block ) {
+						result.insert( result.end( ), block_matches[block].begin( ), block_matches[block].end( ) );
+					}
+					return result;
+				}
+			}	// namespace anonymous
+
+			DataTable hash_join( DataTable const & left, DataTable const & right, std::vector<std::string> const & left_keys, std::vector<std::string> const & right_keys, join_type type ) {
+				using namespace daw::exception;
+				daw_throw_on_true( left_keys.empty( ), "{0}: At least one key column is required", __func__ );
+				daw_throw_on_false( left_keys.size( ) == right_keys.size( ), "{0}: left_keys and right_keys must be the same size", __func__ );
+
+				join_keys_t const probe_keys{ left, left_keys, row_count( left ) };
+				join_keys_t const build_keys{ right, right_keys, row_count( right ) };
+				auto const tables = build_partitions( build_keys, row_count( right ) );
+				auto const matches = probe( probe_keys, row_count( left ), build_keys, tables, type );
+
+				// Output columns as (source column, gather from right side)
+				std::vector<std::pair<DataTable::value_type const *, bool>> sources;
+				for( auto const & column : left ) {
+					sources.emplace_back( &column, false );
+				}
+				if( join_type::semi != type ) {
+					for( auto const & column : right ) {
+						if( std::find( build_keys.columns( ).begin( ), build_keys.columns( ).end( ), &column ) == build_keys.columns( ).end( ) ) {
+							sources.emplace_back( &column, true );
+						}
+					}
+				}
+
+				// Non-key columns named the same on both sides are told apart by a left. or right. prefix
+				std::vector<std::string> headers;
+				for( auto const & source : sources ) {
+					auto const & header = source.first->header( );
+					auto const clashes = std::count_if( sources.begin( ), sources.end( ), [&]( auto const & other ) {
+						return other.second != source.second && other.first->header( ) == header;
+					} );
+					headers.push_back( 0 == clashes ? header : (source.second ? "right." : "left.") + header );
+				}
+
+				std::vector<DataTable::value_type> columns( sources.size( ) );
+				parallel_for( 0, sources.size( ), [&]( size_t first, size_t last ) {
+					for( auto n = first; n < last; ++n ) {
+						auto const & source = *sources[n].first;
+						auto const from_right = sources[n].second;
+						DataTable::value_type column{ headers[n] };
+						column.reserve( matches.size( ) );
+						for( auto const & match : matches ) {
+							auto const row = from_right ? match.second : match.first;
+							column.append( no_match == row ? DataCell{ } : source[row] );
+						}
+						columns[n] = std::move( column );
+					}
+				} );
+
+				DataTable result;
+				for( auto & column : columns ) {
+					result.append( std::move( column ) );
+				}
+				return result;
+			}
+		}	// namespace algorithm
+	}	// namespace data
+}	// namespace daw
@@ -0,0 +1,220 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <boost/align/aligned_alloc.hpp>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <vector>
+
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#endif
+
+#include <daw/daw_exception.h>
+
+#include "data_algorithms.h"
+#include "data_matrix.h"
+
+namespace daw {
+	namespace data {
+		namespace {
+			constexpr size_t const row_block_size = 65536;
+			constexpr size_t const stage_size = 1024;
+
+			/// <summary>One stage of cells split so the integers can be converted together.  There is no AVX2 conversion from
+			/// 64 bit integers so only those that fit 32 bits are, the rest are converted as they are staged</summary>
+			struct stage_t {
+				int32_t integers[stage_size];
+				double others[stage_size];	// Real values, wide integers and nulls already as double
+				uint8_t is_integer[stage_size];
+			};
+
+			void load_stage( DataTable::value_type const & column, size_t const first, size_t const count, double const null_value, stage_t & stage ) {
+				for( size_t n = 0; n < count; ++n ) {
+					auto const & cell = column[first + n];
+					switch( cell.type( ) ) {
+					case DataCellType::integer: {
+						auto const value = cell.integer( );
+						if( std::numeric_limits<int32_t>::min( ) <= value && value <= std::numeric_limits<int32_t>::max( ) ) {
+							stage.integers[n] = static_cast<int32_t>(value);
+							stage.is_integer[n] = 1;
+						} else {
+							stage.integers[n] = 0;
+							stage.others[n] = static_cast<double>(value);
+							stage.is_integer[n] = 0;
+						}
+						break;
+					}
+					case DataCellType::real:
+						stage.integers[n] = 0;
+						stage.others[n] = static_cast<double>(cell.real( ));
+						stage.is_integer[n] = 0;
+						break;
+					case DataCellType::decimal:
+						stage.integers[n] = 0;
+						stage.others[n] = cell.decimal( ).to_double( );
+						stage.is_integer[n] = 0;
+						break;
+					default:
+						stage.integers[n] = 0;
+						stage.others[n] = null_value;
+						stage.is_integer[n] = 0;
+						break;
+					}
+				}
+			}
+
+			/// <summary>out[n] = is_integer[n] ? integers[n] : others[n]</summary>
+			void convert_stage( stage_t const & stage, size_t const count, double * out ) {
+				size_t n = 0;
+#if defined( __AVX2__ )
+				for( ; n + 4 <= count; n += 4 ) {
+					int32_t bytes;
+					std::memcpy( &bytes, stage.is_integer + n, sizeof( bytes ) );
+					auto const mask = _mm256_castsi256_pd( _mm256_cmpgt_epi64( _mm256_cvtepu8_epi64( _mm_cvtsi32_si128( bytes ) ), _mm256_setzero_si256( ) ) );
+					auto const integers = _mm256_cvtepi32_pd( _mm_loadu_si128( reinterpret_cast<__m128i const *>(stage.integers + n) ) );
+					_mm256_storeu_pd( out + n, _mm256_blendv_pd( _mm256_loadu_pd( stage.others + n ), integers, mask ) );
+				}
+#endif
+				for( ; n < count; ++n ) {
+					out[n] = 0 != stage.is_integer[n] ? static_cast<double>(stage.integers[n]) : stage.others[n];
+				}
+			}
+
+			std::vector<DataTable::value_type const *> find_columns( DataTable const & table, std::vector<std::string> const & columns, size_t & rows ) {
+				std::vector<DataTable::value_type const *> result;
+				result.reserve( columns.size( ) );
+				for( auto const & name : columns ) {
+					result.push_back( &table[name] );
+				}
+				rows = result.empty( ) ? 0 : result.front( )->size( );
+				for( auto const column : result ) {
+					daw::exception::daw_throw_on_false( column->size( ) == rows, "{0}: Column {1} does not have the same number of rows as the others", __func__, column->header( ) );
+				}
+				return result;
+			}
+		}	// namespace anonymous
+
+		constexpr size_t const numeric_matrix_t::alignment;
+
+		void numeric_matrix_t::free_t::operator( )( double * ptr ) const noexcept {
+			boost::alignment::aligned_free( ptr );
+		}
+
+		numeric_matrix_t::numeric_matrix_t( size_t rows, size_t columns, matrix_layout layout ):
+				m_data{ nullptr },
+				m_rows{ rows },
+				m_columns{ columns },
+				m_layout{ layout } {
+
+			auto const bytes = std::max<size_t>( 1, rows * columns ) * sizeof( double );
+			m_data.reset( static_cast<double *>(boost::alignment::aligned_alloc( alignment, bytes )) );
+			if( !m_data ) {
+				throw std::bad_alloc( );
+			}
+		}
+
+		double * numeric_matrix_t::data( ) noexcept {
+			return m_data.get( );
+		}
+
+		double const * numeric_matrix_t::data( ) const noexcept {
+			return m_data.get( );
+		}
+
+		size_t numeric_matrix_t::rows( ) const noexcept {
+			return m_rows;
+		}
+
+		size_t numeric_matrix_t::columns( ) const noexcept {
+			return m_columns;
+		}
+
+		matrix_layout numeric_matrix_t::layout( ) const noexcept {
+			return m_layout;
+		}
+
+		double & numeric_matrix_t::operator( )( size_t row, size_t column ) noexcept {
+			return matrix_layout::row_major == m_layout ? m_data.get( )[row * m_columns + column] : m_data.get( )[column * m_rows + row];
+		}
+
+		double const & numeric_matrix_t::operator( )( size_t row, size_t column ) const noexcept {
+			return matrix_layout::row_major == m_layout ? m_data.get( )[row * m_columns + column] : m_data.get( )[column * m_rows + row];
+		}
+
+		void export_numeric( DataTable const & table, std::vector<std::string> const & columns, double * out, matrix_layout layout, double null_value ) {
+			daw::exception::daw_throw_on_true( nullptr == out, "{0}: out must not be null", __func__ );
+			size_t rows = 0;
+			auto const sources = find_columns( table, columns, rows );
+			auto const width = sources.size( );
+			auto const row_blocks = (rows + row_block_size - 1) / row_block_size;
+
+			if( matrix_layout::column_major == layout ) {
+				// Each task fills a contiguous run of one output column
+				algorithm::parallel_for( 0, width * row_blocks, [&]( size_t first, size_t last ) {
+					std::unique_ptr<stage_t> stage{ new stage_t };
+					for( auto task = first; task < last; ++task ) {
+						auto const col = task / row_blocks;
+						auto const block_first = (task % row_blocks) * row_block_size;
+						auto const block_last = std::min( rows, block_first + row_block_size );
+						for( auto row = block_first; row < block_last; row += stage_size ) {
+							auto const count = std::min( stage_size, block_last - row );
+							load_stage( *sources[col], row, count, null_value, *stage );
+							convert_stage( *stage, count, out + col * rows + row );
+						}
+					}
+				} );
+				return;
+			}
+			// Row major tasks own whole rows so no two threads write the same cache line
+			algorithm::parallel_for( 0, row_blocks, [&]( size_t first, size_t last ) {
+				std::unique_ptr<stage_t> stage{ new stage_t };
+				std::vector<double> converted( stage_size );
+				for( auto block = first; block < last; ++block ) {
+					auto const block_first = block * row_block_size;
+					auto const block_last = std::min( rows, block_first + row_block_size );
+					for( auto row = block_first; row < block_last; row += stage_size ) {
+						auto const count = std::min( stage_size, block_last - row );
+						for( size_t col = 0; col < width; ++col ) {
+							load_stage( *sources[col], row, count, null_value, *stage );
+							convert_stage( *stage, count, converted.data( ) );
+							auto dest = out + row * width + col;
+							for( size_t n = 0; n < count; ++n, dest += width ) {
+								*dest = converted[n];
+							}
+						}
+					}
+				}
+			} );
+		}
+
+		numeric_matrix_t export_numeric( DataTable const & table, std::vector<std::string> const & columns, matrix_layout layout, double null_value ) {
+			size_t rows = 0;
+			find_columns( table, columns, rows );
+			numeric_matrix_t result{ rows, columns.size( ), layout };
+			export_numeric( table, columns, result.data( ), layout, null_value );
+			return result;
+		}
+	}	// namespace data
+}	// namespace daw
@@ -0,0 +1,170 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include <daw/daw_exception.h>
+
+#include "data_algorithms.h"
+#include "data_sort_key.h"
+#include "decimal.h"
+
+namespace daw {
+	namespace data {
+		namespace {
+			enum class key_tag_t: uint8_t { empty = 0x00, integer = 0x01, real = 0x02, timestamp = 0x03, string = 0x04, decimal = 0x05 };
+
+			void append_unsigned( std::string & key, uint64_t const value ) {
+				for( int shift = 56; shift >= 0; shift -= 8 ) {
+					key.push_back( static_cast<char>(static_cast<uint8_t>(value >> shift)) );
+				}
+			}
+
+			/// <summary>Big endian with the sign bit flipped so signed values compare as unsigned bytes</summary>
+			void append_signed( std::string & key, int64_t const value ) {
+				append_unsigned( key, static_cast<uint64_t>(value) ^ 0x8000000000000000ULL );
+			}
+
+			/// <summary>IEEE 754 bits with negatives inverted and positives sign flipped compare as unsigned bytes</summary>
+			void append_real( std::string & key, double value ) {
+				if( 0 == value ) {
+					value = 0;	// -0.0 == 0.0
+				}
+				uint64_t bits;
+				std::memcpy( &bits, &value, sizeof( bits ) );
+				append_unsigned( key, 0 != (bits & 0x8000000000000000ULL) ? ~bits : bits ^ 0x8000000000000000ULL );
+			}
+
+			/// <summary>The floor then the fraction at max_scale, so decimals of any scale compare as unsigned bytes</summary>
+			void append_decimal( std::string & key, decimal_t const & value ) {
+				int64_t factor = 1;
+				for( auto n = value.scale( ); 0 < n; --n ) {
+					factor *= 10;
+				}
+				auto whole = value.units( ) / factor;
+				auto fraction = value.units( ) % factor;
+				if( fraction < 0 ) {
+					--whole;
+					fraction += factor;
+				}
+				for( auto n = value.scale( ); n < decimal_t::max_scale; ++n ) {
+					fraction *= 10;
+				}
+				append_signed( key, whole );
+				append_unsigned( key, static_cast<uint64_t>(fraction) );
+			}
+
+			/// <summary>0x00 in the data is escaped as 0x00 0xFF and the string ends with 0x00 0x00 so prefixes sort first</summary>
+			void append_string( std::string & key, boost::string_view value ) {
+				key.reserve( key.size( ) + value.size( ) + 2 );
+				for( auto const c : value ) {
+					key.push_back( c );
+					if( '\0' == c ) {
+						key.push_back( static_cast<char>(0xFF) );
+					}
+				}
+				key.push_back( '\0' );
+				key.push_back( '\0' );
+			}
+
+			void append_tag( std::string & key, key_tag_t const tag ) {
+				key.push_back( static_cast<char>(tag) );
+			}
+		}	// namespace anonymous
+
+		void append_sort_key( std::string & key, DataCell const & cell, bool descending ) {
+			auto const start = key.size( );
+			if( cell.empty( ) ) {
+				append_tag( key, key_tag_t::empty );
+			} else {
+				switch( cell.type( ) ) {
+				case DataCellType::integer:
+					append_tag( key, key_tag_t::integer );
+					append_signed( key, cell.integer( ) );
+					break;
+				case DataCellType::real:
+					append_tag( key, key_tag_t::real );
+					append_real( key, cell.real( ) );
+					break;
+				case DataCellType::decimal:
+					append_tag( key, key_tag_t::decimal );
+					append_decimal( key, cell.decimal( ) );
+					break;
+				case DataCellType::timestamp: {
+					auto const & value = cell.timestamp( );
+					if( value.is_not_a_date_time( ) ) {
+						append_tag( key, key_tag_t::empty );
+						break;
+					}
+					append_tag( key, key_tag_t::timestamp );
+					if( value.is_neg_infinity( ) ) {
+						append_signed( key, std::numeric_limits<int64_t>::min( ) );
+					} else if( value.is_pos_infinity( ) ) {
+						append_signed( key, std::numeric_limits<int64_t>::max( ) );
+					} else {
+						static boost::posix_time::ptime const epoch{ boost::gregorian::date{ 1970, 1, 1 } };
+						append_signed( key, (value - epoch).ticks( ) );
+					}
+					break;
+				}
+				case DataCellType::empty_string:
+				case DataCellType::string:
+					append_tag( key, key_tag_t::string );
+					append_string( key, cell.string_view( ) );
+					break;
+				}
+			}
+			if( descending ) {
+				for( auto n = start; n < key.size( ); ++n ) {
+					key[n] = static_cast<char>(~static_cast<uint8_t>(key[n]));
+				}
+			}
+		}
+
+		std::string sort_key( DataCell const & cell, bool descending ) {
+			std::string result;
+			append_sort_key( result, cell, descending );
+			return result;
+		}
+
+		std::vector<std::string> sort_keys( DataTable const & table, std::vector<std::string> const & columns, std::vector<bool> const & descending ) {
+			daw::exception::daw_throw_on_false( descending.empty( ) || descending.size( ) == columns.size( ), "{0}: descending must be empty or have one entry per column", __func__ );
+			std::vector<DataTable::value_type const *> key_columns;
+			key_columns.reserve( columns.size( ) );
+			for( auto const & column : columns ) {
+				key_columns.push_back( &table[column] );
+			}
+			std::vector<std::string> result( table.empty( ) ? 0 : table[0].size( ) );
+			algorithm::parallel_for( 0, result.size( ), [&]( size_t first, size_t last ) {
+				for( auto row = first; row < last; ++row ) {
+					for( size_t n = 0; n < key_columns.size( ); ++n ) {
+						append_sort_key( result[row], (*key_columns[n])[row], !descending.empty( ) && descending[n] );
+					}
+				}
+			} );
+			return result;
+		}
+	}	// namespace data
+}	// namespace daw
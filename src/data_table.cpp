@@ -21,13 +21,20 @@
 // SOFTWARE.
 
 #include <algorithm>
+#include <boost/filesystem.hpp>
 #include <boost/utility/string_view.hpp>
 #include <cassert>
+#include <cstring>
+#include <deque>
 #include <fstream>
 #include <functional>
-#include <iostream>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <random>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <daw/daw_algorithm.h>
 #include <daw/daw_cstring.h>
@@ -41,6 +48,10 @@
 #include "data_cell.h"
 #include "data_column.h"
 #include "data_table.h"
+#include "decimal.h"
+#include "lazy_table.h"
+#include "row_index.h"
+#include "spill_table.h"
 #include "string_helpers.h"
 
 using daw::string::string_join;
@@ -101,19 +112,38 @@ namespace daw {
 
 
 				std::string to_string( ) const {
-					if( m_empty || m_first == m_last ) {
+					if( m_empty || m_first >= m_last ) {	// Removing the quotes of an empty quoted cell leaves first past last
 						return "";
 					}
 					auto const str_size = m_last - m_first + 1;
 					return std::string( m_buffer->data( m_first ), str_size );
 				}
 
+				/// <summary>Offset of the first byte in the file</summary>
+				size_t offset( ) const noexcept {
+					return m_first;
+				}
+
+				/// <summary>The number of bytes to_cstring copies</summary>
+				size_t length( ) const noexcept {
+					return m_last <= m_first ? 0 : m_last - m_first + 1;
+				}
+
+				/// <summary>The bytes to_cstring copies, without copying them</summary>
+				boost::string_view view( ) const noexcept {
+					auto const str_size = length( );
+					if( 0 == str_size ) {
+						return boost::string_view{ };
+					}
+					return boost::string_view{ m_buffer->data( m_first ), str_size };
+				}
+
 				/// <summary>If you call this you own it or leak it</summary>
 				daw::cstring to_cstring( ) {
-					if( m_last == m_first ) {
+					auto const str_size = length( );
+					if( 0 == str_size ) {
 						return daw::cstring{ };
 					}
-					auto const str_size = m_last - m_first + 1;
 					auto ptr = new_array_throw<char>( str_size + 1 );
 					ptr[str_size] = 0;
 					memcpy( ptr, m_buffer->data( m_first ), str_size );
@@ -165,188 +195,907 @@ namespace daw {
 				}
 			}
 
-			template<typename FunctionType, typename FilePositionType>
-			void display_progress( FunctionType progress_cb, const FilePositionType file_size, const FilePositionType file_pos, boost::posix_time::ptime start_time ) {
-				auto const byte_postfix = []( double value, char& postfix ) {
-					double divisor = 1.0;
-					if( value >= (divisor = 1024.0*1024.0*1024.0*1024.0*1024.0) ) {
-						postfix = 'P';
-					} else if( value >= (divisor = 1024.0*1024.0*1024.0*1024.0) ) {
-						postfix = 'T';
-					} else if( value >= (divisor = 1024.0*1024.0*1024.0) ) {
-						postfix = 'G';
-					} else if( value >= (divisor = 1024.0*1024.0) ) {
-						postfix = 'M';
-					} else if( value >= (divisor = 1024.0) ) {
-						postfix = 'K';
-					} else {
-						postfix = ' ';
+			void display_progress( parse_csv_data_param::progress_cb_t const & progress_cb, uint64_t const file_size, uint64_t const file_pos, uint64_t const rows, parse_clock_t::time_point const start_time ) {
+				if( !progress_cb ) {
+					return;
+				}
+				parse_progress progress;
+				progress.bytes_processed = file_pos;
+				progress.bytes_total = file_size;
+				progress.rows = rows;
+				progress.elapsed_seconds = to_seconds( parse_clock_t::now( ) - start_time );
+				if( 0.0 < progress.elapsed_seconds ) {
+					progress.bytes_per_second = static_cast<double>(file_pos) / progress.elapsed_seconds;
+					progress.seconds_remaining = static_cast<double>(file_size - file_pos) / progress.bytes_per_second;
+				}
+				progress_cb( progress );
+			}
+
+			constexpr char const cell_delimiter = ',';
+			constexpr char const cell_quote = '"';
+
+			/// <summary>Find the end of the row starting at pos, treating quotes as the tokenizer does</summary>
+			/// <param name="cells">Set to the number of cells in the row</param>
+			/// <returns>The position after the row's newline or last if there is none</returns>
+			size_t scan_row( daw::filesystem::memory_mapped_file_t<char> & buffer, size_t pos, size_t const last, size_t & cells ) {
+				bool quoted = false;
+				cells = 1;
+				for( ; pos < last; ++pos ) {
+					auto const c = buffer[pos];
+					if( cell_quote == c ) {
+						quoted = !quoted;
+					} else if( !quoted ) {
+						if( cell_delimiter == c ) {
+							++cells;
+						} else if( '\n' == c ) {
+							return pos + 1;
+						}
 					}
-					value /= divisor;
-					return value;
+				}
+				return last;
+			}
+
+			using byte_range_t = std::pair<size_t, size_t>;
+
+			/// <summary>Work out whether pos is inside a quoted cell from the first quote after it that can only open or only close
+			/// a cell: one after a delimiter or newline opens and one before them closes.  Quotes that could be either are counted
+			/// and the search goes on.  With no quotes before end pos is taken to be unquoted</summary>
+			/// <returns>false when the state cannot be told within [pos, end)</returns>
+			bool is_quoted_at( char const * data, size_t const pos, size_t const end, size_t const last, bool & quoted ) {
+				auto const is_boundary = []( char c ) {
+					return cell_delimiter == c || '\n' == c || '\r' == c;
 				};
+				bool odd = false;
+				bool seen = false;
+				for( auto n = pos; n < end; ++n ) {
+					if( cell_quote != data[n] ) {
+						continue;
+					}
+					seen = true;
+					auto const opens = 0 == n || is_boundary( data[n - 1] );
+					auto const closes = n + 1 == last || is_boundary( data[n + 1] );
+					if( opens != closes ) {
+						quoted = closes != odd;
+						return true;
+					}
+					odd = !odd;
+				}
+				quoted = false;
+				return !seen || (!odd && end == last);
+			}
 
-				if( nullptr != progress_cb ) {	// Progress display
-					auto const import_duration = boost::posix_time::second_clock::local_time( ) - start_time;
-					char file_size_postfix = ' ';
-					auto const file_size_fmt = byte_postfix( static_cast<double>(file_size), file_size_postfix );
-					if( import_duration.total_seconds( ) >= 1 ) {
-						const std::string progress = [&]( ) {
-							static std::stringstream ss;
-							clear( ss );
-							ss.setf( std::ios::fixed, std::ios::floatfield );
-							ss.fill( '0' );
-
-							char postfix = ' ';
-							auto const file_pos_fmt = byte_postfix( static_cast<double>(file_pos), postfix );
-							ss.precision( 2 );
-							ss << "Loading CSV Data... " << file_pos_fmt << postfix << "B of " << file_size_fmt << file_size_postfix << "B (";
-
-							const double bps = static_cast<double>(file_pos) / static_cast<double>(import_duration.total_seconds( ));
-							const double seconds_left = static_cast<real_t>(file_size - file_pos) / bps;
-							const double pbps = byte_postfix( bps, postfix );
-							ss.precision( 2 );
-							ss << pbps;
-							ss << postfix;
-							ss << "B/s) ";
-
-							const boost::posix_time::time_duration time_left = boost::posix_time::seconds( static_cast<long int>(seconds_left) );
-							ss << boost::posix_time::to_simple_string( time_left );
-							ss << " left";
-							return ss.str( );
-						}();
-						progress_cb( progress );
+			/// <summary>Byte ranges of up to count rows in [first, last) drawn uniformly without replacement, in file order, found
+			/// without reading the whole file.  Each draw picks a random offset, walks back to the start of the row it is in and
+			/// takes the row after that one, the last row being followed by the first.  The row after is found in proportion
+			/// to the length of the one before it, so it is kept with probability shortest / that length, shortest being the
+			/// shortest row seen so far.  The quote state at the offset is worked out by is_quoted_at so a newline inside a
+			/// quoted cell is not taken for a row end.  A draw reads at most max_resync_bytes each way from the offset and is
+			/// rejected when that is not enough or the row found does not have the header's cell count, so those rows are
+			/// never chosen.  Gives up after max_draws draws</summary>
+			std::vector<byte_range_t> sample_rows( daw::filesystem::memory_mapped_file_t<char> & buffer, size_t const first, size_t const last, size_t const columns, size_t const count, uint64_t const seed ) {
+				constexpr size_t const max_resync_bytes = 1024 * 1024;
+				constexpr size_t const probe_rows = 16;
+				std::vector<byte_range_t> result;
+				if( 0 == count || first >= last ) {
+					return result;
+				}
+				std::mt19937_64 rng{ seed };
+				auto const data = buffer.data( 0 );
+				// The row after the one offset is in and the length of that one
+				auto const find_row = [&]( size_t const offset ) -> boost::optional<std::pair<byte_range_t, size_t>> {
+					auto const end = std::min( last, offset + max_resync_bytes );
+					bool quoted = false;	// Whether offset is inside a quoted cell.  first - 1 is the header's newline
+					if( first != offset && !is_quoted_at( data, offset, end, last, quoted ) ) {
+						return boost::none;
+					}
+					// Walk back to the start of the row, undoing the quotes passed
+					auto row_first = offset;
+					auto back_quoted = quoted;
+					auto const floor = offset - std::min( offset - first, max_resync_bytes );
+					while( row_first > floor && (back_quoted || '\n' != data[row_first - 1]) ) {
+						--row_first;
+						if( cell_quote == data[row_first] ) {
+							back_quoted = !back_quoted;
+						}
+					}
+					if( first != row_first && (back_quoted || '\n' != data[row_first - 1]) ) {
+						return boost::none;
+					}
+					auto pos = offset;
+					while( pos < end && (quoted || '\n' != data[pos]) ) {
+						if( cell_quote == data[pos] ) {
+							quoted = !quoted;
+						}
+						++pos;
+					}
+					if( end == pos && end != last ) {
+						return boost::none;
 					}
+					pos = std::min( pos + 1, last );
+					auto const length = pos - row_first;
+					if( last == pos ) {
+						pos = first;
+					}
+					size_t cells = 0;
+					auto const row_last = scan_row( buffer, pos, last, cells );
+					if( cells != columns || (row_last != last && '\n' != data[row_last - 1]) ) {
+						return boost::none;
+					}
+					return std::make_pair( byte_range_t{ pos, row_last }, length );
+				};
+				// Seed the shortest row length from the first rows
+				auto shortest = last - first;
+				for( size_t row = 0, pos = first; row < probe_rows && pos < last; ++row ) {
+					size_t cells = 0;
+					auto const row_last = scan_row( buffer, pos, last, cells );
+					shortest = std::min( shortest, row_last - pos );
+					pos = row_last;
+				}
+				auto const max_draws = 16 * count + 1024;
+				std::uniform_int_distribution<size_t> offset_dist{ first, last - 1 };
+				std::map<size_t, size_t> rows;	// Start to end of the rows kept
+				for( size_t draw = 0; draw < max_draws && rows.size( ) < count; ++draw ) {
+					auto const row = find_row( offset_dist( rng ) );
+					if( !row ) {
+						continue;
+					}
+					shortest = std::min( shortest, row->second );
+					if( std::uniform_int_distribution<size_t>{ 1, row->second }( rng ) <= shortest ) {
+						rows.emplace( row->first.first, row->first.second );
+					}
+				}
+				result.reserve( rows.size( ) );
+				for( auto const & row : rows ) {
+					result.push_back( row );
 				}
+				return result;
 			}
 
+			/// <summary>Byte ranges to tokenize.  Rows before the header are skipped without tokenizing them and, when sampling,
+			/// only the header and the sampled rows are included</summary>
+			std::vector<byte_range_t> row_ranges( daw::filesystem::memory_mapped_file_t<char> & buffer, parse_csv_data_param const & param ) {
+				auto const file_size = static_cast<size_t>(buffer.size( ));
+				size_t header_first = 0;
+				size_t cells = 0;
+				for( size_t row = 0; row < param.header_row( ); ++row ) {
+					header_first = scan_row( buffer, header_first, file_size, cells );
+				}
+				if( !param.sample_rows( ) ) {
+					return { byte_range_t{ header_first, file_size } };
+				}
+				auto const header_last = scan_row( buffer, header_first, file_size, cells );
+				auto result = sample_rows( buffer, header_last, file_size, cells, *param.sample_rows( ), param.sample_seed( ) );
+				result.insert( result.begin( ), byte_range_t{ header_first, header_last } );
+				return result;
+			}
+
+			/// <summary>Bytes tokenized between checks of the cancel token and deadline</summary>
+			constexpr size_t const cancel_check_interval = 65536;
+
+			void check_cancelled( parse_csv_data_param const & param ) {
+				if( param.cancel_token( ).is_cancelled( ) ) {
+					throw operation_cancelled( operation_cancelled::reason_t::cancelled, std::string( __func__ ) + ": Parse of " + param.file_name( ) + " was cancelled" );
+				}
+				if( param.deadline( ) && parse_clock_t::now( ) >= *param.deadline( ) ) {
+					throw operation_cancelled( operation_cancelled::reason_t::deadline, std::string( __func__ ) + ": Parse of " + param.file_name( ) + " passed its deadline" );
+				}
+			}
+
+			/// <summary>Accumulates the time between start( ) and stop( ) when enabled.  Costs nothing otherwise</summary>
+			class phase_timer {
+				bool m_enabled;
+				parse_clock_t::duration m_total;
+				parse_clock_t::time_point m_start;
+			public:
+				explicit phase_timer( bool enabled ) noexcept: m_enabled{ enabled }, m_total{ parse_clock_t::duration::zero( ) }, m_start{ } { }
+
+				void start( ) noexcept {
+					if( m_enabled ) {
+						m_start = parse_clock_t::now( );
+					}
+				}
+
+				/// <summary>Stop this timer and start next at the same instant</summary>
+				void stop( phase_timer * next = nullptr ) noexcept {
+					if( m_enabled ) {
+						auto const now = parse_clock_t::now( );
+						m_total += now - m_start;
+						if( nullptr != next ) {
+							next->m_start = now;
+						}
+					}
+				}
+
+				double seconds( ) const noexcept {
+					return to_seconds( m_total );
+				}
+			};
+
+			void count_cell( parse_stats & stats, DataCellType type ) noexcept {
+				switch( type ) {
+				case DataCellType::empty_string:
+					++stats.empty_cells;
+					break;
+				case DataCellType::integer:
+					++stats.integer_cells;
+					break;
+				case DataCellType::real:
+					++stats.real_cells;
+					break;
+				case DataCellType::timestamp:
+					++stats.timestamp_cells;
+					break;
+				case DataCellType::string:
+					++stats.string_cells;
+					break;
+				case DataCellType::decimal:
+					++stats.decimal_cells;
+					break;
+				}
+			}
+
+			/// <summary>Call append_empty( ) until a column of size cells has rows.  A column is only short after ragged rows,
+			/// which tokenize_rows counts in parse_stats::ragged_rows</summary>
+			/// <returns>The number of empty cells appended</returns>
+			template<typename Function>
+			size_t pad_rows( size_t const size, size_t const rows, Function append_empty ) {
+				auto const result = rows - size;
+				for( size_t n = 0; n < result; ++n ) {
+					append_empty( );
+				}
+				return result;
+			}
+
+			/// <summary>Cell sink of parse_csv_data.  Detects, converts and appends each cell as it is found</summary>
+			class convert_cells_t {
+				parse_stats & m_stats;
+				phase_timer m_type_detect_timer;
+				phase_timer m_convert_timer;
+				boost::optional<size_t> m_memory_budget;
+				size_t m_resident;
+				memory_arena_t * m_arena;
+				std::string m_scratch;
+				boost::optional<uint64_t> m_last_byte;
+				boost::optional<size_t> m_row_limit;
+				boost::optional<uint64_t> m_first_offset;
+
+				/// <summary>A vector growing in an arena leaves each old buffer behind, so once a full column has a few rows
+				/// reserve the rows the bytes read so far say are left</summary>
+				template<typename Column>
+				void reserve_estimate( Column & current_column, uint64_t offset ) {
+					auto const rows = current_column.size( );
+					if( rows < 1024 || !m_last_byte || !m_first_offset || offset <= *m_first_offset ) {
+						return;
+					}
+					auto estimate = static_cast<size_t>(rows * (*m_last_byte - *m_first_offset) / (offset - *m_first_offset)) + rows / 16 + 1;
+					if( m_row_limit ) {
+						estimate = std::min( estimate, *m_row_limit );
+					}
+					if( estimate > rows ) {
+						current_column.reserve( estimate );
+					}
+				}
+
+				template<typename Column>
+				void add_resident( Column const & current_column ) {
+					if( m_memory_budget ) {
+						m_resident += cell_resident_size( current_column[current_column.size( ) - 1] );
+						daw::exception::daw_throw_on_true( m_resident > *m_memory_budget, "{0}: The table is larger than the memory budget.  parse_csv_spill can load it", __func__ );
+					}
+				}
+			public:
+				/// <param name="timed">Time the detection and conversion of each cell</param>
+				/// <param name="memory_budget">Fail rather than hold more than this many bytes of cells</param>
+				/// <param name="arena">Where the columns and string cells are stored, the heap when nullptr</param>
+				convert_cells_t( parse_stats & stats, bool timed, boost::optional<size_t> memory_budget = boost::none, memory_arena_t * arena = nullptr ):
+						m_stats( stats ),
+						m_type_detect_timer{ timed },
+						m_convert_timer{ timed },
+						m_memory_budget{ memory_budget },
+						m_resident{ 0 },
+						m_arena{ arena },
+						m_scratch{ },
+						m_last_byte{ },
+						m_row_limit{ },
+						m_first_offset{ } { }
+
+				/// <summary>The data rows end at last_byte, so the number of rows can be estimated from the bytes read</summary>
+				void set_extent( uint64_t last_byte, boost::optional<size_t> row_limit ) {
+					m_last_byte = last_byte;
+					m_row_limit = std::move( row_limit );
+				}
+
+				/// <summary>How tokenize_rows should store the columns</summary>
+				DataTable::allocator_type allocator( ) const noexcept {
+					return DataTable::allocator_type{ m_arena };
+				}
+
+				void header( DataTable::size_type, bool ) noexcept { }
+
+				/// <summary>Append the cell to current_column, a DataTable::value_type or DataColumnSparse</summary>
+				template<typename Column>
+				void cell( Column & current_column, DataTable::size_type, CellReference & current_cell ) {
+					if( current_column.decimal_scale( ) ) {	// Straight from the mapped bytes, anything else is detected as usual
+						m_convert_timer.start( );
+						auto const value = decimal_t::parse( current_cell.view( ), *current_column.decimal_scale( ) );
+						if( value ) {
+							auto const capacity = current_column.capacity( );
+							current_column.append( DataTable::cell_type{ *value } );
+							m_convert_timer.stop( );
+							count_cell( m_stats, DataCellType::decimal );
+							m_stats.estimated_allocations += capacity == current_column.capacity( ) ? 0 : 1;
+							add_resident( current_column );
+							return;
+						}
+						m_convert_timer.stop( );
+					}
+					if( nullptr != m_arena ) {
+						arena_cell( current_column, current_cell );
+						return;
+					}
+					m_type_detect_timer.start( );
+					auto cell_text = current_cell.to_cstring( );
+					auto const cell_type = DataTable::cell_type::detect_type( cell_text );
+					m_type_detect_timer.stop( &m_convert_timer );
+					auto const capacity = current_column.capacity( );
+					current_column.append( DataTable::cell_type::from_string_as( std::move( cell_text ), cell_type ) );
+					m_convert_timer.stop( );
+					count_cell( m_stats, cell_type );
+					m_stats.estimated_allocations += (DataCellType::empty_string == cell_type ? 0 : 1) + (capacity == current_column.capacity( ) ? 0 : 1);
+					add_resident( current_column );
+				}
+
+				/// <summary>As cell( ) but the text is detected and converted from a reused buffer and only copied, to the
+				/// arena, for string cells</summary>
+				template<typename Column>
+				void arena_cell( Column & current_column, CellReference & current_cell ) {
+					m_type_detect_timer.start( );
+					auto const text = current_cell.view( );
+					if( !m_first_offset ) {
+						m_first_offset = current_cell.offset( );
+					} else if( current_column.size( ) == current_column.capacity( ) ) {
+						reserve_estimate( current_column, current_cell.offset( ) );
+					}
+					m_scratch.assign( text.data( ), text.size( ) );
+					daw::cstring cell_text{ text.empty( ) ? nullptr : m_scratch.c_str( ) };
+					auto const cell_type = DataTable::cell_type::detect_type( cell_text );
+					m_type_detect_timer.stop( &m_convert_timer );
+					auto const capacity = current_column.capacity( );
+					if( DataCellType::string == cell_type ) {
+						current_column.append( DataTable::cell_type::borrowed_string( daw::cstring{ m_arena->copy_string( text.data( ), text.size( ) ) } ) );
+					} else {
+						current_column.append( DataTable::cell_type::from_string_as( std::move( cell_text ), cell_type ) );
+					}
+					m_convert_timer.stop( );
+					count_cell( m_stats, cell_type );
+					m_stats.estimated_allocations += capacity == current_column.capacity( ) ? 0 : 1;
+					add_resident( current_column );
+				}
+
+				/// <summary>Fill in the time spent in cell( ), which is not tokenizing</summary>
+				void report( parse_stats & stats ) const noexcept {
+					stats.type_detect_seconds = m_type_detect_timer.seconds( );
+					stats.convert_seconds = m_convert_timer.seconds( );
+				}
+			};
+
+			/// <summary>Cell sink of parse_csv_lazy.  Records where each cell is by its column number in the file and leaves the
+			/// columns of the table empty</summary>
+			class record_offsets_t {
+				std::vector<field_offsets_t> m_offsets;
+				std::vector<bool> m_hidden;
+
+				void add_columns( DataTable::size_type column_no ) {
+					if( m_offsets.size( ) <= column_no ) {
+						m_offsets.resize( column_no + 1 );
+						m_hidden.resize( column_no + 1, false );
+					}
+				}
+			public:
+				record_offsets_t( ) = default;
+
+				/// <summary>The columns are materialized from several threads, so they use the heap</summary>
+				DataTable::allocator_type allocator( ) const noexcept {
+					return DataTable::allocator_type{ };
+				}
+
+				void header( DataTable::size_type column_no, bool hidden ) {
+					add_columns( column_no );
+					m_hidden[column_no] = hidden;
+				}
+
+				void cell( DataTable::value_type &, DataTable::size_type column_no, CellReference & current_cell ) {
+					add_columns( column_no );
+					auto const length = current_cell.length( );
+					if( 0 == length ) {
+						m_offsets[column_no].append_empty( );
+					} else {
+						m_offsets[column_no].append( current_cell.offset( ), length );
+					}
+				}
+
+				void report( parse_stats & ) const noexcept { }
+
+				/// <summary>Offsets of the columns that are not hidden, padded with empty cells to the same number of rows</summary>
+				std::vector<field_offsets_t> release( ) {
+					std::vector<field_offsets_t> result;
+					size_t row_count = 0;
+					for( size_t n = 0; n < m_offsets.size( ); ++n ) {
+						if( !m_hidden[n] ) {
+							row_count = std::max( row_count, m_offsets[n].size( ) );
+							result.push_back( std::move( m_offsets[n] ) );
+						}
+					}
+					for( auto & offsets : result ) {
+						pad_rows( offsets.size( ), row_count, [&offsets]( ) {
+							offsets.append_empty( );
+						} );
+						offsets.shrink_to_fit( );
+					}
+					m_offsets.clear( );
+					m_hidden.clear( );
+					return result;
+				}
+			};
+
+			/// <summary>Cell sink of parse_csv_spill.  Converts each cell as convert_cells_t does into segments of
+			/// spill_segment_rows( ) cells by its column number in the file.  Completed segments are written to the spill
+			/// file, oldest first, while the resident cells leave too little of the memory budget for the segments being filled</summary>
+			class spill_cells_t {
+				using segments_t = std::vector<spill_table_t::segment_t>;
+				convert_cells_t m_convert;
+				boost::optional<size_t> m_memory_budget;
+				std::string m_spill_directory;
+				std::shared_ptr<spill_file_t> m_file;
+				std::vector<segments_t> m_segments;
+				std::vector<bool> m_hidden;
+				std::deque<std::pair<DataTable::size_type, size_t>> m_completed;	// Resident completed segments, oldest first
+				size_t m_resident;
+				size_t m_segment_rows;	// 0 until the header has been read
+				size_t m_spill_above;	// The budget less what the segments being filled are expected to hold
+
+				void add_columns( DataTable::size_type column_no ) {
+					if( m_segments.size( ) <= column_no ) {
+						m_segments.resize( column_no + 1 );
+						m_hidden.resize( column_no + 1, false );
+					}
+				}
+
+				size_t row_count( DataTable::size_type column_no ) const noexcept {
+					size_t result = 0;
+					for( auto const & current : m_segments[column_no] ) {
+						result += current.extent ? current.extent->rows : current.cells.size( );
+					}
+					return result;
+				}
+
+				/// <summary>The segment being filled, a new one set up like prototype when the last is complete</summary>
+				DataTable::value_type & open_segment( DataTable::value_type const & prototype, DataTable::size_type column_no ) {
+					auto & segments = m_segments[column_no];
+					if( segments.empty( ) || segments.back( ).extent || m_segment_rows == segments.back( ).cells.size( ) ) {
+						segments.push_back( spill_table_t::segment_t{ prototype, boost::none } );
+					}
+					return segments.back( ).cells;
+				}
+
+				void spill_completed( ) {
+					while( m_memory_budget && m_resident > m_spill_above && !m_completed.empty( ) ) {
+						auto & current = m_segments[m_completed.front( ).first][m_completed.front( ).second];
+						m_completed.pop_front( );
+						if( !m_file ) {
+							m_file = std::make_shared<spill_file_t>( m_spill_directory );
+						}
+						current.extent = m_file->write( current.cells );
+						for( auto const & cell : current.cells ) {
+							m_resident -= cell_resident_size( cell );
+						}
+						current.cells.clear( );
+						current.cells.shrink_to_fit( );
+					}
+				}
+
+				/// <summary>Account for the cell just appended to the open segment of column_no</summary>
+				void appended( DataTable::size_type column_no ) {
+					auto const & segments = m_segments[column_no];
+					auto const & cells = segments.back( ).cells;
+					m_resident += cell_resident_size( cells[cells.size( ) - 1] );
+					if( m_segment_rows == cells.size( ) ) {
+						m_completed.emplace_back( column_no, segments.size( ) - 1 );
+						spill_completed( );
+					}
+				}
+			public:
+				spill_cells_t( parse_stats & stats, bool timed, parse_csv_data_param const & param ):
+						m_convert{ stats, timed },
+						m_memory_budget{ param.memory_budget( ) },
+						m_spill_directory{ param.spill_directory( ) },
+						m_file{ },
+						m_segments{ },
+						m_hidden{ },
+						m_completed{ },
+						m_resident{ 0 },
+						m_segment_rows{ 0 },
+						m_spill_above{ 0 } { }
+
+				/// <summary>Segments are copies of the columns, which use the heap whatever these do</summary>
+				DataTable::allocator_type allocator( ) const noexcept {
+					return DataTable::allocator_type{ };
+				}
+
+				void header( DataTable::size_type column_no, bool hidden ) {
+					add_columns( column_no );
+					m_hidden[column_no] = hidden;
+				}
+
+				void cell( DataTable::value_type & current_column, DataTable::size_type column_no, CellReference & current_cell ) {
+					if( 0 == m_segment_rows ) {
+						auto const columns = static_cast<size_t>(std::count( m_hidden.begin( ), m_hidden.end( ), false ));
+						m_segment_rows = spill_segment_rows( m_memory_budget, columns );
+						if( m_memory_budget ) {
+							auto const open_size = m_segment_rows * columns * sizeof( DataTable::cell_type );
+							m_spill_above = open_size < *m_memory_budget ? *m_memory_budget - open_size : 0;
+						}
+					}
+					add_columns( column_no );
+					m_convert.cell( open_segment( current_column, column_no ), column_no, current_cell );
+					appended( column_no );
+				}
+
+				void report( parse_stats & stats ) const noexcept {
+					m_convert.report( stats );
+				}
+
+				/// <param name="columns">The empty columns tokenize_rows returned, which are the ones not hidden</param>
+				/// <returns>The segments of those columns padded with empty cells to the same number of rows</returns>
+				spill_table_t release( DataTable & columns ) {
+					if( 0 == m_segment_rows ) {	// No data rows
+						m_segment_rows = spill_table_t::max_segment_rows;
+					}
+					size_t rows = 0;
+					for( size_t n = 0; n < m_segments.size( ); ++n ) {
+						if( !m_hidden[n] ) {
+							rows = std::max( rows, row_count( n ) );
+						}
+					}
+					std::vector<DataTable::value_type> prototypes;
+					std::vector<segments_t> segments;
+					DataTable::size_type column = 0;
+					for( size_t n = 0; n < m_segments.size( ); ++n ) {
+						if( m_hidden[n] ) {
+							continue;
+						}
+						pad_rows( row_count( n ), rows, [&]( ) {
+							open_segment( columns[column], n ).append( DataTable::cell_type( ) );
+							appended( n );
+						} );
+						for( auto & current : m_segments[n] ) {
+							current.cells.shrink_to_fit( );
+						}
+						prototypes.push_back( std::move( columns[column++] ) );
+						segments.push_back( std::move( m_segments[n] ) );
+					}
+					if( m_file ) {
+						m_file->finish( );
+					}
+					m_segments.clear( );
+					m_hidden.clear( );
+					m_completed.clear( );
+					return spill_table_t{ m_segment_rows, std::move( prototypes ), std::move( segments ), std::move( m_file ) };
+				}
+			};
+
+			/// <summary>Whether a column of rows cells, empty of them empty, is stored sparse at threshold</summary>
+			bool is_sparse_enough( size_t const empty, size_t const rows, double const threshold ) noexcept {
+				return 0 < rows && static_cast<double>(empty) > threshold * static_cast<double>(rows);
+			}
+
+			/// <summary>Cell sink of parse_csv_sparse.  Converts each cell as convert_cells_t does into a DataColumnSparse by its
+			/// column number in the file.  Columns start sparse, so their empty cells are never stored, and one is made dense
+			/// once it has sparse_probe_rows rows and too few of them are empty.  release( ) settles each on its final fill</summary>
+			class sparse_cells_t {
+				static constexpr size_t const sparse_probe_rows = 1024;
+
+				convert_cells_t m_convert;
+				double m_threshold;
+				std::vector<DataColumnSparse> m_columns;
+				std::vector<bool> m_started;	// Set up from the first cell's column
+				std::vector<bool> m_hidden;
+				std::vector<size_t> m_empty;	// Empty cells of each column
+
+				void add_columns( DataTable::size_type column_no ) {
+					if( m_columns.size( ) <= column_no ) {
+						m_columns.resize( column_no + 1 );
+						m_started.resize( column_no + 1, false );
+						m_hidden.resize( column_no + 1, false );
+						m_empty.resize( column_no + 1, 0 );
+					}
+				}
+
+				/// <summary>An empty column set up like prototype, sparse unless the threshold says never</summary>
+				DataColumnSparse start_column( DataTable::value_type const & prototype ) const {
+					DataColumnSparse result{ DataTable::value_type{ prototype } };
+					if( m_threshold < 1.0 ) {
+						result.make_sparse( );
+					}
+					return result;
+				}
+			public:
+				sparse_cells_t( parse_stats & stats, bool timed, parse_csv_data_param const & param ):
+						m_convert{ stats, timed, param.memory_budget( ), param.memory_arena( ) },
+						m_threshold{ param.sparse_threshold( ) },
+						m_columns{ },
+						m_started{ },
+						m_hidden{ },
+						m_empty{ } { }
+
+				DataTable::allocator_type allocator( ) const noexcept {
+					return m_convert.allocator( );
+				}
+
+				void header( DataTable::size_type column_no, bool hidden ) {
+					add_columns( column_no );
+					m_hidden[column_no] = hidden;
+				}
+
+				void cell( DataTable::value_type & current_column, DataTable::size_type column_no, CellReference & current_cell ) {
+					add_columns( column_no );
+					auto & column = m_columns[column_no];
+					if( !m_started[column_no] ) {
+						column = start_column( current_column );
+						m_started[column_no] = true;
+					}
+					m_convert.cell( column, column_no, current_cell );
+					auto const & cells = static_cast<DataColumnSparse const &>(column);
+					auto const rows = cells.size( );
+					if( cells[rows - 1].empty( ) ) {
+						++m_empty[column_no];
+					}
+					if( column.is_sparse( ) && sparse_probe_rows <= rows && !is_sparse_enough( m_empty[column_no], rows, m_threshold ) ) {
+						column.make_dense( );
+					}
+				}
+
+				void report( parse_stats & stats ) const noexcept {
+					m_convert.report( stats );
+				}
+
+				/// <param name="columns">The empty columns tokenize_rows returned, which are the ones not hidden</param>
+				/// <returns>The columns padded with empty cells to the same number of rows, each sparse when more than the
+				/// threshold of its cells are empty</returns>
+				sparse_columns_t release( DataTable & columns ) {
+					size_t rows = 0;
+					for( size_t n = 0; n < m_columns.size( ); ++n ) {
+						if( !m_hidden[n] ) {
+							rows = std::max( rows, m_columns[n].size( ) );
+						}
+					}
+					sparse_columns_t result;
+					DataTable::size_type column = 0;
+					for( size_t n = 0; n < m_columns.size( ); ++n ) {
+						if( m_hidden[n] ) {
+							continue;
+						}
+						auto & current = m_columns[n];
+						if( !m_started[n] ) {
+							current = start_column( columns[column] );
+						}
+						++column;
+						auto const padding = pad_rows( current.size( ), rows, [&current]( ) {
+							current.append( DataTable::cell_type( ) );
+						} );
+						if( is_sparse_enough( m_empty[n] + padding, rows, m_threshold ) ) {
+							current.make_sparse( );
+						} else {
+							current.make_dense( );
+						}
+						result.push_back( std::move( current ) );
+					}
+					m_columns.clear( );
+					m_started.clear( );
+					m_hidden.clear( );
+					m_empty.clear( );
+					return result;
+				}
+			};
+
 			/// <summary>Separate CSV File into deleniated strings</summary>
-			/// <param name="fin">Input file stream of CSV File</param>
-			/// <param name="header_row">Numeric row in file that contains the header.  This will be the first line imported</param>
-			/// <param name="column_filter">A function that returns true if the column name is allowed</param>
+			/// <param name="buffer">Mapped CSV File</param>
+			/// <param name="param">File options.  Everything but the file name is used here</param>
+			/// <param name="result_stats">Filled with the counters and timings</param>
+			/// <param name="ranges">Byte ranges to tokenize, the first starting at the header row.  Each must end after a newline</param>
+			/// <param name="sink">Given each header cell with header( column_no, hidden ) and each data cell of a column that
+			/// is not hidden with cell( column, column_no, cell )</param>
 			/// <returns>A <c>DataTable</c> with the contents of the CSV File</returns>
-			DataTable deleniate_rows( daw::filesystem::memory_mapped_file_t<char>& buffer, const DataTable::size_type header_row, const std::function<bool( std::string const & )> column_filter, std::function<void( std::string )> progress_cb ) {
-				if( !progress_cb ) {
-					progress_cb = []( std::string ) { };
-				}
+			template<typename CellSink>
+			DataTable tokenize_rows( daw::filesystem::memory_mapped_file_t<char>& buffer, parse_csv_data_param const & param, parse_stats & result_stats, std::vector<byte_range_t> const & ranges, CellSink & sink ) {
+				auto const start_time = parse_clock_t::now( );
+				auto const header_row = param.header_row( );
+				auto const & column_filter = param.column_filter( );
+				auto const & progress_cb = param.progress_cb( );
 				bool no_filter = !column_filter;
+				result_stats = parse_stats{ };
 				DataTable result_datatable;
 
+				auto const file_size = static_cast<DataTable::size_type>(buffer.size( ));
+				result_stats.bytes = file_size;
 				{
-					auto const file_size = static_cast<DataTable::size_type>(buffer.size( ));
-					static const char delimiter = ',';
-					static const char string_separator = '"';
-					auto const start_time = boost::posix_time::second_clock::local_time( );
+					static const char delimiter = cell_delimiter;
+					static const char string_separator = cell_quote;
 					CounterStack<DataTable::size_type> counter_stack;
-					DataTable::size_type current_row_in_file = 0;
+					DataTable::size_type current_row_in_file = header_row;
 					DataTable::size_type current_column_no = 0;
+					DataTable::size_type header_columns = 0;
 					char prev_char = 0;
-					DataTable::size_type file_pos = 0;
+					size_t range = 0;
+					DataTable::size_type file_pos = ranges.front( ).first;
+					bool done = false;
+					size_t bytes_since_cancel_check = 0;	// file_pos jumps between sampled ranges so it cannot be used
 					CellReference current_cell( buffer );
-					try {
-						while( file_pos < file_size ) {
-							const char& current_char = buffer[file_pos];
-
-							switch( current_char ) {
-							case string_separator:
-								if( string_separator == prev_char ) {
-									prev_char = 0;
-									current_cell.append( file_pos );
-									counter_stack.pop( );
-								} else if( counter_stack.empty( ) ) {
-									current_cell.append( file_pos );
-									counter_stack.push( );
-								} else {
-									prev_char = 0;
-									counter_stack.pop( );
-								}
-								break;
-							case delimiter:
-							case '\n':
-								if( counter_stack.empty( ) ) {
-									if( header_row <= current_row_in_file ) {
-										// Make sure we have enough columns
-										for( auto n = result_datatable.size( ); n <= current_column_no; ++n ) {
-											result_datatable.append( DataTable::value_type { } );
-										}
-										auto& current_column = result_datatable[current_column_no];
-
-										clean_cell_data( current_cell, string_separator );
+					while( !done ) {
+						auto const at_end = file_pos >= ranges[range].second && ranges.size( ) == range + 1;
+						if( file_pos >= ranges[range].second && !at_end ) {	// Move on to the next range of rows
+							file_pos = ranges[++range].first;
+							continue;
+						}
+						if( at_end && (!counter_stack.empty( ) || (0 == current_column_no && current_cell.empty( ))) ) {
+							break;
+						}
+						// A last row without a trailing newline ends as if it had one
+						char const current_char = at_end ? '\n' : buffer[file_pos];
 
-										if( header_row == current_row_in_file ) {
-											auto str = current_cell.to_string( );
-											current_column.hidden( ) = no_filter ? false : !(column_filter( str ));
-											current_column.header( ) = std::move( str );
-										} else if( !current_column.hidden( ) ) {
-											current_column.append( DataTable::cell_type::from_string( current_cell.to_cstring( ) ) );
+						switch( current_char ) {
+						case string_separator:
+							if( string_separator == prev_char ) {
+								prev_char = 0;
+								current_cell.append( file_pos );
+								counter_stack.pop( );
+							} else if( counter_stack.empty( ) ) {
+								current_cell.append( file_pos );
+								counter_stack.push( );
+							} else {
+								prev_char = 0;
+								counter_stack.pop( );
+							}
+							break;
+						case delimiter:
+						case '\n':
+							if( counter_stack.empty( ) ) {
+								if( header_row <= current_row_in_file ) {
+									// Make sure we have enough columns
+									for( auto n = result_datatable.size( ); n <= current_column_no; ++n ) {
+										result_datatable.append( DataTable::value_type{ "", sink.allocator( ) } );
+										if( param.sketches( ) ) {
+											result_datatable[n].enable_sketches( );
 										}
-										++current_column_no;
 									}
-									current_cell.clear( );
-									counter_stack.reset( );
-									prev_char = 0;
-									if( '\n' == current_char ) {
-										current_column_no = 0;
-										++current_row_in_file;
+									auto& current_column = result_datatable[current_column_no];
+
+									clean_cell_data( current_cell, string_separator );
+
+									if( header_row == current_row_in_file ) {
+										auto str = current_cell.to_string( );
+										current_column.hidden( ) = no_filter ? false : !(column_filter( str ));
+										current_column.set_width( param.column_width( str ) );
+										current_column.set_decimal_scale( param.decimal_scale( str ) );
+										current_column.header( ) = std::move( str );
+										sink.header( current_column_no, current_column.hidden( ) );
+									} else if( !current_column.hidden( ) ) {
+										sink.cell( current_column, current_column_no, current_cell );
+									}
+									++current_column_no;
+								}
+								current_cell.clear( );
+								counter_stack.reset( );
+								prev_char = 0;
+								if( '\n' == current_char ) {
+									if( header_row == current_row_in_file ) {
+										header_columns = current_column_no;
+									} else if( header_row < current_row_in_file ) {
+										++result_stats.rows;
+										if( current_column_no != header_columns ) {
+											++result_stats.ragged_rows;
+										}
+										done = param.row_limit( ) && result_stats.rows >= *param.row_limit( );
 									}
-								} else {
-									current_cell.append( file_pos );
+									current_column_no = 0;
+									++current_row_in_file;
 								}
-								break;
-							default:
+							} else {
 								current_cell.append( file_pos );
-								prev_char = current_char;
-								break;
 							}
-							++file_pos;
+							break;
+						default:
+							current_cell.append( file_pos );
+							prev_char = current_char;
+							break;
+						}
+						if( at_end ) {
+							break;
+						}
+						++file_pos;
+						if( cancel_check_interval == ++bytes_since_cancel_check ) {
+							bytes_since_cancel_check = 0;
+							check_cancelled( param );
+						}
 #ifdef _DEBUG
-							if( 0 == file_pos % 262144 ) {	// It is far slower while debugging
+						if( 0 == file_pos % 262144 ) {	// It is far slower while debugging
 #else
-							if( 0 == file_pos % 5242880 ) {	// It is too fast for much less.  May not actually need it
+						if( 0 == file_pos % 5242880 ) {	// It is too fast for much less.  May not actually need it
 #endif
-								display_progress( progress_cb, file_size, file_pos, start_time );
-							}
-						}		// while
-					} catch( const std::exception& ex ) {
-						throw ex;
-					}
+							display_progress( progress_cb, file_size, file_pos, result_stats.rows, start_time );
+						}
+					}		// while
 				}	// Scope around while with variables needed inside loop
-				progress_cb( "Loading CSV Data... Processing" );
-				try {
-					if( !no_filter ) {
-						// Remove column headers we don't want
-						result_datatable.erase( std::remove_if( std::begin( result_datatable ), std::end( result_datatable ), []( const DataTable::value_type& column ) {
-							return column.hidden( );
-						} ), std::end( result_datatable ) );
-					}
-
-					// Verify that all columns are of equal length and append empty strings if not
-
-					{
-						auto const column_size = [&result_datatable]( ) {
-							DataTable::size_type max_size = 0;
-							for( auto const & column : result_datatable ) {
-								if( column.size( ) > max_size ) {
-									max_size = column.size( );
-								}
-							}
-							return max_size;
-						}();
-						for( auto & column : result_datatable ) {
-							auto const num_to_add = column_size - column.size( );
-							if( 0 < num_to_add ) {
-								std::cerr << "Warning: While parsing table a column was missing " << num_to_add << " row(s)\n";
-							}
-							for( DataTable::size_type n = 0; n < num_to_add; ++n ) {
-								column.append( DataTable::cell_type( ) );
+				auto const post_process_start = parse_clock_t::now( );
+				if( progress_cb ) {
+					parse_progress progress;
+					progress.phase = parse_phase::post_processing;
+					progress.bytes_processed = file_size;
+					progress.bytes_total = file_size;
+					progress.rows = result_stats.rows;
+					progress.elapsed_seconds = to_seconds( post_process_start - start_time );
+					progress_cb( progress );
+				}
+				if( !no_filter ) {
+					// Remove column headers we don't want
+					result_datatable.erase( std::remove_if( std::begin( result_datatable ), std::end( result_datatable ), []( const DataTable::value_type& column ) {
+						return column.hidden( );
+					} ), std::end( result_datatable ) );
+				}
+
+				// Verify that all columns are of equal length and append empty strings if not
+
+				{
+					auto const column_size = [&result_datatable]( ) {
+						DataTable::size_type max_size = 0;
+						for( auto const & column : result_datatable ) {
+							if( column.size( ) > max_size ) {
+								max_size = column.size( );
 							}
+						}
+						return max_size;
+					}();
+					for( auto & column : result_datatable ) {
+						auto const capacity = column.capacity( );
+						pad_rows( column.size( ), column_size, [&column]( ) {
+							column.append( DataTable::cell_type( ) );
+						} );
+						if( nullptr == column.get_allocator( ).arena( ) ) {	// Would only leave another copy in the arena
 							column.shrink_to_fit( );
 						}
+						if( capacity != column.capacity( ) && 0 < column.capacity( ) ) {
+							++result_stats.estimated_allocations;
+						}
 					}
-					return result_datatable;
-				} catch( const std::exception& ex ) {
-					throw ex;
 				}
+				auto const end_time = parse_clock_t::now( );
+				result_stats.columns = result_datatable.size( );
+				sink.report( result_stats );
+				result_stats.tokenize_seconds = to_seconds( post_process_start - start_time ) - result_stats.type_detect_seconds - result_stats.convert_seconds;
+				result_stats.post_process_seconds = to_seconds( end_time - post_process_start );
+				result_stats.total_seconds = to_seconds( end_time - start_time );
+				if( progress_cb ) {
+					parse_progress progress;
+					progress.phase = parse_phase::complete;
+					progress.bytes_processed = file_size;
+					progress.bytes_total = file_size;
+					progress.rows = result_stats.rows;
+					progress.elapsed_seconds = result_stats.total_seconds;
+					progress_cb( progress );
+				}
+				return result_datatable;
+			}
+
+			/// <summary>Tokenize, detect and convert.  stats is optional and, as they cost a clock read per phase per cell,
+			/// only has timings when given</summary>
+			DataTable deleniate_rows( daw::filesystem::memory_mapped_file_t<char>& buffer, parse_csv_data_param const & param, parse_stats * stats, std::vector<byte_range_t> const & ranges ) {
+				parse_stats local_stats;
+				auto & result_stats = nullptr == stats ? local_stats : *stats;
+				convert_cells_t sink{ result_stats, nullptr != stats, param.memory_budget( ), param.memory_arena( ) };
+				if( 1 == ranges.size( ) ) {	// Samples jump around the file
+					sink.set_extent( ranges.front( ).second, param.row_limit( ) );
+				}
+				return tokenize_rows( buffer, param, result_stats, ranges, sink );
 			}
 		}
 
@@ -354,12 +1103,28 @@ namespace daw {
 				m_file_name{ std::move( fileName ) }, 
 				m_header_row{ headerRow },
 				m_column_filter{ std::move( columnFilter ) },
-				m_progress_cb{ std::move( progressCb ) } { }
+				m_progress_cb{ std::move( progressCb ) },
+				m_cancel_token{ },
+				m_deadline{ },
+				m_row_limit{ },
+				m_sample_rows{ },
+				m_sample_seed{ 0 },
+				m_sketches{ false },
+				m_column_widths{ },
+				m_decimal_scales{ },
+				m_memory_budget{ },
+				m_spill_directory{ },
+				m_memory_arena{ nullptr },
+				m_sparse_threshold{ 0.9 } { }
 
 		std::string const & parse_csv_data_param::file_name( ) const noexcept {
 			return m_file_name;
 		}
 
+		void parse_csv_data_param::set_file_name( std::string file_name ) {
+			m_file_name = std::move( file_name );
+		}
+
 		DataTable::size_type const & parse_csv_data_param::header_row( ) const noexcept {
 			return m_header_row;
 		}
@@ -368,19 +1133,124 @@ namespace daw {
 			return m_column_filter;
 		}
 
-		std::function<void( std::string )> const & parse_csv_data_param::progress_cb( ) const noexcept {
+		parse_csv_data_param::progress_cb_t const & parse_csv_data_param::progress_cb( ) const noexcept {
 			return m_progress_cb;
 		}
 
-		expected_t<DataTable> parse_csv_data( parse_csv_data_param const & param ) {
-			return parse_csv_data( param.file_name( ), param.header_row( ), param.column_filter( ), param.progress_cb( ) );
+		parse_csv_data_param::progress_cb_t text_progress_cb( std::function<void( std::string )> text_cb ) {
+			if( !text_cb ) {
+				return nullptr;
+			}
+			return [text_cb = std::move( text_cb )]( parse_progress const & progress ) {
+				text_cb( to_string( progress ) );
+			};
 		}
 
-		expected_t<DataTable> parse_csv_data( std::string const &file_name, const DataTable::size_type header_row,
-		                                      const std::function<bool( std::string const & )> column_filter,
-		                                      std::function<void( std::string )> progress_cb ) {
+		void parse_csv_data_param::set_cancel_token( cancellation_token token ) {
+			m_cancel_token = std::move( token );
+		}
 
-			return daw::expected_from_code<DataTable>( [&]( ) {
+		cancellation_token const & parse_csv_data_param::cancel_token( ) const noexcept {
+			return m_cancel_token;
+		}
+
+		void parse_csv_data_param::set_deadline( parse_clock_t::time_point deadline ) {
+			m_deadline = deadline;
+		}
+
+		boost::optional<parse_clock_t::time_point> const & parse_csv_data_param::deadline( ) const noexcept {
+			return m_deadline;
+		}
+
+		void parse_csv_data_param::set_row_limit( size_t rows ) {
+			m_row_limit = rows;
+		}
+
+		boost::optional<size_t> const & parse_csv_data_param::row_limit( ) const noexcept {
+			return m_row_limit;
+		}
+
+		void parse_csv_data_param::set_sample( size_t rows, uint64_t seed ) {
+			m_sample_rows = rows;
+			m_sample_seed = seed;
+		}
+
+		boost::optional<size_t> const & parse_csv_data_param::sample_rows( ) const noexcept {
+			return m_sample_rows;
+		}
+
+		uint64_t parse_csv_data_param::sample_seed( ) const noexcept {
+			return m_sample_seed;
+		}
+
+		void parse_csv_data_param::set_sketches( bool enabled ) {
+			m_sketches = enabled;
+		}
+
+		bool parse_csv_data_param::sketches( ) const noexcept {
+			return m_sketches;
+		}
+
+		void parse_csv_data_param::set_memory_budget( size_t bytes ) {
+			m_memory_budget = bytes;
+		}
+
+		boost::optional<size_t> const & parse_csv_data_param::memory_budget( ) const noexcept {
+			return m_memory_budget;
+		}
+
+		void parse_csv_data_param::set_spill_directory( std::string directory ) {
+			m_spill_directory = std::move( directory );
+		}
+
+		std::string const & parse_csv_data_param::spill_directory( ) const noexcept {
+			return m_spill_directory;
+		}
+
+		void parse_csv_data_param::set_memory_arena( memory_arena_t * arena ) {
+			m_memory_arena = arena;
+		}
+
+		memory_arena_t * parse_csv_data_param::memory_arena( ) const noexcept {
+			return m_memory_arena;
+		}
+
+		void parse_csv_data_param::set_sparse_threshold( double ratio ) {
+			daw::exception::daw_throw_on_true( !(0.0 <= ratio), "{0}: The ratio cannot be negative", __func__ );
+			m_sparse_threshold = ratio;
+		}
+
+		double parse_csv_data_param::sparse_threshold( ) const noexcept {
+			return m_sparse_threshold;
+		}
+
+		void parse_csv_data_param::set_column_width( std::string header, storage_width_t width ) {
+			m_column_widths[std::move( header )] = width;
+		}
+
+		void parse_csv_data_param::set_decimal_scale( std::string header, uint8_t scale ) {
+			daw::exception::daw_throw_on_true( scale > decimal_t::max_scale, "{0}: Scale is larger than decimal_t::max_scale", __func__ );
+			m_decimal_scales[std::move( header )] = scale;
+		}
+
+		boost::optional<uint8_t> parse_csv_data_param::decimal_scale( std::string const & header ) const {
+			auto pos = m_decimal_scales.find( header );
+			if( m_decimal_scales.end( ) == pos ) {
+				return boost::none;
+			}
+			return pos->second;
+		}
+
+		storage_width_t parse_csv_data_param::column_width( std::string const & header ) const {
+			auto pos = m_column_widths.find( header );
+			if( m_column_widths.end( ) == pos ) {
+				return storage_width_t::none;
+			}
+			return pos->second;
+		}
+
+		namespace {
+			std::unique_ptr<daw::filesystem::memory_mapped_file_t<char>> open_csv_file( std::string const & file_name ) {
 				std::unique_ptr<daw::filesystem::memory_mapped_file_t<char>> buffer{nullptr};
 				buffer = std::make_unique<daw::filesystem::memory_mapped_file_t<char>>( file_name, true );
 				if( nullptr == buffer.get( ) || !buffer->is_open( ) ) {
@@ -388,12 +1258,191 @@ namespace daw {
 				} else if( 0 >= buffer->size( ) ) {
 					throw std::runtime_error( string_join( __func__, ": MemoryMappedFile does not have data" ) );
 				}
-				auto const start_row = header_row; // 0 > header_row ? 0 : header_row;
-				auto result = deleniate_rows( *buffer, start_row, column_filter, progress_cb );
-				return result;
+				return buffer;
+			}
+
+			int64_t file_write_time( std::string const & file_name ) {
+				return static_cast<int64_t>(boost::filesystem::last_write_time( file_name ));
+			}
+
+			expected_t<DataTable> parse_csv_data_impl( parse_csv_data_param const & param, parse_stats * stats ) {
+				return daw::expected_from_code<DataTable>( [&]( ) {
+					auto buffer = open_csv_file( param.file_name( ) );
+					check_cancelled( param );
+					auto result = deleniate_rows( *buffer, param, stats, row_ranges( *buffer, param ) );
+					return result;
+				} );
+			}
+		}	// namespace anonymous
+
+		expected_t<DataTable> parse_csv_data( parse_csv_data_param const & param ) {
+			return parse_csv_data_impl( param, nullptr );
+		}
+
+		expected_t<DataTable> parse_csv_data( parse_csv_data_param const & param, parse_stats & stats ) {
+			return parse_csv_data_impl( param, &stats );
+		}
+
+		expected_t<DataTable> parse_csv_data( std::string const &file_name, const DataTable::size_type header_row,
+		                                      const std::function<bool( std::string const & )> column_filter,
+		                                      parse_csv_data_param::progress_cb_t progress_cb ) {
+			return parse_csv_data_impl( parse_csv_data_param{ file_name, header_row, column_filter, std::move( progress_cb ) }, nullptr );
+		}
+
+		sparse_columns_t to_sparse_columns( DataTable table, double threshold ) {
+			sparse_columns_t result;
+			result.reserve( table.size( ) );
+			for( auto & column : table ) {
+				result.emplace_back( std::move( column ) );
+				auto & current = result.back( );
+				if( is_sparse_enough( current.stats( ).null_count( ), current.size( ), threshold ) ) {
+					current.make_sparse( );
+				}
+			}
+			return result;
+		}
+
+		namespace {
+			expected_t<sparse_columns_t> parse_csv_sparse_impl( parse_csv_data_param const & param, parse_stats * stats ) {
+				return daw::expected_from_code<sparse_columns_t>( [&]( ) {
+					auto buffer = open_csv_file( param.file_name( ) );
+					check_cancelled( param );
+					parse_stats local_stats;
+					auto & result_stats = nullptr == stats ? local_stats : *stats;
+					sparse_cells_t sink{ result_stats, nullptr != stats, param };
+					auto columns = tokenize_rows( *buffer, param, result_stats, row_ranges( *buffer, param ), sink );
+					auto result = sink.release( columns );
+					if( nullptr != stats ) {
+						stats->sparse_columns = static_cast<uint64_t>(std::count_if( result.begin( ), result.end( ), []( DataColumnSparse const & column ) {
+							return column.is_sparse( );
+						} ));
+					}
+					return result;
+				} );
+			}
+		}	// namespace anonymous
+
+		expected_t<sparse_columns_t> parse_csv_sparse( parse_csv_data_param const & param ) {
+			return parse_csv_sparse_impl( param, nullptr );
+		}
+
+		expected_t<sparse_columns_t> parse_csv_sparse( parse_csv_data_param const & param, parse_stats & stats ) {
+			return parse_csv_sparse_impl( param, &stats );
+		}
+
+		row_index_t build_row_index( std::string const & file_name, size_t header_row, size_t stride ) {
+			daw::exception::daw_throw_on_false( 0 < stride, "{0}: stride must be at least 1", __func__ );
+			auto buffer = open_csv_file( file_name );
+			auto const file_size = static_cast<size_t>(buffer->size( ));
+			size_t header_first = 0;
+			size_t cells = 0;
+			for( size_t row = 0; row < header_row; ++row ) {
+				header_first = scan_row( *buffer, header_first, file_size, cells );
+			}
+			auto const header_last = scan_row( *buffer, header_first, file_size, cells );
+
+			std::vector<uint64_t> offsets;
+			uint64_t row_count = 0;
+			bool quoted = false;
+			auto const data = buffer->data( 0 );
+			auto row_first = header_last;
+			for( auto pos = header_last; pos < file_size; ++pos ) {
+				auto const c = data[pos];
+				if( cell_quote == c ) {
+					quoted = !quoted;
+				} else if( '\n' == c && !quoted ) {
+					if( 0 == row_count % stride ) {
+						offsets.push_back( row_first );
+					}
+					++row_count;
+					row_first = pos + 1;
+				}
+			}
+			if( row_first < file_size ) {	// Last row without a trailing newline
+				if( 0 == row_count % stride ) {
+					offsets.push_back( row_first );
+				}
+				++row_count;
+			}
+			return row_index_t{ file_size, file_write_time( file_name ), row_index_t::head_hash( data, file_size ), stride, row_count, header_first, header_last, std::move( offsets ) };
+		}
+
+		expected_t<DataTable> read_rows( std::string const & file_name, row_index_t const & index, size_t first, size_t count, parse_csv_data_param const & options ) {
+			return daw::expected_from_code<DataTable>( [&]( ) {
+				auto buffer = open_csv_file( file_name );
+				auto const file_size = static_cast<size_t>(buffer->size( ));
+				daw::exception::daw_throw_on_false( index.matches( file_size, file_write_time( file_name ), row_index_t::head_hash( buffer->data( 0 ), file_size ) ), "{0}: The index of {1} is out of date", __func__, file_name );
+
+				std::vector<byte_range_t> ranges;
+				ranges.emplace_back( static_cast<size_t>(index.header_first( )), static_cast<size_t>(index.header_last( )) );
+				auto const last = std::min<uint64_t>( index.row_count( ), static_cast<uint64_t>(first) + count );
+				if( first < last ) {
+					auto row = (first / index.stride( )) * index.stride( );
+					auto range_first = static_cast<size_t>(index.offsets( )[static_cast<size_t>(first / index.stride( ))]);
+					size_t cells = 0;
+					for( ; row < first; ++row ) {
+						range_first = scan_row( *buffer, range_first, file_size, cells );
+					}
+					auto range_last = range_first;
+					for( ; row < last; ++row ) {
+						range_last = scan_row( *buffer, range_last, file_size, cells );
+					}
+					ranges.emplace_back( range_first, range_last );
+				}
+				auto param = options;
+				param.set_file_name( file_name );
+				return deleniate_rows( *buffer, param, nullptr, ranges );
 			} );
 		}
 
+		expected_t<DataTable> read_rows( std::string const & file_name, row_index_t const & index, size_t first, size_t count ) {
+			return read_rows( file_name, index, first, count, parse_csv_data_param{ file_name, 0 } );
+		}
+
+		namespace {
+			expected_t<lazy_table_t> parse_csv_lazy_impl( parse_csv_data_param const & param, parse_stats * stats ) {
+				return daw::expected_from_code<lazy_table_t>( [&]( ) {
+					std::shared_ptr<lazy_table_t::buffer_t> buffer = open_csv_file( param.file_name( ) );
+					check_cancelled( param );
+					parse_stats local_stats;
+					auto & result_stats = nullptr == stats ? local_stats : *stats;
+					record_offsets_t sink;
+					auto columns = tokenize_rows( *buffer, param, result_stats, row_ranges( *buffer, param ), sink );
+					return lazy_table_t{ std::move( buffer ), std::vector<DataTable::value_type>( std::make_move_iterator( columns.begin( ) ), std::make_move_iterator( columns.end( ) ) ), sink.release( ) };
+				} );
+			}
+		}	// namespace anonymous
+
+		namespace {
+			expected_t<spill_table_t> parse_csv_spill_impl( parse_csv_data_param const & param, parse_stats * stats ) {
+				return daw::expected_from_code<spill_table_t>( [&]( ) {
+					auto buffer = open_csv_file( param.file_name( ) );
+					check_cancelled( param );
+					parse_stats local_stats;
+					auto & result_stats = nullptr == stats ? local_stats : *stats;
+					spill_cells_t sink{ result_stats, nullptr != stats, param };
+					auto columns = tokenize_rows( *buffer, param, result_stats, row_ranges( *buffer, param ), sink );
+					return sink.release( columns );
+				} );
+			}
+		}	// namespace anonymous
+
+		expected_t<spill_table_t> parse_csv_spill( parse_csv_data_param const & param ) {
+			return parse_csv_spill_impl( param, nullptr );
+		}
+
+		expected_t<spill_table_t> parse_csv_spill( parse_csv_data_param const & param, parse_stats & stats ) {
+			return parse_csv_spill_impl( param, &stats );
+		}
+
+		expected_t<lazy_table_t> parse_csv_lazy( parse_csv_data_param const & param ) {
+			return parse_csv_lazy_impl( param, nullptr );
+		}
+
+		expected_t<lazy_table_t> parse_csv_lazy( parse_csv_data_param const & param, parse_stats & stats ) {
+			return parse_csv_lazy_impl( param, &stats );
+		}
+
 		// DataTable
 		DataTable::DataTable( DataTable const & other ) : m_items( other.m_items ) { }
 
@@ -446,6 +1495,10 @@ namespace daw {
 			return m_items.empty( );
 		}
 
+		DataTable::allocator_type DataTable::get_allocator( ) const {
+			return m_items.empty( ) ? allocator_type{ } : m_items.front( ).get_allocator( );
+		}
+
 			const DataTable::value_type& DataTable::item( size_type const & column ) const {
 			return m_items[column];
 		}
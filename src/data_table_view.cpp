@@ -0,0 +1,190 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+#include <daw/daw_exception.h>
+
+#include "data_algorithms.h"
+#include "data_table_view.h"
+
+namespace daw {
+	namespace data {
+		// ColumnView
+		ColumnView::ColumnView( DataTable::value_type const & column, selection_ptr_t rows ) noexcept:
+				m_column{ &column },
+				m_rows{ std::move( rows ) } { }
+
+		ColumnView::size_type ColumnView::size( ) const noexcept {
+			return m_rows ? m_rows->size( ) : m_column->size( );
+		}
+
+		bool ColumnView::empty( ) const noexcept {
+			return 0 == size( );
+		}
+
+		std::string const & ColumnView::header( ) const noexcept {
+			return m_column->header( );
+		}
+
+		DataTable::value_type const & ColumnView::parent( ) const noexcept {
+			return *m_column;
+		}
+
+		ColumnView::const_iterator ColumnView::begin( ) const noexcept {
+			return const_iterator{ m_column, m_rows.get( ), 0 };
+		}
+
+		ColumnView::const_iterator ColumnView::end( ) const noexcept {
+			return const_iterator{ m_column, m_rows.get( ), size( ) };
+		}
+
+		ColumnView::const_iterator ColumnView::cbegin( ) const noexcept {
+			return begin( );
+		}
+
+		ColumnView::const_iterator ColumnView::cend( ) const noexcept {
+			return end( );
+		}
+		// End ColumnView
+
+		// TableView
+		TableView::TableView( DataTable const & parent ):
+				m_parent{ &parent },
+				m_rows{ nullptr },
+				m_columns( parent.size( ) ) {
+
+			std::iota( m_columns.begin( ), m_columns.end( ), 0 );
+		}
+
+		TableView::TableView( DataTable const & parent, selection_ptr_t rows, std::vector<size_type> columns ):
+				m_parent{ &parent },
+				m_rows{ std::move( rows ) },
+				m_columns( std::move( columns ) ) { }
+
+		ColumnView TableView::operator[]( size_type column ) const {
+			return ColumnView{ (*m_parent)[m_columns[column]], m_rows };
+		}
+
+		ColumnView TableView::operator[]( boost::string_view column ) const {
+			auto const pos = m_parent->get_column_index( column );
+			daw::exception::daw_throw_on_true( std::find( m_columns.begin( ), m_columns.end( ), pos ) == m_columns.end( ), "{0}: Column is not part of the view -> {1}", __func__, column );
+			return ColumnView{ (*m_parent)[pos], m_rows };
+		}
+
+		TableView::size_type TableView::size( ) const noexcept {
+			return m_columns.size( );
+		}
+
+		bool TableView::empty( ) const noexcept {
+			return m_columns.empty( );
+		}
+
+		TableView::size_type TableView::row_count( ) const noexcept {
+			if( m_rows ) {
+				return m_rows->size( );
+			}
+			return m_parent->empty( ) ? 0 : (*m_parent)[0].size( );
+		}
+
+		TableView::size_type TableView::parent_row( size_type row ) const noexcept {
+			return m_rows ? (*m_rows)[row] : row;
+		}
+
+		DataTable const & TableView::parent( ) const noexcept {
+			return *m_parent;
+		}
+
+		TableView::const_iterator TableView::begin( ) const noexcept {
+			return const_iterator{ this, 0 };
+		}
+
+		TableView::const_iterator TableView::end( ) const noexcept {
+			return const_iterator{ this, size( ) };
+		}
+
+		TableView::const_iterator TableView::cbegin( ) const noexcept {
+			return begin( );
+		}
+
+		TableView::const_iterator TableView::cend( ) const noexcept {
+			return end( );
+		}
+
+		TableView TableView::filter( std::vector<uint8_t> const & keep ) const {
+			daw::exception::daw_throw_on_false( keep.size( ) == row_count( ), "{0}: keep must have an entry for every row in the view", __func__ );
+			auto rows = std::make_shared<selection_t>( );
+			rows->reserve( static_cast<size_type>(std::count_if( keep.begin( ), keep.end( ), []( uint8_t value ) { return 0 != value; } )) );
+			for( size_type row = 0; row < keep.size( ); ++row ) {
+				if( 0 != keep[row] ) {
+					rows->push_back( parent_row( row ) );
+				}
+			}
+			return TableView{ *m_parent, std::move( rows ), m_columns };
+		}
+
+		TableView TableView::select_rows( selection_t const & rows ) const {
+			daw::exception::daw_throw_on_false( rows.end( ) == std::adjacent_find( rows.begin( ), rows.end( ), std::greater_equal<>{ } ), "{0}: Rows must be strictly ascending", __func__ );
+			auto result_rows = std::make_shared<selection_t>( );
+			result_rows->reserve( rows.size( ) );
+			for( auto const row : rows ) {
+				daw::exception::daw_throw_on_false( row < row_count( ), "{0}: Row is outside of the view", __func__ );
+				result_rows->push_back( parent_row( row ) );
+			}
+			return TableView{ *m_parent, std::move( result_rows ), m_columns };
+		}
+
+		TableView TableView::select_columns( std::vector<std::string> const & columns ) const {
+			std::vector<size_type> positions;
+			positions.reserve( columns.size( ) );
+			for( auto const & column : columns ) {
+				auto const pos = m_parent->get_column_index( column );
+				daw::exception::daw_throw_on_true( std::find( m_columns.begin( ), m_columns.end( ), pos ) == m_columns.end( ), "{0}: Column is not part of the view -> {1}", __func__, column );
+				positions.push_back( pos );
+			}
+			return TableView{ *m_parent, m_rows, std::move( positions ) };
+		}
+
+		DataTable TableView::materialize( ) const {
+			std::vector<DataTable::value_type> columns( size( ) );
+			algorithm::parallel_for( 0, size( ), [&]( size_t first, size_t last ) {
+				for( auto n = first; n < last; ++n ) {
+					auto const source = (*this)[n];
+					DataTable::value_type column{ source.header( ) };
+					column.reserve( source.size( ) );
+					for( auto const & cell : source ) {
+						column.append( cell );
+					}
+					columns[n] = std::move( column );
+				}
+			} );
+			DataTable result;
+			for( auto & column : columns ) {
+				result.append( std::move( column ) );
+			}
+			return result;
+		}
+		// End TableView
+	}	// namespace data
+}	// namespace daw
@@ -0,0 +1,251 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <boost/functional/hash.hpp>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include <daw/daw_exception.h>
+
+#include "decimal.h"
+
+namespace daw {
+	namespace data {
+		namespace {
+			constexpr int64_t const powers_of_ten[decimal_t::max_scale + 1] = {
+				1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL,
+				10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL, 100000000000000LL,
+				1000000000000000LL, 10000000000000000LL, 100000000000000000LL, 1000000000000000000LL
+			};
+
+			constexpr bool is_digit( char c ) noexcept {
+				return '0' <= c && c <= '9';
+			}
+
+			uint64_t magnitude( int64_t value ) noexcept {
+				return value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+			}
+		}	// namespace anonymous
+
+		constexpr uint8_t const decimal_t::max_scale;
+		constexpr size_t const decimal_t::max_chars;
+
+		decimal_t::decimal_t( int64_t units, uint8_t scale ):
+				m_units{ units },
+				m_scale{ scale } {
+
+			daw::exception::daw_throw_on_true( scale > max_scale, "{0}: Scale is larger than max_scale", __func__ );
+		}
+
+		int64_t decimal_t::units( ) const noexcept {
+			return m_units;
+		}
+
+		uint8_t decimal_t::scale( ) const noexcept {
+			return m_scale;
+		}
+
+		boost::optional<decimal_t> decimal_t::parse( boost::string_view text, uint8_t scale ) noexcept {
+			if( scale > max_scale || text.empty( ) ) {
+				return boost::none;
+			}
+			size_t pos = 0;
+			bool const negative = '-' == text[0];
+			if( negative || '+' == text[0] ) {
+				++pos;
+			}
+			// One more for negatives so the smallest int64_t parses
+			uint64_t const limit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max( )) + (negative ? 1 : 0);
+			uint64_t result = 0;
+			auto const accumulate = [&result, limit]( char c ) {
+				auto const digit = static_cast<uint64_t>(c - '0');
+				if( result > (limit - digit) / 10 ) {
+					return false;
+				}
+				result = result * 10 + digit;
+				return true;
+			};
+			size_t digits = 0;
+			for( ; pos < text.size( ) && is_digit( text[pos] ); ++pos, ++digits ) {
+				if( !accumulate( text[pos] ) ) {
+					return boost::none;
+				}
+			}
+			uint8_t fraction_digits = 0;
+			bool round_up = false;
+			if( pos < text.size( ) && '.' == text[pos] ) {
+				auto const first_fraction = ++pos;
+				for( ; pos < text.size( ) && is_digit( text[pos] ); ++pos, ++digits ) {
+					if( fraction_digits < scale ) {
+						if( !accumulate( text[pos] ) ) {
+							return boost::none;
+						}
+						++fraction_digits;
+					} else if( pos == first_fraction + scale ) {	// The first digit dropped decides the rounding
+						round_up = '5' <= text[pos];
+					}
+				}
+			}
+			if( pos != text.size( ) || 0 == digits ) {
+				return boost::none;
+			}
+			for( ; fraction_digits < scale; ++fraction_digits ) {
+				if( !accumulate( '0' ) ) {
+					return boost::none;
+				}
+			}
+			if( round_up ) {
+				if( result == limit ) {
+					return boost::none;
+				}
+				++result;
+			}
+			return decimal_t{ static_cast<int64_t>(negative ? 0 - result : result), scale };
+		}
+
+		decimal_t decimal_t::rescale( uint8_t scale ) const {
+			daw::exception::daw_throw_on_true( scale > max_scale, "{0}: Scale is larger than max_scale", __func__ );
+			if( scale == m_scale ) {
+				return *this;
+			}
+			if( scale > m_scale ) {
+				auto const factor = powers_of_ten[scale - m_scale];
+				daw::exception::daw_throw_on_true( m_units > std::numeric_limits<int64_t>::max( ) / factor || m_units < std::numeric_limits<int64_t>::min( ) / factor, "{0}: Decimal overflow", __func__ );
+				return decimal_t{ m_units * factor, scale };
+			}
+			auto const factor = powers_of_ten[m_scale - scale];
+			auto result = m_units / factor;
+			auto const remainder = m_units % factor;
+			if( 2 * (remainder < 0 ? -remainder : remainder) >= factor ) {
+				result += m_units < 0 ? -1 : 1;
+			}
+			return decimal_t{ result, scale };
+		}
+
+		size_t decimal_t::format( char * out ) const noexcept {
+			char buffer[max_chars];
+			auto pos = max_chars;
+			auto value = magnitude( m_units );
+			for( uint8_t n = 0; n < m_scale; ++n ) {
+				buffer[--pos] = static_cast<char>('0' + value % 10);
+				value /= 10;
+			}
+			if( 0 < m_scale ) {
+				buffer[--pos] = '.';
+			}
+			do {
+				buffer[--pos] = static_cast<char>('0' + value % 10);
+				value /= 10;
+			} while( 0 != value );
+			if( m_units < 0 ) {
+				buffer[--pos] = '-';
+			}
+			auto const size = max_chars - pos;
+			std::memcpy( out, buffer + pos, size );
+			return size;
+		}
+
+		std::string decimal_t::to_string( ) const {
+			char buffer[max_chars];
+			return std::string( buffer, format( buffer ) );
+		}
+
+		double decimal_t::to_double( ) const noexcept {
+			return static_cast<double>(m_units) / static_cast<double>(powers_of_ten[m_scale]);
+		}
+
+		int decimal_t::compare( decimal_t const & lhs, decimal_t const & rhs ) noexcept {
+			auto const cmp = []( int64_t a, int64_t b ) {
+				return a < b ? -1 : b < a ? 1 : 0;
+			};
+			if( lhs.m_scale == rhs.m_scale ) {
+				return cmp( lhs.m_units, rhs.m_units );
+			}
+			// Whole parts first.  The fractions are then below 10^max_scale at the larger scale, so cannot overflow
+			auto const lhs_factor = powers_of_ten[lhs.m_scale];
+			auto const rhs_factor = powers_of_ten[rhs.m_scale];
+			auto const whole = cmp( lhs.m_units / lhs_factor, rhs.m_units / rhs_factor );
+			if( 0 != whole ) {
+				return whole;
+			}
+			auto const scale = std::max( lhs.m_scale, rhs.m_scale );
+			return cmp( (lhs.m_units % lhs_factor) * powers_of_ten[scale - lhs.m_scale], (rhs.m_units % rhs_factor) * powers_of_ten[scale - rhs.m_scale] );
+		}
+
+		std::size_t decimal_t::hash( ) const noexcept {
+			auto units = m_units;
+			auto scale = m_scale;
+			while( 0 < scale && 0 == units % 10 ) {
+				units /= 10;
+				--scale;
+			}
+			std::size_t result = 0;
+			boost::hash_combine( result, units );
+			boost::hash_combine( result, scale );
+			return result;
+		}
+
+		decimal_t operator+( decimal_t const & lhs, decimal_t const & rhs ) {
+			auto const scale = std::max( lhs.scale( ), rhs.scale( ) );
+			auto const a = lhs.rescale( scale ).units( );
+			auto const b = rhs.rescale( scale ).units( );
+			daw::exception::daw_throw_on_true( (0 < b && a > std::numeric_limits<int64_t>::max( ) - b) || (b < 0 && a < std::numeric_limits<int64_t>::min( ) - b), "{0}: Decimal overflow", __func__ );
+			return decimal_t{ a + b, scale };
+		}
+
+		decimal_t operator-( decimal_t const & value ) {
+			daw::exception::daw_throw_on_true( std::numeric_limits<int64_t>::min( ) == value.units( ), "{0}: Decimal overflow", __func__ );
+			return decimal_t{ -value.units( ), value.scale( ) };
+		}
+
+		decimal_t operator-( decimal_t const & lhs, decimal_t const & rhs ) {
+			auto const scale = std::max( lhs.scale( ), rhs.scale( ) );
+			return lhs + (-rhs.rescale( scale ));
+		}
+
+		bool operator==( decimal_t const & lhs, decimal_t const & rhs ) noexcept {
+			return 0 == decimal_t::compare( lhs, rhs );
+		}
+
+		bool operator!=( decimal_t const & lhs, decimal_t const & rhs ) noexcept {
+			return 0 != decimal_t::compare( lhs, rhs );
+		}
+
+		bool operator<( decimal_t const & lhs, decimal_t const & rhs ) noexcept {
+			return decimal_t::compare( lhs, rhs ) < 0;
+		}
+
+		bool operator>( decimal_t const & lhs, decimal_t const & rhs ) noexcept {
+			return decimal_t::compare( lhs, rhs ) > 0;
+		}
+
+		bool operator<=( decimal_t const & lhs, decimal_t const & rhs ) noexcept {
+			return decimal_t::compare( lhs, rhs ) <= 0;
+		}
+
+		bool operator>=( decimal_t const & lhs, decimal_t const & rhs ) noexcept {
+			return decimal_t::compare( lhs, rhs ) >= 0;
+		}
+	}	// namespace data
+}	// namespace daw
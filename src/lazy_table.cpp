@@ -0,0 +1,222 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <daw/daw_exception.h>
+#include <daw/daw_newhelper.h>
+
+#include "data_algorithms.h"
+#include "decimal.h"
+#include "lazy_table.h"
+
+// parse_csv_lazy is with the tokenizer in data_table.cpp
+
+namespace daw {
+	namespace data {
+		namespace {
+			/// <summary>The cell parse_csv_data would have made from the same bytes</summary>
+			DataTable::cell_type make_cell( char const * first, uint64_t length, boost::optional<uint8_t> const & decimal_scale ) {
+				if( decimal_scale ) {
+					auto const value = decimal_t::parse( boost::string_view{ first, static_cast<size_t>(length) }, *decimal_scale );
+					if( value ) {
+						return DataTable::cell_type{ *value };
+					}
+				}
+				daw::cstring cell_text{ };
+				if( 0 < length ) {
+					auto const str_size = static_cast<size_t>(length);
+					auto ptr = new_array_throw<char>( str_size + 1 );
+					ptr[str_size] = 0;
+					memcpy( ptr, first, str_size );
+					cell_text = daw::cstring{ ptr };
+					cell_text.take_ownership_of_data( );
+				}
+				auto const cell_type = DataTable::cell_type::detect_type( cell_text );
+				return DataTable::cell_type::from_string_as( std::move( cell_text ), cell_type );
+			}
+		}	// namespace anonymous
+
+		field_offsets_t::field_offsets_t( ):
+				m_bytes{ },
+				m_last_offset{ 0 },
+				m_size{ 0 } { }
+
+		void field_offsets_t::append_varint( uint64_t value ) {
+			while( value >= 0x80 ) {
+				m_bytes.push_back( static_cast<uint8_t>(value | 0x80) );
+				value >>= 7;
+			}
+			m_bytes.push_back( static_cast<uint8_t>(value) );
+		}
+
+		void field_offsets_t::append( uint64_t offset, uint64_t length ) {
+			daw::exception::daw_throw_on_true( offset < m_last_offset, "{0}: Offsets must not decrease", __func__ );
+			append_varint( offset - m_last_offset );
+			append_varint( length );
+			m_last_offset = offset;
+			++m_size;
+		}
+
+		void field_offsets_t::append_empty( ) {
+			append_varint( 0 );
+			append_varint( 0 );
+			++m_size;
+		}
+
+		size_t field_offsets_t::size( ) const noexcept {
+			return m_size;
+		}
+
+		size_t field_offsets_t::encoded_size( ) const noexcept {
+			return m_bytes.size( );
+		}
+
+		void field_offsets_t::shrink_to_fit( ) {
+			m_bytes.shrink_to_fit( );
+		}
+
+		lazy_table_t::lazy_table_t( std::shared_ptr<buffer_t> buffer, std::vector<DataTable::value_type> columns, std::vector<field_offsets_t> offsets ):
+				m_buffer{ std::move( buffer ) },
+				m_columns{ },
+				m_row_count{ 0 } {
+
+			daw::exception::daw_throw_on_true( columns.size( ) != offsets.size( ), "{0}: Each column needs offsets", __func__ );
+			m_columns.reserve( columns.size( ) );
+			for( size_t n = 0; n < columns.size( ); ++n ) {
+				daw::exception::daw_throw_on_true( 0 < n && offsets[n].size( ) != m_row_count, "{0}: Columns must have the same number of rows", __func__ );
+				daw::exception::daw_throw_on_false( columns[n].empty( ), "{0}: Columns must be empty", __func__ );
+				m_row_count = offsets[n].size( );
+				m_columns.push_back( column_t{ std::move( columns[n] ), std::move( offsets[n] ), std::make_unique<std::mutex>( ), false } );
+			}
+		}
+
+		DataTable::size_type lazy_table_t::size( ) const noexcept {
+			return m_columns.size( );
+		}
+
+		bool lazy_table_t::empty( ) const noexcept {
+			return m_columns.empty( );
+		}
+
+		DataTable::size_type lazy_table_t::row_count( ) const noexcept {
+			return m_row_count;
+		}
+
+		std::string const & lazy_table_t::header( DataTable::size_type column ) const {
+			return m_columns.at( column ).values.header( );
+		}
+
+		DataTable::size_type lazy_table_t::get_column_index( boost::string_view column_name ) const {
+			auto pos = std::find_if( m_columns.begin( ), m_columns.end( ), [column_name]( column_t const & column ) {
+				return column_name == column.values.header( );
+			} );
+			daw::exception::daw_throw_on_true( m_columns.end( ) == pos, "{0}: Could not find the column specified by name -> {1}", __func__, column_name );
+			return static_cast<DataTable::size_type>(std::distance( m_columns.begin( ), pos ));
+		}
+
+		bool lazy_table_t::is_materialized( DataTable::size_type column ) const {
+			auto const & current = m_columns.at( column );
+			std::lock_guard<std::mutex> lock{ *current.mutex };
+			return current.materialized;
+		}
+
+		size_t lazy_table_t::offsets_size( ) const {
+			size_t result = 0;
+			for( auto const & column : m_columns ) {
+				std::lock_guard<std::mutex> lock{ *column.mutex };	// materialized( ) replaces offsets
+				result += column.offsets.encoded_size( );
+			}
+			return result;
+		}
+
+		DataTable::value_type & lazy_table_t::materialized( DataTable::size_type column ) {
+			auto & current = m_columns.at( column );
+			std::lock_guard<std::mutex> lock{ *current.mutex };
+			if( !current.materialized ) {
+				auto & values = current.values;
+				values.reserve( m_row_count );
+				auto & buffer = *m_buffer;
+				try {
+					current.offsets.for_each( [&]( uint64_t offset, uint64_t length ) {
+						values.append( make_cell( buffer.data( static_cast<size_t>(offset) ), length, values.decimal_scale( ) ) );
+					} );
+				} catch( ... ) {
+					values.clear( );	// So the next access starts over
+					throw;
+				}
+				current.offsets = field_offsets_t{ };	// Not needed once materialized
+				current.materialized = true;
+			}
+			return current.values;
+		}
+
+		DataTable::value_type const & lazy_table_t::operator[]( DataTable::size_type column ) {
+			return materialized( column );
+		}
+
+		DataTable::value_type const & lazy_table_t::operator[]( boost::string_view column_name ) {
+			return materialized( get_column_index( column_name ) );
+		}
+
+		void lazy_table_t::materialize( std::vector<DataTable::size_type> const & columns ) {
+			algorithm::parallel_for( 0, columns.size( ), [&]( size_t first, size_t last ) {
+				for( auto n = first; n < last; ++n ) {
+					materialized( columns[n] );
+				}
+			} );
+		}
+
+		void lazy_table_t::materialize( std::vector<std::string> const & column_names ) {
+			std::vector<DataTable::size_type> columns;
+			columns.reserve( column_names.size( ) );
+			for( auto const & column_name : column_names ) {
+				columns.push_back( get_column_index( column_name ) );
+			}
+			materialize( columns );
+		}
+
+		void lazy_table_t::materialize_all( ) {
+			std::vector<DataTable::size_type> columns( m_columns.size( ) );
+			for( size_t n = 0; n < columns.size( ); ++n ) {
+				columns[n] = n;
+			}
+			materialize( columns );
+		}
+
+		DataTable lazy_table_t::release( ) {
+			materialize_all( );
+			DataTable result;
+			for( auto & column : m_columns ) {
+				result.append( std::move( column.values ) );
+			}
+			m_columns.clear( );
+			m_row_count = 0;
+			m_buffer.reset( );
+			return result;
+		}
+	}	// namespace data
+}	// namespace daw
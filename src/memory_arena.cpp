@@ -0,0 +1,105 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <daw/daw_exception.h>
+
+#include "memory_arena.h"
+
+namespace daw {
+	namespace data {
+		namespace {
+			constexpr size_t const max_chunk_size = 64 * 1024 * 1024;
+		}	// namespace anonymous
+
+		constexpr size_t const memory_arena_t::default_chunk_size;
+
+		memory_arena_t::memory_arena_t( size_t initial_chunk_size ):
+				m_chunks{ },
+				m_pos{ nullptr },
+				m_end{ nullptr },
+				m_next_chunk_size{ std::max( initial_chunk_size, size_t{ 64 } ) },
+				m_allocated{ 0 },
+				m_children{ },
+				m_children_mutex{ } { }
+
+		void memory_arena_t::add_chunk( size_t min_size ) {
+			auto const size = std::max( m_next_chunk_size, min_size );
+			m_chunks.push_back( chunk_t{ std::unique_ptr<char[]>{ new char[size] }, size } );
+			m_pos = m_chunks.back( ).data.get( );
+			m_end = m_pos + size;
+			m_next_chunk_size = std::min( m_next_chunk_size * 2, max_chunk_size );	// Fewer chunks as the arena grows
+		}
+
+		void * memory_arena_t::allocate( size_t bytes, size_t alignment ) {
+			daw::exception::daw_throw_on_true( 0 == alignment || 0 != (alignment & (alignment - 1)), "{0}: Alignment must be a power of two", __func__ );
+			auto const padding = [&]( ) {
+				return (alignment - (reinterpret_cast<uintptr_t>(m_pos) & (alignment - 1))) & (alignment - 1);
+			};
+			if( nullptr == m_pos || static_cast<size_t>(m_end - m_pos) < bytes + padding( ) ) {
+				add_chunk( bytes + alignment );
+			}
+			auto const result = m_pos + padding( );
+			m_pos = result + bytes;
+			m_allocated += bytes;
+			return result;
+		}
+
+		char * memory_arena_t::copy_string( char const * str, size_t length ) {
+			auto const result = static_cast<char *>(allocate( length + 1, 1 ));
+			std::memcpy( result, str, length );
+			result[length] = 0;
+			return result;
+		}
+
+		memory_arena_t & memory_arena_t::make_child( ) {
+			auto child = std::make_unique<memory_arena_t>( default_chunk_size );
+			std::lock_guard<std::mutex> lock{ m_children_mutex };
+			m_children.push_back( std::move( child ) );
+			return *m_children.back( );
+		}
+
+		void memory_arena_t::release( ) noexcept {
+			m_chunks.clear( );
+			m_pos = nullptr;
+			m_end = nullptr;
+			m_allocated = 0;
+			std::lock_guard<std::mutex> lock{ m_children_mutex };
+			m_children.clear( );
+		}
+
+		size_t memory_arena_t::allocated( ) const noexcept {
+			return m_allocated;
+		}
+
+		size_t memory_arena_t::reserved( ) const noexcept {
+			size_t result = 0;
+			for( auto const & chunk : m_chunks ) {
+				result += chunk.size;
+			}
+			return result;
+		}
+	}	// namespace data
+}	// namespace daw
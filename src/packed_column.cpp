@@ -0,0 +1,199 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <daw/daw_exception.h>
+
+#include "packed_column.h"
+
+namespace daw {
+	namespace data {
+		namespace {
+			template<typename T>
+			T narrow( integer_t value, std::true_type ) {
+				daw::exception::daw_throw_on_true( value < std::numeric_limits<T>::min( ) || value > std::numeric_limits<T>::max( ), "{0}: Value does not fit the column's width", __func__ );
+				return static_cast<T>(value);
+			}
+
+			template<typename T>
+			T narrow( integer_t value, std::false_type ) {
+				return static_cast<T>(value);
+			}
+
+			template<typename T>
+			T narrow( real_t value, std::true_type ) {
+				daw::exception::daw_throw_on_true( true, "{0}: Real value in a column of integer width", __func__ );
+				return static_cast<T>(value);
+			}
+
+			template<typename T>
+			T narrow( real_t value, std::false_type ) {
+				return static_cast<T>(value);
+			}
+		}	// namespace anonymous
+
+		packed_column_t::packed_column_t( ):
+				m_header{ },
+				m_width{ storage_width_t::none },
+				m_size{ 0 },
+				m_values{ },
+				m_valid{ } { }
+
+		packed_column_t::packed_column_t( DataTable::value_type const & column ):
+				m_header{ column.header( ) },
+				m_width{ column.width( ) },
+				m_size{ column.size( ) },
+				m_values{ },
+				m_valid{ } {
+
+			switch( m_width ) {
+			case storage_width_t::int8:
+				pack<int8_t>( column );
+				break;
+			case storage_width_t::int16:
+				pack<int16_t>( column );
+				break;
+			case storage_width_t::int32:
+				pack<int32_t>( column );
+				break;
+			case storage_width_t::int64:
+				pack<int64_t>( column );
+				break;
+			case storage_width_t::float32:
+				pack<float>( column );
+				break;
+			case storage_width_t::float64:
+				pack<double>( column );
+				break;
+			case storage_width_t::none:
+				daw::exception::daw_throw_on_true( true, "{0}: Column {1} is not numeric", __func__, column.header( ) );
+			}
+		}
+
+		template<typename T>
+		void packed_column_t::pack( DataTable::value_type const & column ) {
+			std::vector<T> values( m_size );
+			m_valid.resize( m_size );
+			bool has_nulls = false;
+			for( size_t row = 0; row < m_size; ++row ) {
+				auto const & cell = column[row];
+				if( cell.empty( ) ) {
+					values[row] = 0;
+					m_valid[row] = 0;
+					has_nulls = true;
+					continue;
+				}
+				switch( cell.type( ) ) {
+				case DataCellType::integer:
+					values[row] = narrow<T>( cell.integer( ), std::is_integral<T>{ } );
+					break;
+				case DataCellType::real:
+					values[row] = narrow<T>( cell.real( ), std::is_integral<T>{ } );
+					break;
+				default:
+					daw::exception::daw_throw_on_true( true, "{0}: Column {1} has a cell that is not numeric", __func__, column.header( ) );
+				}
+				m_valid[row] = 1;
+			}
+			m_values = std::move( values );
+			if( !has_nulls ) {
+				m_valid.clear( );
+				m_valid.shrink_to_fit( );
+			}
+		}
+
+		std::string const & packed_column_t::header( ) const noexcept {
+			return m_header;
+		}
+
+		storage_width_t packed_column_t::width( ) const noexcept {
+			return m_width;
+		}
+
+		size_t packed_column_t::size( ) const noexcept {
+			return m_size;
+		}
+
+		bool packed_column_t::empty( ) const noexcept {
+			return 0 == m_size;
+		}
+
+		size_t packed_column_t::memory_size( ) const noexcept {
+			return m_size * storage_bytes( m_width ) + m_valid.size( );
+		}
+
+		bool packed_column_t::is_null( size_t row ) const noexcept {
+			return !m_valid.empty( ) && 0 == m_valid[row];
+		}
+
+		uint8_t const * packed_column_t::valid( ) const noexcept {
+			return m_valid.empty( ) ? nullptr : m_valid.data( );
+		}
+
+		integer_t packed_column_t::integer( size_t row ) const {
+			daw::exception::daw_throw_on_false( is_integer_width( m_width ), "{0}: Column {1} is not stored as integers", __func__, m_header );
+			return visit( [row]( auto const * values ) {
+				return static_cast<integer_t>(values[row]);
+			} );
+		}
+
+		real_t packed_column_t::real( size_t row ) const {
+			return visit( [row]( auto const * values ) {
+				return static_cast<real_t>(values[row]);
+			} );
+		}
+
+		DataCell packed_column_t::cell( size_t row ) const {
+			if( is_null( row ) ) {
+				return DataCell{ };
+			}
+			if( is_integer_width( m_width ) ) {
+				return DataCell{ integer( row ) };
+			}
+			return DataCell{ real( row ) };
+		}
+
+		DataTable::value_type packed_column_t::unpack( ) const {
+			DataTable::value_type result{ m_header };
+			result.reserve( m_size );
+			for( size_t row = 0; row < m_size; ++row ) {
+				result.append( cell( row ) );
+			}
+			return result;
+		}
+
+		std::vector<packed_column_t> pack_numeric_columns( DataTable const & table ) {
+			std::vector<packed_column_t> result;
+			for( auto const & column : table ) {
+				if( storage_width_t::none != column.width( ) ) {
+					result.emplace_back( column );
+				}
+			}
+			return result;
+		}
+	}	// namespace data
+}	// namespace daw
@@ -0,0 +1,84 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <utility>
+
+#include "parse_async.h"
+#include "task_scheduler.h"
+
+namespace daw {
+	namespace data {
+		namespace {
+			/// <summary>The library scheduler is created first so it is destroyed after this one, whose destructor
+			/// finishes any parse still queued or running before joining its workers</summary>
+			std::shared_ptr<task_scheduler> & parse_scheduler( ) {
+				static auto result = (get_task_scheduler( ), std::make_shared<task_scheduler>( ));
+				return result;
+			}
+		}	// namespace anonymous
+
+		parse_executor_t default_parse_executor( ) {
+			auto scheduler = parse_scheduler( );
+			return [scheduler]( std::function<void( )> task ) {
+				scheduler->add_task( std::move( task ) );
+			};
+		}
+
+		std::future<expected_t<DataTable>> parse_csv_data_async( parse_csv_data_param param, parse_executor_t executor, parse_complete_cb_t on_complete ) {
+			if( !executor ) {
+				executor = default_parse_executor( );
+			}
+			// std::function needs a copyable task so the promise and parameters are shared
+			auto promise = std::make_shared<std::promise<expected_t<DataTable>>>( );
+			auto result = promise->get_future( );
+			auto shared_param = std::make_shared<parse_csv_data_param>( std::move( param ) );
+			auto shared_on_complete = std::make_shared<parse_complete_cb_t>( std::move( on_complete ) );
+			// Whichever of the task and a throwing executor claims the promise first is the only one to satisfy it
+			auto claimed = std::make_shared<std::atomic<bool>>( false );
+			try {
+				executor( [promise, shared_param, shared_on_complete, claimed]( ) {
+					if( claimed->exchange( true ) ) {
+						return;
+					}
+					try {
+						auto table = parse_csv_data( *shared_param );
+						if( *shared_on_complete ) {
+							(*shared_on_complete)( table );
+						}
+						promise->set_value( std::move( table ) );
+					} catch( ... ) {
+						promise->set_exception( std::current_exception( ) );
+					}
+				} );
+			} catch( ... ) {
+				if( !claimed->exchange( true ) ) {
+					promise->set_exception( std::current_exception( ) );
+				}
+			}
+			return result;
+		}
+	}	// namespace data
+}	// namespace daw
@@ -0,0 +1,150 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <daw/daw_exception.h>
+#include <daw/daw_expected.h>
+
+#include "data_algorithms.h"
+#include "parse_files.h"
+
+namespace daw {
+	namespace data {
+		namespace {
+			bool wildcard_match( char const * pattern, char const * str ) {
+				char const * star = nullptr;
+				char const * star_str = nullptr;
+				while( 0 != *str ) {
+					if( '?' == *pattern || *pattern == *str ) {
+						++pattern;
+						++str;
+					} else if( '*' == *pattern ) {
+						star = pattern++;
+						star_str = str;
+					} else if( nullptr != star ) {	// Let the last * take one more character and retry
+						pattern = star + 1;
+						str = ++star_str;
+					} else {
+						return false;
+					}
+				}
+				while( '*' == *pattern ) {
+					++pattern;
+				}
+				return 0 == *pattern;
+			}
+
+			DataTable::size_type row_count( DataTable const & table ) {
+				return table.empty( ) ? 0 : table[0].size( );
+			}
+
+			void check_headers( DataTable const & expected, DataTable const & table, std::string const & file_name ) {
+				using namespace daw::exception;
+				daw_throw_on_false( expected.size( ) == table.size( ), "{0}: {1} has a different number of columns than the first file", __func__, file_name );
+				for( DataTable::size_type n = 0; n < table.size( ); ++n ) {
+					daw_throw_on_false( expected[n].header( ) == table[n].header( ), "{0}: Column {1} of {2} is named {3} but the first file has {4}", __func__, n, file_name, table[n].header( ), expected[n].header( ) );
+				}
+			}
+
+			DataTable concat_checked( std::vector<DataTable> tables ) {
+				if( tables.empty( ) ) {
+					return DataTable{ };
+				}
+				DataTable::size_type total_rows = 0;
+				for( auto const & table : tables ) {
+					total_rows += row_count( table );
+				}
+				auto result = std::move( tables.front( ) );
+				algorithm::parallel_for( 0, result.size( ), [&]( size_t first, size_t last ) {
+					for( auto col = first; col < last; ++col ) {
+						auto & column = result[col];
+						column.reserve( total_rows );
+						for( size_t n = 1; n < tables.size( ); ++n ) {
+							auto & source = tables[n][col];
+							column.append( std::move( source ) );
+							// Free the moved from cells now rather than holding them until the end
+							source.shrink_to_fit( );
+						}
+					}
+				} );
+				return result;
+			}
+		}	// namespace anonymous
+
+		std::vector<std::string> find_files( std::string const & directory, std::string const & pattern ) {
+			namespace fs = boost::filesystem;
+			std::vector<std::string> result;
+			for( fs::directory_iterator it{ fs::path{ directory } }, last; it != last; ++it ) {
+				if( fs::is_regular_file( it->status( ) ) && wildcard_match( pattern.c_str( ), it->path( ).filename( ).string( ).c_str( ) ) ) {
+					result.push_back( it->path( ).string( ) );
+				}
+			}
+			std::sort( result.begin( ), result.end( ) );
+			return result;
+		}
+
+		DataTable concat_tables( std::vector<DataTable> tables ) {
+			for( size_t n = 1; n < tables.size( ); ++n ) {
+				check_headers( tables.front( ), tables[n], "table " + std::to_string( n ) );
+			}
+			return concat_checked( std::move( tables ) );
+		}
+
+		expected_t<DataTable> parse_csv_files( std::vector<std::string> const & file_names, parse_csv_data_param const & options ) {
+			return daw::expected_from_code<DataTable>( [&]( ) {
+				daw::exception::daw_throw_on_true( file_names.empty( ), "{0}: No files to parse", __func__ );
+				std::vector<expected_t<DataTable>> parsed( file_names.size( ) );
+				algorithm::parallel_for( 0, file_names.size( ), [&]( size_t first, size_t last ) {
+					for( auto n = first; n < last; ++n ) {
+						auto param = options;
+						param.set_file_name( file_names[n] );
+						if( nullptr != options.memory_arena( ) ) {	// Arenas are not thread safe
+							param.set_memory_arena( &options.memory_arena( )->make_child( ) );
+						}
+						parsed[n] = parse_csv_data( param );
+					}
+				} );
+
+				std::vector<DataTable> tables;
+				tables.reserve( parsed.size( ) );
+				for( size_t n = 0; n < parsed.size( ); ++n ) {
+					tables.push_back( std::move( parsed[n].get( ) ) );	// Rethrows the parse error of this file
+					if( 0 < n ) {
+						check_headers( tables.front( ), tables.back( ), file_names[n] );
+					}
+				}
+				return concat_checked( std::move( tables ) );
+			} );
+		}
+
+		expected_t<DataTable> parse_csv_files( std::string const & directory, std::string const & pattern, parse_csv_data_param const & options ) {
+			return daw::expected_from_code<DataTable>( [&]( ) {
+				return parse_csv_files( find_files( directory, pattern ), options ).get( );
+			} );
+		}
+	}	// namespace data
+}	// namespace daw
@@ -0,0 +1,82 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <sstream>
+#include <string>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "parse_stats.h"
+
+namespace daw {
+	namespace data {
+		namespace {
+			double byte_postfix( double value, char & postfix ) noexcept {
+				double divisor = 1.0;
+				if( value >= (divisor = 1024.0*1024.0*1024.0*1024.0*1024.0) ) {
+					postfix = 'P';
+				} else if( value >= (divisor = 1024.0*1024.0*1024.0*1024.0) ) {
+					postfix = 'T';
+				} else if( value >= (divisor = 1024.0*1024.0*1024.0) ) {
+					postfix = 'G';
+				} else if( value >= (divisor = 1024.0*1024.0) ) {
+					postfix = 'M';
+				} else if( value >= (divisor = 1024.0) ) {
+					postfix = 'K';
+				} else {
+					postfix = ' ';
+				}
+				return value / divisor;
+			}
+		}	// namespace anonymous
+
+		std::string to_string( parse_progress const & progress ) {
+			switch( progress.phase ) {
+			case parse_phase::post_processing:
+				return "Loading CSV Data... Processing";
+			case parse_phase::complete:
+				return "Loading CSV Data... Complete";
+			case parse_phase::tokenizing:
+				break;
+			}
+			std::ostringstream ss;
+			ss.setf( std::ios::fixed, std::ios::floatfield );
+			ss.precision( 2 );
+
+			char postfix = ' ';
+			auto const bytes_processed = byte_postfix( static_cast<double>(progress.bytes_processed), postfix );
+			ss << "Loading CSV Data... " << bytes_processed << postfix << "B of ";
+			auto const bytes_total = byte_postfix( static_cast<double>(progress.bytes_total), postfix );
+			ss << bytes_total << postfix << "B";
+			if( 0.0 < progress.bytes_per_second ) {
+				auto const rate = byte_postfix( progress.bytes_per_second, postfix );
+				ss << " (" << rate << postfix << "B/s) ";
+				ss << boost::posix_time::to_simple_string( boost::posix_time::seconds( static_cast<long>(progress.seconds_remaining) ) ) << " left";
+			}
+			return ss.str( );
+		}
+
+		uint64_t parse_stats::cells( ) const noexcept {
+			return empty_cells + integer_cells + real_cells + timestamp_cells + string_cells + decimal_cells;
+		}
+	}	// namespace data
+}	// namespace daw
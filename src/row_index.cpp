@@ -0,0 +1,163 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <daw/daw_exception.h>
+
+#include "row_index.h"
+
+// build_row_index and read_rows are with the tokenizer in data_table.cpp
+
+namespace daw {
+	namespace data {
+		namespace {
+			char const index_magic[8] = { 'C', 'S', 'V', 'R', 'I', 'D', 'X', '2' };
+
+			template<typename T>
+			void write_value( std::ofstream & out, T const & value ) {
+				out.write( reinterpret_cast<char const *>(&value), sizeof( value ) );
+			}
+
+			template<typename T>
+			T read_value( std::ifstream & in ) {
+				T result{ };
+				in.read( reinterpret_cast<char *>(&result), sizeof( result ) );
+				return result;
+			}
+		}	// namespace anonymous
+
+		row_index_t::row_index_t( ):
+				m_file_size{ 0 },
+				m_file_time{ 0 },
+				m_head_hash{ 0 },
+				m_stride{ 1 },
+				m_row_count{ 0 },
+				m_header_first{ 0 },
+				m_header_last{ 0 },
+				m_offsets{ } { }
+
+		row_index_t::row_index_t( uint64_t file_size, int64_t file_time, uint64_t head_hash, uint64_t stride, uint64_t row_count, uint64_t header_first, uint64_t header_last, std::vector<uint64_t> offsets ):
+				m_file_size{ file_size },
+				m_file_time{ file_time },
+				m_head_hash{ head_hash },
+				m_stride{ stride },
+				m_row_count{ row_count },
+				m_header_first{ header_first },
+				m_header_last{ header_last },
+				m_offsets{ std::move( offsets ) } {
+
+			daw::exception::daw_throw_on_false( 0 < stride, "{0}: stride must be at least 1", __func__ );
+		}
+
+		uint64_t row_index_t::file_size( ) const noexcept {
+			return m_file_size;
+		}
+
+		int64_t row_index_t::file_time( ) const noexcept {
+			return m_file_time;
+		}
+
+		uint64_t row_index_t::head_hash( ) const noexcept {
+			return m_head_hash;
+		}
+
+		uint64_t row_index_t::stride( ) const noexcept {
+			return m_stride;
+		}
+
+		uint64_t row_index_t::row_count( ) const noexcept {
+			return m_row_count;
+		}
+
+		uint64_t row_index_t::header_first( ) const noexcept {
+			return m_header_first;
+		}
+
+		uint64_t row_index_t::header_last( ) const noexcept {
+			return m_header_last;
+		}
+
+		std::vector<uint64_t> const & row_index_t::offsets( ) const noexcept {
+			return m_offsets;
+		}
+
+		void row_index_t::save( std::string const & index_file_name ) const {
+			std::ofstream out( index_file_name, std::ios::binary | std::ios::trunc );
+			daw::exception::daw_throw_on_false( out.is_open( ), "{0}: Could not open {1} for writing", __func__, index_file_name );
+			out.write( index_magic, sizeof( index_magic ) );
+			write_value( out, m_file_size );
+			write_value( out, m_file_time );
+			write_value( out, m_head_hash );
+			write_value( out, m_stride );
+			write_value( out, m_row_count );
+			write_value( out, m_header_first );
+			write_value( out, m_header_last );
+			write_value( out, static_cast<uint64_t>(m_offsets.size( )) );
+			out.write( reinterpret_cast<char const *>(m_offsets.data( )), static_cast<std::streamsize>(m_offsets.size( ) * sizeof( uint64_t )) );
+			daw::exception::daw_throw_on_false( out.good( ), "{0}: Error writing {1}", __func__, index_file_name );
+		}
+
+		row_index_t row_index_t::load( std::string const & index_file_name ) {
+			std::ifstream in( index_file_name, std::ios::binary );
+			daw::exception::daw_throw_on_false( in.is_open( ), "{0}: Could not open {1}", __func__, index_file_name );
+			char magic[sizeof( index_magic )];
+			in.read( magic, sizeof( magic ) );
+			daw::exception::daw_throw_on_false( in.good( ) && 0 == std::memcmp( magic, index_magic, sizeof( magic ) ), "{0}: {1} is not a row index", __func__, index_file_name );
+			auto const file_size = read_value<uint64_t>( in );
+			auto const file_time = read_value<int64_t>( in );
+			auto const head_hash = read_value<uint64_t>( in );
+			auto const stride = read_value<uint64_t>( in );
+			auto const row_count = read_value<uint64_t>( in );
+			auto const header_first = read_value<uint64_t>( in );
+			auto const header_last = read_value<uint64_t>( in );
+			auto const offset_count = read_value<uint64_t>( in );
+			daw::exception::daw_throw_on_false( in.good( ) && 0 < stride && offset_count == (row_count + stride - 1) / stride, "{0}: {1} is corrupt", __func__, index_file_name );
+			std::vector<uint64_t> offsets( static_cast<size_t>(offset_count) );
+			in.read( reinterpret_cast<char *>(offsets.data( )), static_cast<std::streamsize>(offsets.size( ) * sizeof( uint64_t )) );
+			daw::exception::daw_throw_on_false( in.good( ), "{0}: {1} is truncated", __func__, index_file_name );
+			return row_index_t{ file_size, file_time, head_hash, stride, row_count, header_first, header_last, std::move( offsets ) };
+		}
+
+		uint64_t row_index_t::head_hash( char const * data, size_t size ) noexcept {
+			size = std::min<size_t>( size, 65536 );
+			uint64_t result = 14695981039346656037ULL;
+			for( size_t n = 0; n < size; ++n ) {
+				result ^= static_cast<unsigned char>(data[n]);
+				result *= 1099511628211ULL;
+			}
+			return result;
+		}
+
+		bool row_index_t::matches( uint64_t file_size, int64_t file_time, uint64_t head_hash ) const noexcept {
+			return m_file_size == file_size && m_file_time == file_time && m_head_hash == head_hash;
+		}
+
+		std::string row_index_file_name( std::string const & file_name ) {
+			return file_name + ".rowidx";
+		}
+	}	// namespace data
+}	// namespace daw
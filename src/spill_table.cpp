@@ -0,0 +1,450 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <daw/daw_exception.h>
+#include <daw/daw_newhelper.h>
+
+#include "decimal.h"
+#include "spill_table.h"
+
+// parse_csv_spill is with the tokenizer in data_table.cpp
+
+namespace daw {
+	namespace data {
+		namespace {
+			enum class timestamp_kind_t: uint8_t { value = 0, not_a_date_time = 1, neg_infinity = 2, pos_infinity = 3 };
+
+			boost::posix_time::ptime const & epoch( ) {
+				static boost::posix_time::ptime const result{ boost::gregorian::date{ 1970, 1, 1 } };
+				return result;
+			}
+
+			void put_varint( std::vector<char> & out, uint64_t value ) {
+				while( value >= 0x80 ) {
+					out.push_back( static_cast<char>(static_cast<uint8_t>(value | 0x80)) );
+					value >>= 7;
+				}
+				out.push_back( static_cast<char>(static_cast<uint8_t>(value)) );
+			}
+
+			uint64_t get_varint( char const * & pos ) noexcept {
+				uint64_t result = 0;
+				int shift = 0;
+				while( 0 != (static_cast<uint8_t>(*pos) & 0x80) ) {
+					result |= static_cast<uint64_t>(static_cast<uint8_t>(*pos++) & 0x7F) << shift;
+					shift += 7;
+				}
+				return result | (static_cast<uint64_t>(static_cast<uint8_t>(*pos++)) << shift);
+			}
+
+			/// <summary>Zig zag so small negatives are short varints too</summary>
+			void put_signed( std::vector<char> & out, int64_t value ) {
+				put_varint( out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63) );
+			}
+
+			int64_t get_signed( char const * & pos ) noexcept {
+				auto const value = get_varint( pos );
+				return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+			}
+
+			template<typename T>
+			void put_raw( std::vector<char> & out, T const & value ) {
+				auto const first = reinterpret_cast<char const *>(&value);
+				out.insert( out.end( ), first, first + sizeof( value ) );
+			}
+
+			template<typename T>
+			T get_raw( char const * & pos ) noexcept {
+				T result;
+				std::memcpy( &result, pos, sizeof( result ) );
+				pos += sizeof( result );
+				return result;
+			}
+
+			void put_cell( std::vector<char> & out, DataTable::cell_type const & cell ) {
+				if( cell.empty( ) ) {
+					out.push_back( static_cast<char>(DataCellType::empty_string) );
+					return;
+				}
+				out.push_back( static_cast<char>(cell.type( )) );
+				switch( cell.type( ) ) {
+				case DataCellType::empty_string:
+					break;
+				case DataCellType::integer:
+					put_signed( out, cell.integer( ) );
+					break;
+				case DataCellType::real:
+					put_raw( out, cell.real( ) );
+					break;
+				case DataCellType::string: {
+					auto const value = cell.string_view( );
+					put_varint( out, value.size( ) );
+					out.insert( out.end( ), value.begin( ), value.end( ) );
+					break;
+				}
+				case DataCellType::timestamp: {
+					auto const value = cell.timestamp( );
+					if( value.is_not_a_date_time( ) ) {
+						out.push_back( static_cast<char>(timestamp_kind_t::not_a_date_time) );
+					} else if( value.is_neg_infinity( ) ) {
+						out.push_back( static_cast<char>(timestamp_kind_t::neg_infinity) );
+					} else if( value.is_pos_infinity( ) ) {
+						out.push_back( static_cast<char>(timestamp_kind_t::pos_infinity) );
+					} else {
+						out.push_back( static_cast<char>(timestamp_kind_t::value) );
+						put_signed( out, (value - epoch( )).ticks( ) );
+					}
+					break;
+				}
+				case DataCellType::decimal: {
+					auto const value = cell.decimal( );
+					out.push_back( static_cast<char>(value.scale( )) );
+					put_signed( out, value.units( ) );
+					break;
+				}
+				}
+			}
+
+			DataTable::cell_type get_cell( char const * pos ) {
+				auto const type = static_cast<DataCellType>(*pos++);
+				switch( type ) {
+				case DataCellType::empty_string:
+					return DataTable::cell_type{ };
+				case DataCellType::integer:
+					return DataTable::cell_type{ static_cast<integer_t>(get_signed( pos )) };
+				case DataCellType::real:
+					return DataTable::cell_type{ get_raw<real_t>( pos ) };
+				case DataCellType::string: {
+					auto const str_size = static_cast<size_t>(get_varint( pos ));
+					auto ptr = new_array_throw<char>( str_size + 1 );
+					ptr[str_size] = 0;
+					memcpy( ptr, pos, str_size );
+					daw::cstring value{ ptr };
+					value.take_ownership_of_data( );
+					return DataTable::cell_type{ std::move( value ) };
+				}
+				case DataCellType::timestamp:
+					switch( static_cast<timestamp_kind_t>(*pos++) ) {
+					case timestamp_kind_t::not_a_date_time:
+						return DataTable::cell_type{ timestamp_t{ boost::posix_time::not_a_date_time } };
+					case timestamp_kind_t::neg_infinity:
+						return DataTable::cell_type{ timestamp_t{ boost::posix_time::neg_infin } };
+					case timestamp_kind_t::pos_infinity:
+						return DataTable::cell_type{ timestamp_t{ boost::posix_time::pos_infin } };
+					case timestamp_kind_t::value:
+						return DataTable::cell_type{ epoch( ) + boost::posix_time::time_duration{ 0, 0, 0, get_signed( pos ) } };
+					}
+					break;
+				case DataCellType::decimal: {
+					auto const scale = static_cast<uint8_t>(*pos++);
+					return DataTable::cell_type{ decimal_t{ get_signed( pos ), scale } };
+				}
+				}
+				throw daw::exception::FatalError( std::string( __func__ ) + ": Spill file is corrupt" );
+			}
+		}	// namespace anonymous
+
+		size_t cell_resident_size( DataTable::cell_type const & cell ) noexcept {
+			auto result = sizeof( DataTable::cell_type );
+			if( !cell.empty( ) && DataCellType::string == cell.type( ) ) {
+				result += cell.string_view( ).size( ) + 1;
+			}
+			return result;
+		}
+
+		spill_file_t::spill_file_t( std::string const & directory ):
+				m_path{ },
+				m_out{ },
+				m_size{ 0 },
+				m_buffer{ },
+				m_scratch{ } {
+
+			auto const folder = directory.empty( ) ? boost::filesystem::temp_directory_path( ) : boost::filesystem::path{ directory };
+			m_path = (folder / boost::filesystem::unique_path( "csv_spill_%%%%-%%%%-%%%%-%%%%.bin" )).string( );
+			m_out.open( m_path, std::ios::binary | std::ios::trunc );
+			daw::exception::daw_throw_on_false( m_out.is_open( ), "{0}: Could not open {1} for writing", __func__, m_path );
+		}
+
+		spill_file_t::~spill_file_t( ) {
+			m_buffer.reset( );
+			if( m_out.is_open( ) ) {
+				m_out.close( );
+			}
+			boost::system::error_code ec;
+			boost::filesystem::remove( m_path, ec );	// Nothing to be done about it failing here
+		}
+
+		std::string const & spill_file_t::path( ) const noexcept {
+			return m_path;
+		}
+
+		uint64_t spill_file_t::size( ) const noexcept {
+			return m_size;
+		}
+
+		spill_extent_t spill_file_t::write( DataTable::value_type const & segment ) {
+			daw::exception::daw_throw_on_false( m_out.is_open( ), "{0}: The spill file is finished", __func__ );
+			auto const table_size = segment.size( ) * sizeof( uint32_t );
+			m_scratch.clear( );
+			m_scratch.resize( table_size );
+			for( size_t row = 0; row < segment.size( ); ++row ) {
+				auto const offset = m_scratch.size( ) - table_size;
+				daw::exception::daw_throw_on_true( offset > std::numeric_limits<uint32_t>::max( ), "{0}: Segment is larger than 4GB", __func__ );
+				auto const cell_offset = static_cast<uint32_t>(offset);
+				std::memcpy( m_scratch.data( ) + row * sizeof( uint32_t ), &cell_offset, sizeof( cell_offset ) );
+				put_cell( m_scratch, segment[row] );
+			}
+			m_out.write( m_scratch.data( ), static_cast<std::streamsize>(m_scratch.size( )) );
+			daw::exception::daw_throw_on_false( m_out.good( ), "{0}: Error writing {1}", __func__, m_path );
+			spill_extent_t const result{ m_size, m_scratch.size( ), segment.size( ) };
+			m_size += m_scratch.size( );
+			return result;
+		}
+
+		void spill_file_t::finish( ) {
+			m_out.close( );
+			daw::exception::daw_throw_on_false( m_out.good( ), "{0}: Error writing {1}", __func__, m_path );
+			std::vector<char>{ }.swap( m_scratch );
+			if( 0 < m_size ) {
+				m_buffer = std::make_unique<buffer_t>( m_path, true );
+				daw::exception::daw_throw_on_false( m_buffer->is_open( ) && m_size == m_buffer->size( ), "{0}: Could not map {1}", __func__, m_path );
+			}
+		}
+
+		char const * spill_file_t::segment_data( spill_extent_t const & extent ) const {
+			daw::exception::daw_throw_on_true( !m_buffer || extent.offset + extent.size > m_size, "{0}: Segment is not in the spill file", __func__ );
+			return m_buffer->data( static_cast<size_t>(extent.offset) );
+		}
+
+		DataTable::cell_type spill_file_t::cell( spill_extent_t const & extent, size_t row ) const {
+			daw::exception::daw_throw_on_true( row >= extent.rows, "{0}: Row is past the end of the segment", __func__ );
+			auto const data = segment_data( extent );
+			uint32_t offset;
+			std::memcpy( &offset, data + row * sizeof( uint32_t ), sizeof( offset ) );
+			return get_cell( data + extent.rows * sizeof( uint32_t ) + offset );
+		}
+
+		void spill_file_t::read( spill_extent_t const & extent, DataTable::value_type & out ) const {
+			auto const data = segment_data( extent );
+			auto const cells = data + extent.rows * sizeof( uint32_t );
+			out.reserve( out.size( ) + extent.rows );
+			for( size_t row = 0; row < extent.rows; ++row ) {
+				uint32_t offset;
+				std::memcpy( &offset, data + row * sizeof( uint32_t ), sizeof( offset ) );
+				out.append( get_cell( cells + offset ) );
+			}
+		}
+
+		constexpr size_t const spill_table_t::min_segment_rows;
+		constexpr size_t const spill_table_t::max_segment_rows;
+
+		spill_table_t::spill_table_t( size_t segment_rows, std::vector<DataTable::value_type> columns, std::vector<std::vector<segment_t>> segments, std::shared_ptr<spill_file_t> file ):
+				m_columns{ },
+				m_file{ std::move( file ) },
+				m_segment_rows{ segment_rows },
+				m_row_count{ 0 } {
+
+			daw::exception::daw_throw_on_false( 0 < segment_rows, "{0}: Segments must hold at least one row", __func__ );
+			daw::exception::daw_throw_on_true( columns.size( ) != segments.size( ), "{0}: Each column needs segments", __func__ );
+			m_columns.reserve( columns.size( ) );
+			for( size_t n = 0; n < columns.size( ); ++n ) {
+				daw::exception::daw_throw_on_false( columns[n].empty( ), "{0}: Columns must be empty", __func__ );
+				DataTable::size_type rows = 0;
+				for( size_t s = 0; s < segments[n].size( ); ++s ) {
+					auto const & current = segments[n][s];
+					auto const segment_size = current.extent ? current.extent->rows : current.cells.size( );
+					daw::exception::daw_throw_on_true( current.extent && !m_file, "{0}: Spilled segments need their file", __func__ );
+					daw::exception::daw_throw_on_true( s + 1 < segments[n].size( ) && m_segment_rows != segment_size, "{0}: Only the last segment may be short", __func__ );
+					rows += segment_size;
+				}
+				daw::exception::daw_throw_on_true( 0 < n && rows != m_row_count, "{0}: Columns must have the same number of rows", __func__ );
+				m_row_count = rows;
+				m_columns.push_back( column_t{ std::move( columns[n] ), std::move( segments[n] ) } );
+			}
+		}
+
+		DataTable::size_type spill_table_t::size( ) const noexcept {
+			return m_columns.size( );
+		}
+
+		bool spill_table_t::empty( ) const noexcept {
+			return m_columns.empty( );
+		}
+
+		DataTable::size_type spill_table_t::row_count( ) const noexcept {
+			return m_row_count;
+		}
+
+		spill_table_t::column_t const & spill_table_t::column_at( DataTable::size_type column ) const {
+			daw::exception::daw_throw_on_true( column >= m_columns.size( ), "{0}: Column does not exist", __func__ );
+			return m_columns[column];
+		}
+
+		spill_table_t::segment_t const & spill_table_t::segment_at( DataTable::size_type column, size_t segment ) const {
+			auto const & current = column_at( column );
+			daw::exception::daw_throw_on_true( segment >= current.segments.size( ), "{0}: Segment does not exist", __func__ );
+			return current.segments[segment];
+		}
+
+		std::string const & spill_table_t::header( DataTable::size_type column ) const {
+			return column_at( column ).prototype.header( );
+		}
+
+		DataTable::size_type spill_table_t::get_column_index( boost::string_view column_name ) const {
+			auto pos = std::find_if( m_columns.begin( ), m_columns.end( ), [column_name]( column_t const & column ) {
+				return column_name == column.prototype.header( );
+			} );
+			daw::exception::daw_throw_on_true( m_columns.end( ) == pos, "{0}: Column does not exist", __func__ );
+			return static_cast<DataTable::size_type>(std::distance( m_columns.begin( ), pos ));
+		}
+
+		spill_column_t spill_table_t::item( DataTable::size_type column ) const {
+			column_at( column );
+			return spill_column_t{ *this, column };
+		}
+
+		spill_column_t spill_table_t::item( boost::string_view column ) const {
+			return spill_column_t{ *this, get_column_index( column ) };
+		}
+
+		spill_column_t spill_table_t::operator[]( DataTable::size_type column ) const {
+			return item( column );
+		}
+
+		spill_column_t spill_table_t::operator[]( boost::string_view column ) const {
+			return item( column );
+		}
+
+		size_t spill_table_t::segment_rows( ) const noexcept {
+			return m_segment_rows;
+		}
+
+		size_t spill_table_t::segment_count( ) const noexcept {
+			return m_columns.empty( ) ? 0 : m_columns.front( ).segments.size( );
+		}
+
+		bool spill_table_t::is_spilled( DataTable::size_type column, size_t segment ) const {
+			return static_cast<bool>(segment_at( column, segment ).extent);
+		}
+
+		size_t spill_table_t::resident_size( ) const noexcept {
+			size_t result = 0;
+			for( auto const & column : m_columns ) {
+				for( auto const & current : column.segments ) {
+					for( auto const & cell : current.cells ) {
+						result += cell_resident_size( cell );
+					}
+				}
+			}
+			return result;
+		}
+
+		uint64_t spill_table_t::spilled_size( ) const noexcept {
+			return m_file ? m_file->size( ) : 0;
+		}
+
+		DataTable::cell_type spill_table_t::cell( DataTable::size_type column, DataTable::size_type row ) const {
+			daw::exception::daw_throw_on_true( row >= m_row_count, "{0}: Row does not exist", __func__ );
+			auto const & current = segment_at( column, row / m_segment_rows );
+			if( current.extent ) {
+				return m_file->cell( *current.extent, row % m_segment_rows );
+			}
+			return current.cells[row % m_segment_rows];
+		}
+
+		DataTable::value_type spill_table_t::segment( DataTable::size_type column, size_t segment ) const {
+			auto const & current = segment_at( column, segment );
+			if( !current.extent ) {
+				return current.cells;
+			}
+			auto result = column_at( column ).prototype;
+			m_file->read( *current.extent, result );
+			return result;
+		}
+
+		DataTable::value_type spill_table_t::column( DataTable::size_type column ) const {
+			auto const & current = column_at( column );
+			auto result = current.prototype;
+			result.reserve( m_row_count );
+			for( auto const & part : current.segments ) {
+				if( part.extent ) {
+					m_file->read( *part.extent, result );
+				} else {
+					result.append( part.cells.begin( ), part.cells.end( ) );
+				}
+			}
+			return result;
+		}
+
+		DataTable spill_table_t::load( ) const {
+			DataTable result;
+			for( DataTable::size_type n = 0; n < m_columns.size( ); ++n ) {
+				result.append( column( n ) );
+			}
+			return result;
+		}
+
+		spill_column_t::spill_column_t( spill_table_t const & table, DataTable::size_type column ):
+				m_table{ &table },
+				m_column{ column } { }
+
+		std::string const & spill_column_t::header( ) const {
+			return m_table->header( m_column );
+		}
+
+		DataTable::size_type spill_column_t::size( ) const noexcept {
+			return m_table->row_count( );
+		}
+
+		bool spill_column_t::empty( ) const noexcept {
+			return 0 == size( );
+		}
+
+		DataTable::cell_type spill_column_t::item( DataTable::size_type row ) const {
+			return m_table->cell( m_column, row );
+		}
+
+		DataTable::cell_type spill_column_t::operator[]( DataTable::size_type row ) const {
+			return item( row );
+		}
+
+		DataTable::value_type spill_column_t::load( ) const {
+			return m_table->column( m_column );
+		}
+
+		size_t spill_segment_rows( boost::optional<size_t> const & memory_budget, size_t columns ) noexcept {
+			if( !memory_budget || 0 == columns ) {
+				return spill_table_t::max_segment_rows;
+			}
+			auto const rows = *memory_budget / 2 / (columns * sizeof( DataTable::cell_type ));
+			return std::min( std::max( rows, spill_table_t::min_segment_rows ), spill_table_t::max_segment_rows );
+		}
+	}	// namespace data
+}	// namespace daw
@@ -20,47 +20,85 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <iomanip>
+#include <locale>
+#include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 
-#include <daw/daw_string.h>
-
 #include "string_helpers.h"
 
 namespace daw {
 	namespace string {
-		std::string ptime_to_string( const boost::posix_time::ptime& value, const std::string& format, const std::string locale_str ) {
-			try {
-				static std::stringstream ss( "" );
-				static std::unique_ptr<boost::posix_time::time_facet> facet;
-				if( !facet ) {
-					facet = std::make_unique<boost::posix_time::time_facet>( 1u );
-					ss.imbue( std::locale( std::locale( locale_str.c_str( ) ), facet.get( ) ) );
+		namespace {
+			/// <summary>A string stream imbued with a time facet.  Each thread keeps its own, so formatting and parsing
+			/// timestamps is reentrant without locking</summary>
+			template<typename Facet, typename Stream>
+			struct time_stream_t {
+				Stream stream;
+				Facet * facet;	// Owned by the stream's locale
+
+				explicit time_stream_t( std::locale const & base ):
+						stream{ },
+						facet{ new Facet{ } } {
+
+					stream.imbue( std::locale( base, facet ) );
 				}
-				clear( ss );
-				facet->format( format.c_str( ) );
-				ss << value;
-				return ss.str( );
-			} catch( const std::exception& ex ) {
-				throw ex;
+			};
+
+			using time_output_stream_t = time_stream_t<boost::posix_time::time_facet, std::ostringstream>;
+			using time_input_stream_t = time_stream_t<boost::posix_time::time_input_facet, std::istringstream>;
+
+			/// <summary>The stream of this thread for locale_str.  One is kept per locale used, so alternating locales does not
+			/// rebuild the locale and facet each call</summary>
+			std::ostringstream & time_output_stream( std::string const & format, std::string const & locale_str ) {
+				thread_local std::map<std::string, std::unique_ptr<time_output_stream_t>> streams;
+				auto & result = streams[locale_str];
+				if( !result ) {
+					result = std::make_unique<time_output_stream_t>( std::locale( locale_str.c_str( ) ) );
+				}
+				result->facet->format( format.c_str( ) );
+				result->stream.str( "" );
+				result->stream.clear( );
+				return result->stream;
 			}
+
+			std::istringstream & time_input_stream( std::string const & format ) {
+				thread_local std::unique_ptr<time_input_stream_t> result;
+				if( !result ) {
+					result = std::make_unique<time_input_stream_t>( std::locale( ) );
+				}
+				result->facet->format( format.c_str( ) );
+				result->stream.clear( );
+				return result->stream;
+			}
+		}	// namespace anonymous
+
+		std::string ptime_to_string( const boost::posix_time::ptime& value, const std::string& format, const std::string locale_str ) {
+			auto & ss = time_output_stream( format, locale_str );
+			ss << value;
+			return ss.str( );
 		}
 
 		std::string ptime_to_string( const boost::posix_time::time_duration& value, bool show_seconds ) {
-			try {
-				static std::stringstream ss( "" );
-				clear( ss );
-				ss << std::setw( 2 ) << std::setfill( '0' ) << value.hours( );
+			std::ostringstream ss;
+			ss << std::setw( 2 ) << std::setfill( '0' ) << value.hours( );
+			ss << ":";
+			ss << std::setw( 2 ) << std::setfill( '0' ) << value.minutes( );
+			if( show_seconds ) {
 				ss << ":";
-				ss << std::setw( 2 ) << std::setfill( '0' ) << value.minutes( );
-				if( show_seconds ) {
-					ss << ":";
-					ss << std::setw( 2 ) << std::setfill( '0' ) << value.seconds( );
-				}
-				return ss.str( );
-			} catch( const std::exception& ex ) {
-				throw ex;
+				ss << std::setw( 2 ) << std::setfill( '0' ) << value.seconds( );
 			}
+			return ss.str( );
+		}
+
+		boost::posix_time::ptime string_to_ptime( const std::string& value, const std::string& format ) {
+			auto & ss = time_input_stream( format );
+			ss.str( value );
+			boost::posix_time::ptime result;
+			ss >> result;
+			return result;
 		}
 	}	// namespace string
 }	// namespace daw
@@ -0,0 +1,258 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "task_scheduler.h"
+
+namespace daw {
+	namespace data {
+		namespace {
+			// Lets a worker push to and pop from its own queue
+			thread_local task_scheduler const * tl_scheduler = nullptr;
+			thread_local size_t tl_queue = 0;
+
+			size_t default_thread_count( size_t thread_count ) noexcept {
+				if( 0 == thread_count ) {
+					thread_count = static_cast<size_t>(std::thread::hardware_concurrency( ));
+				}
+				return 0 == thread_count ? 1 : thread_count;
+			}
+
+			std::mutex & global_scheduler_mutex( ) {
+				static std::mutex result;
+				return result;
+			}
+
+			std::shared_ptr<task_scheduler> & global_scheduler( ) {
+				static std::shared_ptr<task_scheduler> result;
+				return result;
+			}
+
+			/// <summary>The last reference to a replaced library scheduler can be dropped by a task running on one of its
+			/// own workers, which cannot join itself.  That worker hands the destruction to a new thread and carries on
+			/// draining</summary>
+			std::shared_ptr<task_scheduler> make_library_scheduler( size_t thread_count ) {
+				return std::shared_ptr<task_scheduler>( new task_scheduler{ thread_count }, []( task_scheduler * scheduler ) {
+					if( scheduler == tl_scheduler ) {
+						std::thread{ [scheduler]( ) {
+							delete scheduler;
+						} }.detach( );
+					} else {
+						delete scheduler;
+					}
+				} );
+			}
+		}	// namespace anonymous
+
+		task_scheduler::task_scheduler( size_t thread_count ):
+				m_queues{ },
+				m_threads{ },
+				m_wake_mutex{ },
+				m_wake{ },
+				m_pending{ 0 },
+				m_next_queue{ 0 },
+				m_stop{ false },
+				m_error_mutex{ },
+				m_error{ } {
+
+			thread_count = default_thread_count( thread_count );
+			for( size_t n = 0; n < thread_count; ++n ) {
+				m_queues.push_back( std::make_unique<task_queue_t>( ) );
+			}
+			m_threads.reserve( thread_count );
+			for( size_t n = 0; n < thread_count; ++n ) {
+				m_threads.emplace_back( [this, n]( ) {
+					worker( n );
+				} );
+			}
+		}
+
+		task_scheduler::~task_scheduler( ) {
+			{
+				std::lock_guard<std::mutex> lock{ m_wake_mutex };
+				m_stop = true;
+			}
+			m_wake.notify_all( );
+			for( auto & thread : m_threads ) {
+				thread.join( );
+			}
+		}
+
+		size_t task_scheduler::size( ) const noexcept {
+			return m_queues.size( );
+		}
+
+		void task_scheduler::add_task( task_t task ) {
+			add_task( std::move( task ), nullptr );
+		}
+
+		void task_scheduler::add_task( task_t task, task_group const & group ) {
+			add_task( std::move( task ), &group );
+		}
+
+		void task_scheduler::add_task( task_t task, task_group const * group ) {
+			auto const queue = this == tl_scheduler ? tl_queue : m_next_queue++ % m_queues.size( );
+			{
+				// Counted before it is visible so a thief can never take m_pending below the number of queued tasks
+				std::lock_guard<std::mutex> lock{ m_queues[queue]->mutex };
+				++m_pending;
+				try {
+					m_queues[queue]->tasks.push_back( queued_task_t{ std::move( task ), group } );
+				} catch( ... ) {
+					--m_pending;
+					throw;
+				}
+			}
+			std::lock_guard<std::mutex> lock{ m_wake_mutex };
+			m_wake.notify_one( );
+		}
+
+		bool task_scheduler::pop_task( size_t home, task_t & task ) {
+			{
+				auto & own = *m_queues[home];
+				std::lock_guard<std::mutex> lock{ own.mutex };
+				if( !own.tasks.empty( ) ) {
+					task = std::move( own.tasks.back( ).task );
+					own.tasks.pop_back( );
+					--m_pending;
+					return true;
+				}
+			}
+			for( size_t n = 1; n < m_queues.size( ); ++n ) {
+				auto & victim = *m_queues[(home + n) % m_queues.size( )];
+				std::lock_guard<std::mutex> lock{ victim.mutex };
+				if( !victim.tasks.empty( ) ) {
+					task = std::move( victim.tasks.front( ).task );
+					victim.tasks.pop_front( );
+					--m_pending;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		bool task_scheduler::pop_group_task( size_t home, task_group const & group, task_t & task ) {
+			// Newest first in the home queue and oldest first elsewhere, as with pop_task.  A group has at most a few
+			// tasks queued per worker, so the linear search is short
+			for( size_t n = 0; n < m_queues.size( ); ++n ) {
+				auto & queue = *m_queues[(home + n) % m_queues.size( )];
+				std::lock_guard<std::mutex> lock{ queue.mutex };
+				auto const is_member = [&group]( queued_task_t const & item ) {
+					return &group == item.group;
+				};
+				auto pos = queue.tasks.end( );
+				if( 0 == n ) {
+					auto const rpos = std::find_if( queue.tasks.rbegin( ), queue.tasks.rend( ), is_member );
+					if( queue.tasks.rend( ) != rpos ) {
+						pos = std::prev( rpos.base( ) );
+					}
+				} else {
+					pos = std::find_if( queue.tasks.begin( ), queue.tasks.end( ), is_member );
+				}
+				if( queue.tasks.end( ) != pos ) {
+					task = std::move( pos->task );
+					queue.tasks.erase( pos );
+					--m_pending;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		bool task_scheduler::run_one( ) {
+			task_t task;
+			if( 0 == m_pending || !pop_task( this == tl_scheduler ? tl_queue : 0, task ) ) {
+				return false;
+			}
+			run_task( task );
+			return true;
+		}
+
+		bool task_scheduler::run_one( task_group const & group ) {
+			task_t task;
+			if( 0 == m_pending || !pop_group_task( this == tl_scheduler ? tl_queue : 0, group, task ) ) {
+				return false;
+			}
+			run_task( task );
+			return true;
+		}
+
+		std::exception_ptr task_scheduler::take_error( ) {
+			std::lock_guard<std::mutex> lock{ m_error_mutex };
+			std::exception_ptr result;
+			result.swap( m_error );
+			return result;
+		}
+
+		void task_scheduler::run_task( task_t & task ) noexcept {
+			try {
+				task( );
+			} catch( ... ) {
+				std::lock_guard<std::mutex> lock{ m_error_mutex };
+				if( !m_error ) {
+					m_error = std::current_exception( );
+				}
+			}
+			task = nullptr;
+		}
+
+		void task_scheduler::worker( size_t index ) {
+			tl_scheduler = this;
+			tl_queue = index;
+			task_t task;
+			while( true ) {
+				if( pop_task( index, task ) ) {
+					run_task( task );
+					continue;
+				}
+				std::unique_lock<std::mutex> lock{ m_wake_mutex };
+				if( m_stop && 0 == m_pending ) {	// Stop only once the queues are drained
+					break;
+				}
+				m_wake.wait( lock, [this]( ) {
+					return m_stop || 0 < m_pending;
+				} );
+			}
+		}
+
+		std::shared_ptr<task_scheduler> get_task_scheduler( ) {
+			std::lock_guard<std::mutex> lock{ global_scheduler_mutex( ) };
+			auto & result = global_scheduler( );
+			if( !result ) {
+				result = make_library_scheduler( 0 );
+			}
+			return result;
+		}
+
+		void set_task_scheduler_thread_count( size_t thread_count ) {
+			auto scheduler = make_library_scheduler( thread_count );
+			{
+				std::lock_guard<std::mutex> lock{ global_scheduler_mutex( ) };
+				global_scheduler( ).swap( scheduler );
+			}
+			scheduler.reset( );	// Outside the lock, as it may wait for the old scheduler's tasks
+		}
+	}	// namespace data
+}	// namespace daw
@@ -20,6 +20,9 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <boost/functional/hash.hpp>
+#include <cstring>
+
 #include <daw/daw_exception.h>
 #include <daw/daw_newhelper.h>
 #include <daw/daw_operators.h>
@@ -44,6 +47,23 @@ namespace daw {
 	namespace data {
 		Variant::Variant( ) : m_type{DataCellType::empty_string}, m_value{} {}
 
+		Variant::Variant( Variant const &other ) : m_type{other.m_type}, m_value{other.m_value} {
+			if( m_value && DataCellType::string == m_type ) {
+				auto &str = get<daw::cstring>( m_value );
+				if( !str.is_null( ) && !str.is_local_string( ) ) {
+					str = daw::cstring( str.get( ), true, str.size( ) );
+				}
+			}
+		}
+
+		Variant &Variant::operator=( Variant const &rhs ) {
+			if( this != &rhs ) {
+				Variant tmp{rhs};
+				swap( tmp );
+			}
+			return *this;
+		}
+
 		Variant::Variant( Variant &&value ) noexcept
 		    : m_type{std::move( value.m_type )}, m_value{std::move( value.m_value )} {
 
@@ -88,6 +108,8 @@ namespace daw {
 
 		Variant::Variant( timestamp_t value ) : m_type{DataCellType::timestamp}, m_value{std::move( value )} {}
 
+		Variant::Variant( decimal_t value ) : m_type{DataCellType::decimal}, m_value{std::move( value )} {}
+
 		namespace {
 			daw::cstring copy_when_needed( daw::cstring value ) {
 				if( !value.is_local_string( ) ) {
@@ -102,6 +124,15 @@ namespace daw {
 		    : m_type{value.is_null( ) ? DataCellType::empty_string : DataCellType::string}
 		    , m_value{copy_when_needed( std::move( value ) )} {};
 
+		Variant Variant::borrowed( daw::cstring value ) {
+			Variant result;
+			if( !value.is_null( ) ) {
+				result.m_type = DataCellType::string;
+				result.m_value = std::move( value );
+			}
+			return result;
+		}
+
 		integer_t const &Variant::integer( ) const {
 			dbg_throw_on_false( DataCellType::integer == m_type,
 			                    "{0}: Attempt to extract an integer from a non-integer", __func__ );
@@ -120,6 +151,12 @@ namespace daw {
 			return get<timestamp_t>( m_value );
 		}
 
+		decimal_t const &Variant::decimal( ) const {
+			dbg_throw_on_false( DataCellType::decimal == m_type,
+			                    "{0}: Attempt to extract a decimal from a non-decimal", __func__ );
+			return get<decimal_t>( m_value );
+		}
+
 		std::string Variant::string( std::string locale ) const {
 			switch( m_type ) {
 			case DataCellType::integer:
@@ -128,6 +165,8 @@ namespace daw {
 				return boost::lexical_cast<std::string>( real( ) );
 			case DataCellType::timestamp:
 				return daw::string::ptime_to_string( timestamp( ), "%Y-%m-%d %H:%M:%S %Z", locale );
+			case DataCellType::decimal:
+				return decimal( ).to_string( );
 			case DataCellType::empty_string:
 				return "";
 			case DataCellType::string:
@@ -140,6 +179,17 @@ namespace daw {
 			    string_join( __func__, ": Unexpected control path taken.  This should never happen" ) );
 		}
 
+		boost::string_view Variant::string_view( ) const noexcept {
+			if( DataCellType::string != m_type || !m_value ) {
+				return boost::string_view{ };
+			}
+			auto const & str = get<daw::cstring>( m_value );
+			if( str.is_null( ) ) {
+				return boost::string_view{ };
+			}
+			return boost::string_view{ str.get( ), str.size( ) };
+		}
+
 		bool Variant::empty( ) const noexcept {
 			return !m_value || DataCellType::empty_string == m_type ||
 			       ( DataCellType::string == m_type && get<daw::cstring>( m_value ).is_null( ) );
@@ -157,11 +207,6 @@ namespace daw {
 			inline int compare( const ValueType &lhs, const ValueType &rhs ) noexcept {
 				return lhs > rhs ? 1 : lhs < rhs ? -1 : 0;
 			}
-
-			template<>
-			inline int compare<std::string>( const std::string &lhs, const std::string &rhs ) noexcept {
-				return lhs.compare( rhs );
-			}
 		} // namespace impl
 
 		int Variant::compare( Variant const &lhs, Variant const &rhs ) {
@@ -170,13 +215,15 @@ namespace daw {
 			case DataCellType::empty_string:
 				return 0;
 			case DataCellType::string:
-				return impl::compare( lhs.string( ), rhs.string( ) );
+				return lhs.string_view( ).compare( rhs.string_view( ) );
 			case DataCellType::integer:
 				return impl::compare( lhs.integer( ), rhs.integer( ) );
 			case DataCellType::real:
 				return impl::compare( lhs.real( ), rhs.real( ) );
 			case DataCellType::timestamp:
 				return impl::compare( lhs.timestamp( ), rhs.timestamp( ) );
+			case DataCellType::decimal:
+				return decimal_t::compare( lhs.decimal( ), rhs.decimal( ) );
 			default:
 				throw NotImplemented( string_join( __func__, ": Compare for datatype not implemented" ) );
 			}
@@ -186,6 +233,73 @@ namespace daw {
 			return Variant::compare( *this, rhs );
 		}
 
+		namespace {
+			std::size_t hash_bytes( boost::string_view str ) noexcept {
+				// FNV-1a
+				std::uint64_t result = 14695981039346656037ULL;
+				for( auto const c : str ) {
+					result ^= static_cast<unsigned char>( c );
+					result *= 1099511628211ULL;
+				}
+				return static_cast<std::size_t>( result );
+			}
+
+			std::size_t hash_real( real_t value ) noexcept {
+				if( value == 0 ) {
+					value = 0; // -0.0 == 0.0
+				}
+				std::uint64_t bits = 0;
+				static_assert( sizeof( bits ) == sizeof( value ), "real_t is expected to be 64 bits" );
+				std::memcpy( &bits, &value, sizeof( bits ) );
+				return boost::hash_value( bits );
+			}
+		} // namespace
+
+		std::size_t Variant::hash( ) const {
+			std::size_t result = static_cast<std::size_t>( type( ) );
+			switch( type( ) ) {
+			case DataCellType::empty_string:
+			case DataCellType::string:
+				boost::hash_combine( result, hash_bytes( string_view( ) ) );
+				break;
+			case DataCellType::integer:
+				boost::hash_combine( result, integer( ) );
+				break;
+			case DataCellType::real:
+				boost::hash_combine( result, hash_real( real( ) ) );
+				break;
+			case DataCellType::timestamp:
+				boost::hash_combine( result, timestamp( ).date( ).day_number( ) );
+				boost::hash_combine( result, timestamp( ).time_of_day( ).ticks( ) );
+				break;
+			case DataCellType::decimal:
+				boost::hash_combine( result, decimal( ).hash( ) );
+				break;
+			}
+			return result;
+		}
+
+		bool Variant::equal( Variant const &lhs, Variant const &rhs ) {
+			if( lhs.type( ) != rhs.type( ) ) {
+				return false;
+			}
+			switch( lhs.type( ) ) {
+			case DataCellType::empty_string:
+			case DataCellType::string:
+				return lhs.string_view( ) == rhs.string_view( );
+			case DataCellType::integer:
+				return lhs.integer( ) == rhs.integer( );
+			case DataCellType::real:
+				return lhs.real( ) == rhs.real( );
+			case DataCellType::timestamp:
+				return lhs.timestamp( ) == rhs.timestamp( );
+			case DataCellType::decimal:
+				return lhs.decimal( ) == rhs.decimal( );
+			}
+			throw AssertException(
+			    string_join( __func__, ": Unexpected control path taken.  This should never happen" ) );
+		}
+
 		create_comparison_operators( Variant );
 
 		void swap( Variant &lhs, Variant &rhs ) noexcept {
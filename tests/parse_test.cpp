@@ -0,0 +1,580 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Tests of the parse entry points over small CSV files written to the temporary directory
+
+#define BOOST_TEST_MODULE csv_helper_parse_test
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cancellation_token.h"
+#include "data_table.h"
+#include "decimal.h"
+#include "lazy_table.h"
+#include "memory_arena.h"
+#include "parse_async.h"
+#include "parse_files.h"
+#include "row_index.h"
+#include "spill_table.h"
+
+namespace {
+	using namespace daw::data;
+
+	/// <summary>A CSV file holding contents that is removed again by the destructor</summary>
+	class temp_csv_t final {
+		boost::filesystem::path m_path;
+	public:
+		explicit temp_csv_t( std::string const & contents, boost::filesystem::path directory = boost::filesystem::temp_directory_path( ) ):
+				m_path{ directory / boost::filesystem::unique_path( "csv_helper_test_%%%%-%%%%-%%%%.csv" ) } {
+
+			std::ofstream out( m_path.string( ), std::ios::binary );
+			out << contents;
+		}
+
+		~temp_csv_t( ) {
+			boost::system::error_code ec;
+			boost::filesystem::remove( m_path, ec );
+		}
+
+		temp_csv_t( temp_csv_t const & ) = delete;
+		temp_csv_t & operator=( temp_csv_t const & ) = delete;
+
+		std::string file_name( ) const {
+			return m_path.string( );
+		}
+	};
+
+	/// <summary>An empty directory that is removed with its contents by the destructor</summary>
+	class temp_directory_t final {
+		boost::filesystem::path m_path;
+	public:
+		temp_directory_t( ):
+				m_path{ boost::filesystem::temp_directory_path( ) / boost::filesystem::unique_path( "csv_helper_test_%%%%-%%%%-%%%%" ) } {
+
+			boost::filesystem::create_directory( m_path );
+		}
+
+		~temp_directory_t( ) {
+			boost::system::error_code ec;
+			boost::filesystem::remove_all( m_path, ec );
+		}
+
+		temp_directory_t( temp_directory_t const & ) = delete;
+		temp_directory_t & operator=( temp_directory_t const & ) = delete;
+
+		boost::filesystem::path const & path( ) const noexcept {
+			return m_path;
+		}
+	};
+
+	DataTable::value_type make_column( std::string header, std::initializer_list<DataCell> cells ) {
+		DataTable::value_type result{ std::move( header ) };
+		for( auto const & cell : cells ) {
+			result.append( cell );
+		}
+		return result;
+	}
+
+	std::string const numbers_csv = "id,value,name\n11,1.5,aa\n12,2.5,bb\n13,,cc\n14,4.5,dd\n";
+
+	operation_cancelled::reason_t cancel_reason( parse_csv_data_param const & param ) {
+		try {
+			parse_csv_data( param ).get( );
+		} catch( operation_cancelled const & ex ) {
+			return ex.reason( );
+		}
+		BOOST_FAIL( "parse_csv_data was not cancelled" );
+		return operation_cancelled::reason_t::cancelled;
+	}
+}	// namespace anonymous
+
+BOOST_AUTO_TEST_CASE( parse_whole_file ) {
+	temp_csv_t const file{ numbers_csv };
+	auto const table = parse_csv_data( file.file_name( ), 0 ).get( );
+	BOOST_REQUIRE_EQUAL( table.size( ), 3u );
+	BOOST_REQUIRE_EQUAL( table["id"].size( ), 4u );
+	BOOST_CHECK_EQUAL( table["id"][3].integer( ), 14 );
+	BOOST_CHECK( table["value"][2].empty( ) );
+	BOOST_CHECK_EQUAL( table["name"][1].string( ), "bb" );
+}
+
+BOOST_AUTO_TEST_CASE( parse_stats_and_progress ) {
+	temp_csv_t const file{ numbers_csv };
+	std::vector<parse_phase> phases;
+	parse_csv_data_param const param{ file.file_name( ), 0, nullptr, [&phases]( parse_progress const & progress ) {
+		phases.push_back( progress.phase );
+		BOOST_CHECK_LE( progress.bytes_processed, progress.bytes_total );
+	} };
+	parse_stats stats;
+	parse_csv_data( param, stats ).get( );
+	BOOST_CHECK_EQUAL( stats.bytes, numbers_csv.size( ) );
+	BOOST_CHECK_EQUAL( stats.rows, 4u );
+	BOOST_CHECK_EQUAL( stats.columns, 3u );
+	BOOST_CHECK_EQUAL( stats.integer_cells, 4u );
+	BOOST_CHECK_EQUAL( stats.real_cells, 3u );
+	BOOST_CHECK_EQUAL( stats.empty_cells, 1u );
+	BOOST_CHECK_EQUAL( stats.string_cells, 4u );
+	BOOST_CHECK_EQUAL( stats.cells( ), 12u );
+	BOOST_CHECK_EQUAL( stats.ragged_rows, 0u );
+	BOOST_CHECK_GE( stats.estimated_allocations, stats.string_cells );
+	BOOST_CHECK_GE( stats.total_seconds, stats.convert_seconds );
+	BOOST_REQUIRE( !phases.empty( ) );
+	BOOST_CHECK( parse_phase::complete == phases.back( ) );
+}
+
+BOOST_AUTO_TEST_CASE( parse_ragged_rows_pad_columns ) {
+	temp_csv_t const file{ "id,value,name\n11,22,aa\n12,23\n" };
+	parse_csv_data_param const param{ file.file_name( ), 0 };
+	parse_stats stats;
+	auto const table = parse_csv_data( param, stats ).get( );
+	BOOST_CHECK_EQUAL( stats.ragged_rows, 1u );
+	BOOST_REQUIRE_EQUAL( table["name"].size( ), 2u );
+	BOOST_CHECK( table["name"][1].empty( ) );
+
+	parse_stats sparse_stats;
+	auto const columns = parse_csv_sparse( param, sparse_stats ).get( );
+	BOOST_CHECK_EQUAL( sparse_stats.ragged_rows, 1u );
+	BOOST_REQUIRE_EQUAL( columns.size( ), 3u );
+	BOOST_REQUIRE_EQUAL( columns[2].size( ), 2u );
+	BOOST_CHECK( columns[2][1].empty( ) );
+
+	auto lazy = parse_csv_lazy( param );
+	auto & lazy_table = lazy.get( );
+	BOOST_REQUIRE_EQUAL( lazy_table.row_count( ), 2u );
+	BOOST_CHECK( lazy_table["name"][1].empty( ) );
+}
+
+BOOST_AUTO_TEST_CASE( parse_cancelled ) {
+	temp_csv_t const file{ numbers_csv };
+	parse_csv_data_param param{ file.file_name( ), 0 };
+	cancellation_token token;
+	param.set_cancel_token( token );
+	token.cancel( );
+	BOOST_CHECK( operation_cancelled::reason_t::cancelled == cancel_reason( param ) );
+}
+
+BOOST_AUTO_TEST_CASE( parse_past_deadline ) {
+	temp_csv_t const file{ numbers_csv };
+	parse_csv_data_param param{ file.file_name( ), 0 };
+	param.set_deadline( parse_clock_t::now( ) - std::chrono::seconds( 1 ) );
+	BOOST_CHECK( operation_cancelled::reason_t::deadline == cancel_reason( param ) );
+}
+
+BOOST_AUTO_TEST_CASE( parse_files_in_order ) {
+	temp_directory_t const directory;
+	temp_csv_t const first{ "id,name\n11,aa\n12,bb\n", directory.path( ) };
+	temp_csv_t const second{ "id,name\n13,cc\n", directory.path( ) };
+
+	auto const table = parse_csv_files( { second.file_name( ), first.file_name( ) }, parse_csv_data_param{ "", 0 } ).get( );
+	BOOST_REQUIRE_EQUAL( table["id"].size( ), 3u );
+	BOOST_CHECK_EQUAL( table["id"][0].integer( ), 13 );
+	BOOST_CHECK_EQUAL( table["id"][2].integer( ), 12 );
+
+	auto const found = parse_csv_files( directory.path( ).string( ), "*.csv", parse_csv_data_param{ "", 0 } ).get( );
+	BOOST_CHECK_EQUAL( found["name"].size( ), 3u );
+}
+
+BOOST_AUTO_TEST_CASE( parse_files_mismatched_headers ) {
+	temp_directory_t const directory;
+	temp_csv_t const first{ "id,name\n11,aa\n", directory.path( ) };
+	temp_csv_t const second{ "id,other\n12,bb\n", directory.path( ) };
+	BOOST_CHECK( parse_csv_files( { first.file_name( ), second.file_name( ) }, parse_csv_data_param{ "", 0 } ).has_exception( ) );
+}
+
+BOOST_AUTO_TEST_CASE( parse_with_sketches ) {
+	temp_csv_t const file{ numbers_csv };
+	parse_csv_data_param param{ file.file_name( ), 0 };
+	BOOST_CHECK( !parse_csv_data( param ).get( )["id"].sketches( ) );
+	param.set_sketches( true );
+	auto const table = parse_csv_data( param ).get( );
+	BOOST_REQUIRE( table["id"].sketches( ) );
+	BOOST_CHECK_EQUAL( table["id"].sketches( )->quantiles.count( ), 4u );
+	BOOST_CHECK_CLOSE( table["name"].sketches( )->distinct.estimate( ), 4.0, 10.0 );
+}
+
+BOOST_AUTO_TEST_CASE( parse_row_limit ) {
+	temp_csv_t const file{ numbers_csv };
+	parse_csv_data_param param{ file.file_name( ), 0 };
+	param.set_row_limit( 2 );
+	auto const table = parse_csv_data( param ).get( );
+	BOOST_REQUIRE_EQUAL( table["id"].size( ), 2u );
+	BOOST_CHECK_EQUAL( table["id"][1].integer( ), 12 );
+}
+
+BOOST_AUTO_TEST_CASE( parse_sample ) {
+	temp_csv_t const file{ numbers_csv };
+	parse_csv_data_param param{ file.file_name( ), 0 };
+	param.set_sample( 2, 7 );
+	auto const table = parse_csv_data( param ).get( );
+	BOOST_REQUIRE_EQUAL( table["id"].size( ), 2u );
+	BOOST_CHECK_LT( table["id"][0].integer( ), table["id"][1].integer( ) );
+	BOOST_CHECK_GE( table["id"][0].integer( ), 11 );
+	BOOST_CHECK_LE( table["id"][1].integer( ), 14 );
+
+	param.set_sample( 100 );
+	BOOST_CHECK_EQUAL( parse_csv_data( param ).get( )["id"].size( ), 4u );
+}
+
+BOOST_AUTO_TEST_CASE( parse_sample_resyncs_past_quoted_newlines ) {
+	std::string contents = "id,text\n";
+	for( int n = 1000; n < 3000; ++n ) {
+		contents += std::to_string( n ) + (0 == n % 3 ? ",\"line\nbreak, " + std::to_string( n ) + "\"\n" : ",plain " + std::to_string( n ) + "\n");
+	}
+	temp_csv_t const file{ contents };
+	parse_csv_data_param param{ file.file_name( ), 0 };
+	param.set_sample( 50, 3 );
+	auto const table = parse_csv_data( param ).get( );
+	auto const full = parse_csv_data( parse_csv_data_param{ file.file_name( ), 0 } ).get( );
+	auto const & ids = table["id"];
+	auto const & text = table["text"];
+	BOOST_REQUIRE_GE( ids.size( ), 40u );
+	BOOST_REQUIRE_LE( ids.size( ), 50u );
+	for( size_t row = 0; row < ids.size( ); ++row ) {
+		BOOST_REQUIRE( DataCellType::integer == ids[row].type( ) );
+		auto const id = ids[row].integer( );
+		BOOST_REQUIRE( 1000 <= id && id < 3000 );
+		BOOST_CHECK_EQUAL( text[row].string( ), full["text"][static_cast<size_t>(id - 1000)].string( ) );
+		if( 0 < row ) {
+			BOOST_CHECK_LT( ids[row - 1].integer( ), id );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( parse_sample_is_uniform ) {
+	// Long rows alternate with short ones.  Taking the row after a random offset would mostly find short rows
+	std::string contents = "id,text\n";
+	for( int n = 1000; n < 1200; ++n ) {
+		contents += std::to_string( n ) + "," + std::string( 0 == n % 2 ? 200 : 2, 'x' ) + "\n";
+	}
+	temp_csv_t const file{ contents };
+	parse_csv_data_param param{ file.file_name( ), 0 };
+	size_t long_rows = 0;
+	size_t short_rows = 0;
+	for( uint64_t seed = 0; seed < 50; ++seed ) {
+		param.set_sample( 20, seed );
+		auto const table = parse_csv_data( param ).get( );
+		auto const & ids = table["id"];
+		BOOST_REQUIRE_EQUAL( ids.size( ), 20u );
+		for( size_t row = 0; row < ids.size( ); ++row ) {
+			if( 0 < row ) {
+				BOOST_REQUIRE_LT( ids[row - 1].integer( ), ids[row].integer( ) );
+			}
+			++(0 == ids[row].integer( ) % 2 ? long_rows : short_rows);
+		}
+	}
+	BOOST_CHECK_GT( long_rows * 5, short_rows * 4 );
+	BOOST_CHECK_GT( short_rows * 5, long_rows * 4 );
+}
+
+BOOST_AUTO_TEST_CASE( parse_lazy ) {
+	temp_csv_t const file{ numbers_csv };
+	auto result = parse_csv_lazy( parse_csv_data_param{ file.file_name( ), 0 } );
+	auto & table = result.get( );
+	BOOST_REQUIRE_EQUAL( table.size( ), 3u );
+	BOOST_CHECK_EQUAL( table.row_count( ), 4u );
+	BOOST_CHECK_EQUAL( table.header( 1 ), "value" );
+	BOOST_CHECK( !table.is_materialized( 0 ) );
+
+	BOOST_CHECK_EQUAL( table["value"][3].real( ), 4.5 );
+	BOOST_CHECK( table["value"][2].empty( ) );
+	BOOST_CHECK( table.is_materialized( 1 ) );
+	BOOST_CHECK( !table.is_materialized( 2 ) );
+
+	auto const released = table.release( );
+	BOOST_REQUIRE_EQUAL( released.size( ), 3u );
+	BOOST_CHECK_EQUAL( released["name"][3].string( ), "dd" );
+	BOOST_CHECK_EQUAL( released["id"][0].integer( ), 11 );
+}
+
+BOOST_AUTO_TEST_CASE( parse_row_index ) {
+	// Row 103 has a quoted newline and the last row has no trailing newline
+	std::string const contents = "skipped\nid,text\n100,aa\n101,bb\n102,cc\n103,\"d\ne\"\n104,ff\n105,gg\n106,hh";
+	temp_csv_t const file{ contents };
+	auto const index = build_row_index( file.file_name( ), 1, 3 );
+	BOOST_CHECK_EQUAL( index.row_count( ), 7u );
+	BOOST_CHECK_EQUAL( index.header_first( ), 8u );
+	BOOST_REQUIRE_EQUAL( index.offsets( ).size( ), 3u );
+	BOOST_CHECK_EQUAL( contents.substr( static_cast<size_t>(index.offsets( )[1]), 4 ), "103," );
+	BOOST_CHECK_EQUAL( contents.substr( static_cast<size_t>(index.offsets( )[2]) ), "106,hh" );
+
+	temp_directory_t const directory;
+	auto const index_file_name = (directory.path( ) / "index.rowidx").string( );
+	index.save( index_file_name );
+	auto const loaded = row_index_t::load( index_file_name );
+	BOOST_CHECK( loaded.offsets( ) == index.offsets( ) );
+	BOOST_CHECK( loaded.matches( index.file_size( ), index.file_time( ), index.head_hash( ) ) );
+
+	auto const middle = read_rows( file.file_name( ), loaded, 3, 2 ).get( );
+	BOOST_REQUIRE_EQUAL( middle.size( ), 2u );
+	BOOST_REQUIRE_EQUAL( middle["id"].size( ), 2u );
+	BOOST_CHECK_EQUAL( middle["id"][0].integer( ), 103 );
+	BOOST_CHECK_EQUAL( middle["id"][1].integer( ), 104 );
+
+	auto const tail = read_rows( file.file_name( ), loaded, 5, 10 ).get( );
+	BOOST_REQUIRE_EQUAL( tail["id"].size( ), 2u );
+	BOOST_CHECK_EQUAL( tail["id"][1].integer( ), 106 );
+	BOOST_CHECK_EQUAL( tail["text"][1].string( ), "hh" );
+
+	// Same size and last write time, different first block
+	auto const write_time = boost::filesystem::last_write_time( file.file_name( ) );
+	auto changed = contents;
+	changed[contents.size( ) - 1] = 'i';
+	{
+		std::ofstream out( file.file_name( ), std::ios::binary | std::ios::trunc );
+		out << changed;
+	}
+	boost::filesystem::last_write_time( file.file_name( ), write_time );
+	BOOST_CHECK( read_rows( file.file_name( ), loaded, 0, 1 ).has_exception( ) );
+
+	// Same contents, later last write time
+	{
+		std::ofstream out( file.file_name( ), std::ios::binary | std::ios::trunc );
+		out << contents;
+	}
+	boost::filesystem::last_write_time( file.file_name( ), write_time + 10 );
+	BOOST_CHECK( read_rows( file.file_name( ), loaded, 0, 1 ).has_exception( ) );
+	boost::filesystem::last_write_time( file.file_name( ), write_time );
+	BOOST_CHECK( !read_rows( file.file_name( ), loaded, 0, 1 ).has_exception( ) );
+}
+
+BOOST_AUTO_TEST_CASE( spill_file_round_trip ) {
+	using boost::posix_time::time_duration;
+	std::string const long_text( 300, 'y' );
+	auto const cells = make_column( "cells", {
+		DataCell{ }, DataCell{ integer_t{ 0 } }, DataCell{ integer_t{ -1 } }, DataCell{ integer_t{ 64 } }, DataCell{ integer_t{ -65 } },
+		DataCell{ std::numeric_limits<integer_t>::max( ) }, DataCell{ std::numeric_limits<integer_t>::min( ) },
+		DataCell{ -0.25 }, DataCell{ 1e300 }, DataCell::from_string( "x" ), DataCell::from_string( long_text.c_str( ) ),
+		DataCell{ timestamp_t{ boost::gregorian::date{ 2016, 2, 29 }, time_duration{ 1, 2, 3, 4 } } },
+		DataCell{ timestamp_t{ boost::gregorian::date{ 1969, 12, 31 }, time_duration{ 23, 59, 59 } } },
+		DataCell{ timestamp_t{ boost::posix_time::not_a_date_time } },
+		DataCell{ timestamp_t{ boost::posix_time::neg_infin } },
+		DataCell{ timestamp_t{ boost::posix_time::pos_infin } },
+		DataCell{ decimal_t{ -12345, 2 } }, DataCell{ decimal_t{ std::numeric_limits<int64_t>::min( ), 18 } } } );
+
+	temp_directory_t const directory;
+	spill_file_t file{ directory.path( ).string( ) };
+	auto const first = file.write( cells );
+	auto const second = file.write( cells );
+	BOOST_CHECK_EQUAL( second.offset, first.size );
+	BOOST_CHECK_THROW( file.cell( first, 0 ), std::exception );
+	file.finish( );
+	BOOST_CHECK_EQUAL( file.size( ), first.size + second.size );
+
+	DataTable::value_type read{ "cells" };
+	file.read( second, read );
+	BOOST_REQUIRE_EQUAL( read.size( ), cells.size( ) );
+	for( size_t row = 0; row < cells.size( ); ++row ) {
+		auto const cell = file.cell( first, row );
+		BOOST_CHECK_EQUAL( cell.empty( ), cells[row].empty( ) );
+		if( !cells[row].empty( ) ) {
+			BOOST_CHECK( cells[row].type( ) == cell.type( ) );
+			BOOST_CHECK( cells[row].type( ) == read[row].type( ) );
+		}
+		BOOST_CHECK_MESSAGE( DataCell::equal( cells[row], cell ), "row " << row );
+		BOOST_CHECK_MESSAGE( DataCell::equal( cells[row], read[row] ), "row " << row );
+	}
+	BOOST_CHECK( file.cell( first, 13 ).timestamp( ).is_not_a_date_time( ) );
+	BOOST_CHECK( file.cell( first, 14 ).timestamp( ).is_neg_infinity( ) );
+	BOOST_CHECK( file.cell( first, 15 ).timestamp( ).is_pos_infinity( ) );
+	BOOST_CHECK_EQUAL( file.cell( second, 17 ).decimal( ).units( ), std::numeric_limits<int64_t>::min( ) );
+	BOOST_CHECK_THROW( file.cell( first, cells.size( ) ), std::exception );
+}
+
+BOOST_AUTO_TEST_CASE( parse_spill_round_trip ) {
+	std::string contents = "id,price,ratio,name,note\n";
+	for( int n = 0; n < 3000; ++n ) {
+		contents += std::to_string( 7 * n - 10000 ) + ",";
+		contents += 0 == n % 5 ? "" : std::to_string( n - 1500 ) + "." + std::to_string( 10 + n % 90 );
+		contents += "," + std::to_string( n ) + ".5,name " + std::to_string( n ) + ",";
+		contents += 0 == n % 7 ? "\n" : "\"quoted, " + std::to_string( n ) + "\" x\n";
+	}
+	temp_csv_t const file{ contents };
+	temp_directory_t const directory;
+	parse_csv_data_param param{ file.file_name( ), 0 };
+	param.set_decimal_scale( "price", 2 );
+	auto const full = parse_csv_data( param ).get( );
+	param.set_memory_budget( 1 );
+	param.set_spill_directory( directory.path( ).string( ) );
+	BOOST_CHECK( parse_csv_data( param ).has_exception( ) );
+	{
+		auto result = parse_csv_spill( param );
+		auto const & spilled = result.get( );
+		BOOST_REQUIRE_EQUAL( spilled.size( ), full.size( ) );
+		BOOST_REQUIRE_EQUAL( spilled.row_count( ), 3000u );
+		BOOST_CHECK_EQUAL( spilled.segment_rows( ), spill_table_t::min_segment_rows );
+		BOOST_REQUIRE_EQUAL( spilled.segment_count( ), 3u );
+		BOOST_CHECK( spilled.is_spilled( 0, 0 ) );
+		BOOST_CHECK( spilled.is_spilled( 4, 1 ) );
+		BOOST_CHECK( !spilled.is_spilled( 4, 2 ) );
+		BOOST_CHECK_LT( 0u, spilled.spilled_size( ) );
+		BOOST_CHECK( !boost::filesystem::is_empty( directory.path( ) ) );
+
+		BOOST_CHECK( DataCellType::integer == spilled["id"][5].type( ) );
+		BOOST_CHECK( DataCellType::decimal == spilled["price"][1].type( ) );
+		BOOST_CHECK( spilled["price"][1025].empty( ) );
+		BOOST_CHECK( DataCellType::real == spilled["ratio"][2].type( ) );
+		BOOST_CHECK( DataCellType::string == spilled["note"][1].type( ) );
+		BOOST_CHECK( spilled["note"][7].empty( ) );
+		for( DataTable::size_type column = 0; column < full.size( ); ++column ) {
+			auto const current = spilled[column];
+			BOOST_CHECK_EQUAL( current.header( ), full[column].header( ) );
+			BOOST_REQUIRE_EQUAL( current.size( ), full[column].size( ) );
+			for( size_t row = 0; row < current.size( ); ++row ) {
+				BOOST_CHECK( DataCell::equal( current[row], full[column][row] ) );
+			}
+			size_t row = 0;
+			current.for_each( [&]( DataCell const & cell ) {
+				BOOST_CHECK( DataCell::equal( cell, full[column][row++] ) );
+			} );
+			BOOST_CHECK_EQUAL( row, current.size( ) );
+		}
+		auto const loaded = spilled.load( );
+		BOOST_REQUIRE_EQUAL( loaded.size( ), full.size( ) );
+		BOOST_CHECK( DataCell::equal( loaded["price"][2999], full["price"][2999] ) );
+	}
+	BOOST_CHECK( boost::filesystem::is_empty( directory.path( ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( parse_decimal_column ) {
+	temp_csv_t const file{ numbers_csv };
+	parse_csv_data_param param{ file.file_name( ), 0 };
+	param.set_decimal_scale( "value", 2 );
+	auto const table = parse_csv_data( param ).get( );
+	BOOST_REQUIRE( DataCellType::decimal == table["value"][0].type( ) );
+	BOOST_CHECK_EQUAL( table["value"][0].decimal( ).to_string( ), "1.50" );
+	BOOST_CHECK( table["value"][2].empty( ) );
+	BOOST_CHECK( DataCellType::integer == table["id"][0].type( ) );
+}
+
+BOOST_AUTO_TEST_CASE( parse_into_arena ) {
+	temp_csv_t const file{ numbers_csv };
+	memory_arena_t arena;
+	parse_csv_data_param param{ file.file_name( ), 0 };
+	param.set_memory_arena( &arena );
+	auto result = parse_csv_data( param );
+	auto const & table = result.get( );	// A copy would move to the heap
+	BOOST_CHECK( &arena == table.get_allocator( ).arena( ) );
+	BOOST_CHECK_EQUAL( table["name"][2].string( ), "cc" );
+	BOOST_CHECK_EQUAL( table["id"][3].integer( ), 14 );
+	BOOST_CHECK_GT( arena.allocated( ), 0u );
+}
+
+BOOST_AUTO_TEST_CASE( parse_sparse_columns ) {
+	temp_csv_t const file{ "id,rare\n11,\n12,\n13,\n14,99\n" };
+	parse_csv_data_param param{ file.file_name( ), 0 };
+	param.set_sparse_threshold( 0.5 );
+	auto const columns = parse_csv_sparse( param ).get( );
+	BOOST_REQUIRE_EQUAL( columns.size( ), 2u );
+	BOOST_CHECK( !columns[0].is_sparse( ) );
+	BOOST_CHECK( columns[1].is_sparse( ) );
+	BOOST_REQUIRE_EQUAL( columns[1].size( ), 4u );
+	BOOST_CHECK( columns[1][0].empty( ) );
+	BOOST_CHECK_EQUAL( columns[1][3].integer( ), 99 );
+	BOOST_CHECK_EQUAL( columns[0][2].integer( ), 13 );
+}
+
+BOOST_AUTO_TEST_CASE( parse_sparse_columns_change_storage_while_parsing ) {
+	// rare stays sparse, full and late go dense once full has enough rows, early is made dense early on and sparse at the end
+	std::string contents = "id,full,rare,early,late\n";
+	for( int n = 1000; n < 4000; ++n ) {
+		auto const id = std::to_string( n );
+		contents += id + ",v" + id + "," + (0 == n % 100 ? id : "") + "," + (n < 2000 ? id : "") + "," + (n >= 2500 ? id : "") + "\n";
+	}
+	temp_csv_t const file{ contents };
+	parse_csv_data_param param{ file.file_name( ), 0 };
+	param.set_sparse_threshold( 0.6 );
+	parse_stats stats;
+	auto const columns = parse_csv_sparse( param, stats ).get( );
+	BOOST_REQUIRE_EQUAL( columns.size( ), 5u );
+	BOOST_CHECK( !columns[0].is_sparse( ) );
+	BOOST_CHECK( !columns[1].is_sparse( ) );
+	BOOST_CHECK( columns[2].is_sparse( ) );
+	BOOST_CHECK( columns[3].is_sparse( ) );
+	BOOST_CHECK( !columns[4].is_sparse( ) );
+	BOOST_CHECK_EQUAL( stats.sparse_columns, 2u );
+	BOOST_CHECK_EQUAL( columns[3].header( ), "early" );
+
+	auto const table = parse_csv_data( param ).get( );
+	for( size_t column = 0; column < columns.size( ); ++column ) {
+		BOOST_REQUIRE_EQUAL( columns[column].size( ), 3000u );
+		for( size_t row = 0; row < 3000; ++row ) {
+			BOOST_CHECK( DataCell::equal( columns[column][row], table[column][row] ) );
+		}
+	}
+
+	param.set_sparse_threshold( 2.0 );
+	auto const dense = parse_csv_sparse( param ).get( );
+	BOOST_CHECK( std::none_of( dense.begin( ), dense.end( ), []( DataColumnSparse const & column ) {
+		return column.is_sparse( );
+	} ) );
+}
+
+BOOST_AUTO_TEST_CASE( parse_async_results ) {
+	temp_csv_t const file{ numbers_csv };
+	bool completed = false;
+	auto parsed = parse_csv_data_async( parse_csv_data_param{ file.file_name( ), 0 }, nullptr, [&completed]( daw::expected_t<DataTable> const & table ) {
+		completed = !table.has_exception( );
+	} ).get( );
+	BOOST_CHECK( completed );
+	BOOST_CHECK_EQUAL( parsed.get( )["id"].size( ), 4u );
+
+	// A parse error is in the expected_t and the future itself is fine
+	auto missing = parse_csv_data_async( parse_csv_data_param{ file.file_name( ) + ".missing", 0 } );
+	BOOST_CHECK( missing.get( ).has_exception( ) );
+
+	// An exception thrown by on_complete is in the future
+	auto throwing = parse_csv_data_async( parse_csv_data_param{ file.file_name( ), 0 }, nullptr, []( daw::expected_t<DataTable> const & ) {
+		throw std::runtime_error( "on_complete" );
+	} );
+	BOOST_CHECK_THROW( throwing.get( ), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( parse_async_executor ) {
+	temp_csv_t const file{ numbers_csv };
+	std::vector<std::thread> threads;
+	auto const executor = [&threads]( std::function<void( )> task ) {
+		threads.emplace_back( std::move( task ) );
+	};
+	std::thread::id parse_thread{ };
+	auto result = parse_csv_data_async( parse_csv_data_param{ file.file_name( ), 0 }, executor, [&parse_thread]( daw::expected_t<DataTable> const & ) {
+		parse_thread = std::this_thread::get_id( );
+	} );
+	BOOST_CHECK_EQUAL( result.get( ).get( )["name"][3].string( ), "dd" );
+	BOOST_REQUIRE_EQUAL( threads.size( ), 1u );
+	BOOST_CHECK( threads[0].get_id( ) == parse_thread );
+	threads[0].join( );
+
+	auto const refusing = []( std::function<void( )> ) {
+		throw std::runtime_error( "executor" );
+	};
+	BOOST_CHECK_THROW( parse_csv_data_async( parse_csv_data_param{ file.file_name( ), 0 }, refusing ).get( ), std::runtime_error );
+}
@@ -0,0 +1,762 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2016 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Tests of the in memory algorithms over tables built cell by cell
+
+#define BOOST_TEST_MODULE csv_helper_table_test
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "compressed_column.h"
+#include "data_aggregate.h"
+#include "data_algorithms.h"
+#include "data_expression.h"
+#include "data_join.h"
+#include "data_matrix.h"
+#include "data_sort_key.h"
+#include "data_table.h"
+#include "data_table_view.h"
+#include "decimal.h"
+#include "memory_arena.h"
+#include "packed_column.h"
+#include "string_helpers.h"
+#include "task_scheduler.h"
+
+namespace {
+	using namespace daw::data;
+
+	DataTable::value_type make_column( std::string header, std::initializer_list<DataCell> cells ) {
+		DataTable::value_type result{ std::move( header ) };
+		for( auto const & cell : cells ) {
+			result.append( cell );
+		}
+		return result;
+	}
+
+	/// <summary>Check the values, aggregates, filters and decompression of column compressed with encoding against the cells</summary>
+	void check_compressed( DataTable::value_type const & column, column_encoding_t encoding ) {
+		compressed_column_t const compressed{ column, encoding };
+		BOOST_REQUIRE( encoding == compressed.encoding( ) );
+		BOOST_REQUIRE_EQUAL( compressed.size( ), column.size( ) );
+		std::vector<int64_t> decoded( column.size( ) );
+		if( 3 < column.size( ) ) {	// From a row that is not the first of a word or run
+			compressed.decode( 3, column.size( ) - 3, decoded.data( ) + 3 );
+		}
+		size_t count = 0;
+		int64_t sum = 0;
+		bool overflow = false;	// Once a running add in row order leaves int64_t, as aggregate::sum checks
+		boost::optional<int64_t> min;
+		boost::optional<int64_t> max;
+		for( size_t row = 0; row < column.size( ); ++row ) {
+			BOOST_CHECK_EQUAL( compressed.is_null( row ), column[row].empty( ) );
+			if( column[row].empty( ) ) {
+				BOOST_CHECK_EQUAL( compressed.value( row ), 0 );
+				continue;
+			}
+			auto const value = column[row].integer( );
+			BOOST_CHECK_EQUAL( compressed.value( row ), value );
+			if( 3 <= row ) {
+				BOOST_CHECK_EQUAL( decoded[row], value );
+			}
+			++count;
+			overflow = overflow || __builtin_add_overflow( sum, value, &sum );
+			min = min ? std::min( *min, value ) : value;
+			max = max ? std::max( *max, value ) : value;
+		}
+		BOOST_CHECK_EQUAL( compressed.count( ), count );
+		if( overflow ) {
+			BOOST_CHECK_THROW( compressed.sum( ), std::exception );
+		} else {
+			BOOST_CHECK_EQUAL( compressed.sum( ), sum );
+		}
+		BOOST_CHECK( compressed.min( ) == min );
+		BOOST_CHECK( compressed.max( ) == max );
+		if( 0 == count ) {
+			BOOST_CHECK( std::isnan( compressed.mean( ) ) );
+		} else {
+			long double total = 0;
+			for( size_t row = 0; row < column.size( ); ++row ) {
+				if( !column[row].empty( ) ) {
+					total += static_cast<long double>(static_cast<uint64_t>(column[row].integer( )) - static_cast<uint64_t>(*min));
+				}
+			}
+			auto const expected = static_cast<long double>(*min) + total / static_cast<long double>(count);
+			auto const range = static_cast<long double>(static_cast<uint64_t>(*max) - static_cast<uint64_t>(*min));
+			BOOST_CHECK_LE( std::abs( static_cast<long double>(compressed.mean( )) - expected ), 1e-9L * std::max( range, 1.0L ) );
+		}
+		for( auto const range : { std::make_pair( int64_t{ 10 }, int64_t{ 50 } ), std::make_pair( std::numeric_limits<int64_t>::min( ), int64_t{ 0 } ), std::make_pair( int64_t{ -1 }, std::numeric_limits<int64_t>::max( ) ), std::make_pair( int64_t{ 5 }, int64_t{ 4 } ) } ) {
+			auto const mask = compressed.filter_between( range.first, range.second );
+			BOOST_REQUIRE_EQUAL( mask.size( ), column.size( ) );
+			for( size_t row = 0; row < column.size( ); ++row ) {
+				auto const expected = !column[row].empty( ) && range.first <= column[row].integer( ) && column[row].integer( ) <= range.second;
+				BOOST_CHECK_EQUAL( mask[row], expected ? 1 : 0 );
+			}
+		}
+		auto const cells = compressed.decompress( );
+		BOOST_CHECK_EQUAL( cells.header( ), column.header( ) );
+		BOOST_REQUIRE_EQUAL( cells.size( ), column.size( ) );
+		for( size_t row = 0; row < column.size( ); ++row ) {
+			BOOST_CHECK( DataCell::equal( cells[row], column[row] ) );
+			BOOST_CHECK( DataCell::equal( compressed.cell( row ), column[row] ) );
+		}
+	}
+
+	int sign( int value ) {
+		return value < 0 ? -1 : (0 < value ? 1 : 0);
+	}
+
+	/// <summary>Check that the memcmp order of the sort keys of every pair of cells is their DataCell::compare order</summary>
+	void check_sort_key_order( std::vector<DataCell> const & cells ) {
+		for( auto const & lhs : cells ) {
+			for( auto const & rhs : cells ) {
+				auto const expected = sign( DataCell::compare( lhs, rhs ) );
+				BOOST_CHECK_EQUAL( sign( sort_key( lhs ).compare( sort_key( rhs ) ) ), expected );
+				BOOST_CHECK_EQUAL( sign( sort_key( lhs, true ).compare( sort_key( rhs, true ) ) ), -expected );
+			}
+		}
+	}
+}	// namespace anonymous
+
+BOOST_AUTO_TEST_CASE( aggregate_integer_column ) {
+	auto const column = make_column( "a", { DataCell{ integer_t{ 1 } }, DataCell{ integer_t{ 2 } }, DataCell{ }, DataCell{ integer_t{ 4 } } } );
+	auto const values = aggregate::integer_values( column );
+	BOOST_REQUIRE_EQUAL( values.size( ), 4u );
+	BOOST_CHECK_EQUAL( aggregate::count( values ), 3u );
+	BOOST_CHECK_EQUAL( aggregate::sum( values ), 7 );
+	BOOST_CHECK_EQUAL( *aggregate::min( values ), 1 );
+	BOOST_CHECK_EQUAL( *aggregate::max( values ), 4 );
+	BOOST_CHECK_CLOSE( aggregate::mean( values ), 7.0 / 3.0, 1e-9 );
+}
+
+BOOST_AUTO_TEST_CASE( aggregate_all_null ) {
+	auto const column = make_column( "a", { DataCell{ }, DataCell{ } } );
+	auto const values = aggregate::numeric_values( column );
+	BOOST_CHECK_EQUAL( aggregate::count( values ), 0u );
+	BOOST_CHECK( !aggregate::min( values ) );
+	BOOST_CHECK( std::isnan( aggregate::mean( values ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( aggregate_integer_overflow ) {
+	std::vector<int64_t> const values{ std::numeric_limits<int64_t>::max( ), 1, std::numeric_limits<int64_t>::max( ) };
+	BOOST_CHECK_THROW( aggregate::sum( values.data( ), nullptr, values.size( ) ), std::exception );
+	BOOST_CHECK_CLOSE( aggregate::mean( values.data( ), nullptr, values.size( ) ), 2.0 * static_cast<double>(std::numeric_limits<int64_t>::max( )) / 3.0, 1e-9 );
+
+	std::vector<uint8_t> const valid{ 0, 1, 1 };
+	std::vector<int64_t> const fits{ std::numeric_limits<int64_t>::max( ), std::numeric_limits<int64_t>::max( ), std::numeric_limits<int64_t>::min( ) };
+	BOOST_CHECK_EQUAL( aggregate::sum( fits.data( ), valid.data( ), fits.size( ) ), -1 );
+}
+
+BOOST_AUTO_TEST_CASE( aggregate_real_nan_and_infinity ) {
+	auto const nan = std::numeric_limits<double>::quiet_NaN( );
+	auto const inf = std::numeric_limits<double>::infinity( );
+	std::vector<double> const values{ nan, 2.0, -1.0, nan, 3.0, nan, nan, nan, 0.5 };
+	BOOST_CHECK_EQUAL( *aggregate::min( values.data( ), nullptr, values.size( ) ), -1.0 );
+	BOOST_CHECK_EQUAL( *aggregate::max( values.data( ), nullptr, values.size( ) ), 3.0 );
+
+	std::vector<double> const nans{ nan, nan, nan, nan, nan };
+	BOOST_CHECK( std::isnan( *aggregate::min( nans.data( ), nullptr, nans.size( ) ) ) );
+	BOOST_CHECK( std::isnan( *aggregate::max( nans.data( ), nullptr, nans.size( ) ) ) );
+
+	std::vector<double> const infinite{ inf, inf, inf, inf, inf };
+	BOOST_CHECK_EQUAL( *aggregate::min( infinite.data( ), nullptr, infinite.size( ) ), inf );
+	std::vector<float> const negative{ -std::numeric_limits<float>::infinity( ), 1.0f };
+	BOOST_CHECK_EQUAL( *aggregate::min( negative.data( ), nullptr, negative.size( ) ), -std::numeric_limits<float>::infinity( ) );
+}
+
+BOOST_AUTO_TEST_CASE( expression_column_and_filter ) {
+	using namespace daw::data::expression;
+	DataTable table;
+	table.append( make_column( "a", { DataCell{ integer_t{ 1 } }, DataCell{ integer_t{ 2 } }, DataCell{ }, DataCell{ integer_t{ 4 } } } ) );
+	table.append( make_column( "b", { DataCell{ integer_t{ 10 } }, DataCell{ integer_t{ 20 } }, DataCell{ integer_t{ 30 } }, DataCell{ integer_t{ 40 } } } ) );
+
+	auto const result = evaluate_column( table, column( "a" ) * literal( int64_t{ 2 } ) + column( "b" ), "c" );
+	BOOST_CHECK_EQUAL( result.header( ), "c" );
+	BOOST_REQUIRE_EQUAL( result.size( ), 4u );
+	BOOST_CHECK_EQUAL( result[0].integer( ), 12 );
+	BOOST_CHECK_EQUAL( result[1].integer( ), 24 );
+	BOOST_CHECK( result[2].empty( ) );
+	BOOST_CHECK_EQUAL( result[3].integer( ), 48 );
+
+	auto const mask = evaluate_filter( table, column( "b" ) - lag( "b" ) == literal( int64_t{ 10 } ) );
+	BOOST_CHECK( (mask == std::vector<uint8_t>{ 0, 1, 1, 1 }) );
+}
+
+BOOST_AUTO_TEST_CASE( expression_integer_overflow ) {
+	using namespace daw::data::expression;
+	auto const max = std::numeric_limits<integer_t>::max( );
+	auto const min = std::numeric_limits<integer_t>::min( );
+	DataTable table;
+	table.append( make_column( "a", { DataCell{ max }, DataCell{ min }, DataCell{ max - 1 }, DataCell{ min + 1 } } ) );
+
+	auto const added = evaluate_column( table, column( "a" ) + literal( int64_t{ 1 } ) );
+	BOOST_CHECK( added[0].empty( ) );
+	BOOST_CHECK_EQUAL( added[1].integer( ), min + 1 );
+	BOOST_CHECK_EQUAL( added[2].integer( ), max );
+
+	auto const subtracted = evaluate_column( table, column( "a" ) - literal( int64_t{ 1 } ) );
+	BOOST_CHECK_EQUAL( subtracted[0].integer( ), max - 1 );
+	BOOST_CHECK( subtracted[1].empty( ) );
+	BOOST_CHECK_EQUAL( subtracted[3].integer( ), min );
+
+	auto const multiplied = evaluate_column( table, column( "a" ) * literal( int64_t{ -1 } ) );
+	BOOST_CHECK_EQUAL( multiplied[0].integer( ), -max );
+	BOOST_CHECK( multiplied[1].empty( ) );
+	BOOST_CHECK( evaluate_column( table, column( "a" ) * literal( int64_t{ 2 } ) )[2].empty( ) );
+
+	auto const negated = evaluate_column( table, -column( "a" ) );
+	BOOST_CHECK_EQUAL( negated[0].integer( ), -max );
+	BOOST_CHECK( negated[1].empty( ) );
+	BOOST_CHECK_EQUAL( negated[3].integer( ), max );
+
+	// Reals do not overflow
+	BOOST_CHECK_EQUAL( evaluate_column( table, column( "a" ) + literal( 1.0 ) )[0].real( ), static_cast<double>(max) + 1.0 );
+}
+
+BOOST_AUTO_TEST_CASE( table_view_filter_and_select ) {
+	DataTable table;
+	table.append( make_column( "a", { DataCell{ integer_t{ 1 } }, DataCell{ integer_t{ 2 } }, DataCell{ integer_t{ 3 } }, DataCell{ integer_t{ 4 } }, DataCell{ integer_t{ 5 } } } ) );
+	table.append( make_column( "b", { DataCell::from_string( "v" ), DataCell::from_string( "w" ), DataCell::from_string( "x" ), DataCell::from_string( "y" ), DataCell::from_string( "z" ) } ) );
+
+	TableView const all{ table };
+	BOOST_CHECK_EQUAL( all.size( ), 2u );
+	BOOST_CHECK_EQUAL( all.row_count( ), 5u );
+
+	auto const odd = all.filter( []( TableView::size_type row, TableView const & view ) {
+		return 1 == view["a"][row].integer( ) % 2;
+	} );
+	BOOST_REQUIRE_EQUAL( odd.row_count( ), 3u );
+	BOOST_CHECK_EQUAL( odd.parent_row( 2 ), 4u );
+
+	auto const stacked = odd.filter( std::vector<uint8_t>{ 0, 1, 1 } ).select_rows( { 1 } );
+	BOOST_REQUIRE_EQUAL( stacked.row_count( ), 1u );
+	BOOST_CHECK_EQUAL( stacked["b"][0].string( ), "z" );
+	BOOST_CHECK_THROW( odd.filter( std::vector<uint8_t>{ 1 } ), std::exception );
+	BOOST_CHECK_THROW( odd.select_rows( { 2, 0 } ), std::exception );
+	BOOST_CHECK_THROW( odd.select_rows( { 0, 1, 1 } ), std::exception );
+	BOOST_CHECK_THROW( odd.select_rows( { 3 } ), std::exception );
+
+	auto const projected = odd.select_columns( { "b" } );
+	BOOST_REQUIRE_EQUAL( projected.size( ), 1u );
+	BOOST_CHECK_THROW( projected["a"], std::exception );
+	std::string joined;
+	for( auto const & cell : *projected.begin( ) ) {
+		joined += cell.string( );
+	}
+	BOOST_CHECK_EQUAL( joined, "vxz" );
+
+	auto const copy = projected.materialize( );
+	BOOST_REQUIRE_EQUAL( copy.size( ), 1u );
+	BOOST_REQUIRE_EQUAL( copy["b"].size( ), 3u );
+	BOOST_CHECK_EQUAL( copy["b"][1].string( ), "x" );
+}
+
+BOOST_AUTO_TEST_CASE( export_numeric_layouts ) {
+	DataTable table;
+	table.append( make_column( "a", { DataCell{ integer_t{ 1 } }, DataCell{ integer_t{ 2 } }, DataCell{ } } ) );
+	table.append( make_column( "b", { DataCell{ real_t{ 0.5 } }, DataCell::from_string( "text" ), DataCell{ real_t{ 2.5 } } } ) );
+
+	auto const rows = export_numeric( table, { "a", "b" }, matrix_layout::row_major, -1.0 );
+	BOOST_REQUIRE_EQUAL( rows.rows( ), 3u );
+	BOOST_REQUIRE_EQUAL( rows.columns( ), 2u );
+	BOOST_CHECK_EQUAL( rows.data( )[1], 0.5 );
+	BOOST_CHECK_EQUAL( rows.data( )[2], 2.0 );
+	BOOST_CHECK_EQUAL( rows( 1, 1 ), -1.0 );
+	BOOST_CHECK_EQUAL( rows( 2, 0 ), -1.0 );
+
+	auto const columns = export_numeric( table, { "b", "a" }, matrix_layout::column_major );
+	BOOST_CHECK_EQUAL( columns.data( )[2], 2.5 );
+	BOOST_CHECK_EQUAL( columns.data( )[4], 2.0 );
+	BOOST_CHECK( std::isnan( columns( 1, 0 ) ) );
+	BOOST_CHECK_EQUAL( columns( 0, 1 ), 1.0 );
+}
+
+BOOST_AUTO_TEST_CASE( column_stats_and_zone_maps ) {
+	auto const zone_rows = static_cast<integer_t>(column_stats::zone_rows);
+	DataTable::value_type column{ "a" };
+	for( integer_t n = 0; n < 2 * zone_rows + 10; ++n ) {
+		column.append( 0 == n % 1000 ? DataCell{ } : DataCell{ n } );
+	}
+	auto const & stats = static_cast<DataTable::value_type const &>( column ).stats( );
+	BOOST_CHECK_EQUAL( stats.row_count( ), column.size( ) );
+	BOOST_CHECK_EQUAL( stats.null_count( ), 132u );
+	BOOST_CHECK_EQUAL( *stats.integer_min( ), 1 );
+	BOOST_CHECK_EQUAL( *stats.integer_max( ), 2 * zone_rows + 9 );
+	BOOST_CHECK( storage_width_t::int32 == stats.width( ) );
+
+	BOOST_REQUIRE_EQUAL( stats.zones( ).size( ), 3u );
+	auto const & middle = stats.zones( )[1];
+	BOOST_CHECK_EQUAL( middle.count, column_stats::zone_rows );
+	BOOST_CHECK_EQUAL( middle.numeric_min, static_cast<double>(zone_rows) );
+	BOOST_CHECK_EQUAL( middle.numeric_max, static_cast<double>(2 * zone_rows - 1) );
+	BOOST_CHECK( middle.has_nulls( ) );
+	BOOST_CHECK( middle.may_contain( 70000.0, 70001.0 ) );
+	BOOST_CHECK( !middle.may_contain( 0.0, 100.0 ) );
+	BOOST_CHECK_EQUAL( stats.zones( )[2].count, 10u );
+
+	// A mutable reference may change the cell, so the stats are rebuilt on the next read
+	column[1] = DataCell{ integer_t{ -5 } };
+	BOOST_CHECK_EQUAL( *column.stats( ).integer_min( ), -5 );
+	BOOST_CHECK_EQUAL( column.stats( ).zones( )[0].numeric_min, -5.0 );
+
+	auto const strings = make_column( "s", { DataCell::from_string( "m" ), DataCell{ }, DataCell::from_string( "b" ), DataCell::from_string( "z" ), DataCell{ integer_t{ 1 } } } );
+	auto const & totals = strings.stats( ).totals( );
+	BOOST_CHECK_EQUAL( totals.string_min_row, 2u );
+	BOOST_CHECK_EQUAL( totals.string_max_row, 3u );
+	BOOST_CHECK_EQUAL( strings.stats( ).type_count( DataCellType::string ), 3u );
+	BOOST_CHECK_EQUAL( strings.stats( ).string_bytes( ), 3u );
+	BOOST_CHECK( storage_width_t::none == strings.stats( ).width( ) );
+}
+
+BOOST_AUTO_TEST_CASE( column_sketches_follow_appends_and_erases ) {
+	DataTable::value_type column{ "a" };
+	for( integer_t n = 0; n < 5000; ++n ) {
+		column.append( DataCell{ n } );
+	}
+	column.enable_sketches( );
+	for( integer_t n = 5000; n < 10000; ++n ) {
+		column.append( DataCell{ n } );
+	}
+	BOOST_REQUIRE( column.sketches( ) );
+	BOOST_CHECK_CLOSE( column.sketches( )->distinct.estimate( ), 10000.0, 5.0 );
+	BOOST_CHECK_EQUAL( column.sketches( )->quantiles.count( ), 10000u );
+	BOOST_CHECK_CLOSE( column.sketches( )->quantiles.quantile( 0.5 ), 5000.0, 5.0 );
+
+	column.erase( column.begin( ) + 5000, column.end( ) );
+	BOOST_CHECK_EQUAL( column.stats( ).row_count( ), 5000u );
+	BOOST_CHECK_EQUAL( column.sketches( )->quantiles.count( ), 5000u );
+	BOOST_CHECK_CLOSE( column.sketches( )->distinct.estimate( ), 5000.0, 5.0 );
+}
+
+BOOST_AUTO_TEST_CASE( decimal_exact_arithmetic ) {
+	auto const a = decimal_t::parse( "0.10", 2 );
+	auto const b = decimal_t::parse( "0.2", 1 );
+	BOOST_REQUIRE( a && b );
+	BOOST_CHECK_EQUAL( (*a + *b).to_string( ), "0.30" );
+	BOOST_CHECK( *a == decimal_t( 1, 1 ) );
+	BOOST_CHECK_EQUAL( a->hash( ), decimal_t( 1, 1 ).hash( ) );
+	BOOST_CHECK( *a < *b );
+	BOOST_CHECK_EQUAL( decimal_t::parse( "1.005", 2 )->to_string( ), "1.01" );
+	BOOST_CHECK( !decimal_t::parse( "1.5x", 2 ) );
+
+	auto const column = make_column( "a", { DataCell{ *a }, DataCell{ }, DataCell{ *b }, DataCell{ integer_t{ 5 } } } );
+	BOOST_CHECK_EQUAL( aggregate::decimal_sum( column ).to_string( ), "0.30" );
+}
+
+BOOST_AUTO_TEST_CASE( packed_column_widths ) {
+	auto const flags = make_column( "flags", { DataCell{ integer_t{ 1 } }, DataCell{ integer_t{ -5 } }, DataCell{ integer_t{ 100 } }, DataCell{ } } );
+	packed_column_t const packed{ flags };
+	BOOST_CHECK( storage_width_t::int8 == packed.width( ) );
+	BOOST_CHECK_EQUAL( packed.size( ), 4u );
+	BOOST_CHECK_EQUAL( packed.memory_size( ), 8u );
+	BOOST_CHECK_EQUAL( packed.data<int8_t>( )[2], 100 );
+	BOOST_CHECK_THROW( packed.data<int16_t>( ), std::exception );
+	BOOST_CHECK_EQUAL( packed.integer( 1 ), -5 );
+	BOOST_CHECK( packed.is_null( 3 ) );
+	BOOST_CHECK( packed.cell( 3 ).empty( ) );
+	auto const unpacked = packed.unpack( );
+	BOOST_REQUIRE_EQUAL( unpacked.size( ), 4u );
+	BOOST_CHECK_EQUAL( unpacked[1].integer( ), -5 );
+	BOOST_CHECK( unpacked[3].empty( ) );
+
+	auto const ids = make_column( "ids", { DataCell{ integer_t{ 1 } << 40 }, DataCell{ integer_t{ -1 } } } );
+	packed_column_t const wide{ ids };
+	BOOST_CHECK( storage_width_t::int64 == wide.width( ) );
+	BOOST_CHECK( nullptr == wide.valid( ) );
+	BOOST_CHECK_EQUAL( wide.integer( 0 ), integer_t{ 1 } << 40 );
+
+	auto const prices = make_column( "prices", { DataCell{ 1.5 }, DataCell{ integer_t{ 2 } }, DataCell{ 0.1 } } );
+	packed_column_t const reals{ prices };
+	BOOST_CHECK( storage_width_t::float64 == reals.width( ) );
+	BOOST_CHECK_EQUAL( reals.real( 2 ), 0.1 );
+	BOOST_CHECK_THROW( reals.integer( 0 ), std::exception );
+	BOOST_CHECK_EQUAL( reals.visit( []( auto const * values ) { return static_cast<double>(values[1]); } ), 2.0 );
+
+	auto forced = make_column( "forced", { DataCell{ integer_t{ 40000 } } } );
+	forced.set_width( storage_width_t::int16 );
+	BOOST_CHECK_THROW( packed_column_t{ forced }, std::exception );
+	forced.set_width( storage_width_t::float32 );
+	BOOST_CHECK_EQUAL( packed_column_t{ forced }.data<float>( )[0], 40000.0f );
+
+	DataTable table;
+	table.append( flags );
+	table.append( make_column( "names", { DataCell::from_string( "aa" ) } ) );
+	table.append( prices );
+	auto const columns = pack_numeric_columns( table );
+	BOOST_REQUIRE_EQUAL( columns.size( ), 2u );
+	BOOST_CHECK_EQUAL( columns[1].header( ), "prices" );
+}
+
+BOOST_AUTO_TEST_CASE( compressed_bit_packing ) {
+	// 7 bits a value so values straddle words, with nulls and a run of equal values
+	DataTable::value_type column{ "a" };
+	for( integer_t n = 0; n < 300; ++n ) {
+		column.append( 0 == n % 13 ? DataCell{ } : DataCell{ 100 <= n && n < 140 ? integer_t{ 42 } : n * 37 % 101 - 20 } );
+	}
+	check_compressed( column, column_encoding_t::frame_of_reference );
+	check_compressed( column, column_encoding_t::run_length );
+	BOOST_CHECK_EQUAL( compressed_column_t( column, column_encoding_t::frame_of_reference ).bits( ), 7u );
+
+	// The whole int64_t range needs 64 bits
+	auto const wide = make_column( "wide", { DataCell{ std::numeric_limits<integer_t>::min( ) }, DataCell{ integer_t{ -1 } }, DataCell{ }, DataCell{ integer_t{ 0 } }, DataCell{ std::numeric_limits<integer_t>::max( ) }, DataCell{ integer_t{ 7 } } } );
+	check_compressed( wide, column_encoding_t::frame_of_reference );
+	check_compressed( wide, column_encoding_t::run_length );
+	BOOST_CHECK_EQUAL( compressed_column_t( wide, column_encoding_t::frame_of_reference ).bits( ), 64u );
+
+	// One value needs no bits
+	auto const same = make_column( "same", { DataCell{ integer_t{ 9 } }, DataCell{ integer_t{ 9 } }, DataCell{ }, DataCell{ integer_t{ 9 } }, DataCell{ integer_t{ 9 } } } );
+	check_compressed( same, column_encoding_t::frame_of_reference );
+	BOOST_CHECK_EQUAL( compressed_column_t( same, column_encoding_t::frame_of_reference ).bits( ), 0u );
+}
+
+BOOST_AUTO_TEST_CASE( compressed_runs_and_nulls ) {
+	auto const column = make_column( "a", { DataCell{ integer_t{ 5 } }, DataCell{ integer_t{ 5 } }, DataCell{ }, DataCell{ }, DataCell{ integer_t{ 5 } }, DataCell{ integer_t{ 7 } }, DataCell{ integer_t{ 7 } }, DataCell{ } } );
+	compressed_column_t const runs{ column, column_encoding_t::run_length };
+	BOOST_CHECK_EQUAL( runs.run_count( ), 5u );
+	BOOST_CHECK_EQUAL( runs.sum( ), 29 );
+	check_compressed( column, column_encoding_t::run_length );
+	check_compressed( column, column_encoding_t::frame_of_reference );
+	DataTable::value_type long_runs{ "b" };
+	for( integer_t n = 0; n < 2000; ++n ) {
+		long_runs.append( DataCell{ n < 1000 ? integer_t{ 1 } : integer_t{ 1000 } } );
+	}
+	BOOST_CHECK( column_encoding_t::run_length == compressed_column_t{ long_runs }.encoding( ) );
+	BOOST_CHECK( column_encoding_t::frame_of_reference == compressed_column_t{ make_column( "c", { DataCell{ integer_t{ 1 } }, DataCell{ integer_t{ 2 } }, DataCell{ integer_t{ 3 } } } ) }.encoding( ) );
+
+	auto const nulls = make_column( "nulls", { DataCell{ }, DataCell{ }, DataCell{ }, DataCell{ } } );
+	check_compressed( nulls, column_encoding_t::run_length );
+	check_compressed( nulls, column_encoding_t::frame_of_reference );
+	BOOST_CHECK( compressed_column_t{ nulls }.is_null( 2 ) );
+	check_compressed( DataTable::value_type{ "empty" }, column_encoding_t::frame_of_reference );
+	BOOST_CHECK_THROW( compressed_column_t{ make_column( "mixed", { DataCell{ integer_t{ 1 } }, DataCell{ 1.5 } } ) }, std::exception );
+}
+
+BOOST_AUTO_TEST_CASE( compressed_sum_overflow ) {
+	auto const max = std::numeric_limits<integer_t>::max( );
+	auto const min = std::numeric_limits<integer_t>::min( );
+	auto const past_max = make_column( "a", { DataCell{ max }, DataCell{ }, DataCell{ integer_t{ 1 } } } );
+	auto const past_min = make_column( "b", { DataCell{ min }, DataCell{ integer_t{ -1 } } } );
+	auto const at_max = make_column( "c", { DataCell{ max - 1 }, DataCell{ integer_t{ 1 } }, DataCell{ } } );
+	auto const run_past_max = make_column( "d", { DataCell{ max / 2 }, DataCell{ max / 2 }, DataCell{ max / 2 } } );
+	for( auto const encoding : { column_encoding_t::run_length, column_encoding_t::frame_of_reference } ) {
+		BOOST_CHECK_THROW( compressed_column_t( past_max, encoding ).sum( ), std::exception );
+		BOOST_CHECK_THROW( compressed_column_t( past_min, encoding ).sum( ), std::exception );
+		BOOST_CHECK_THROW( compressed_column_t( run_past_max, encoding ).sum( ), std::exception );
+		BOOST_CHECK_EQUAL( compressed_column_t( at_max, encoding ).sum( ), max );
+	}
+	BOOST_CHECK_EQUAL( compressed_column_t( run_past_max, column_encoding_t::run_length ).run_count( ), 1u );
+}
+
+BOOST_AUTO_TEST_CASE( compressed_timestamps ) {
+	using boost::posix_time::time_duration;
+	timestamp_t const day{ boost::gregorian::date{ 2016, 3, 1 } };
+	auto const times = make_column( "times", { DataCell{ day }, DataCell{ day + time_duration{ 0, 0, 1, 5 } }, DataCell{ }, DataCell{ day - time_duration{ 1, 0, 0 } } } );
+	for( auto const encoding : { column_encoding_t::run_length, column_encoding_t::frame_of_reference } ) {
+		compressed_column_t const compressed{ times, encoding };
+		BOOST_CHECK( DataCellType::timestamp == compressed.type( ) );
+		BOOST_CHECK_EQUAL( compressed.value( 1 ) - compressed.value( 0 ), 1000005 );
+		auto const mask = compressed.filter_between( day, timestamp_t{ boost::posix_time::pos_infin } );
+		BOOST_CHECK( (std::vector<uint8_t>{ 1, 1, 0, 0 }) == mask );
+		BOOST_CHECK_CLOSE( compressed.mean( ), static_cast<double>(compressed.value( 0 )) + (1000005.0 - 3600e6) / 3.0, 1e-9 );
+		auto const cells = compressed.decompress( );
+		for( size_t row = 0; row < times.size( ); ++row ) {
+			BOOST_CHECK( DataCell::equal( cells[row], times[row] ) );
+		}
+	}
+
+	DataTable table;
+	table.append( make_column( "special", { DataCell{ day }, DataCell{ timestamp_t{ boost::posix_time::not_a_date_time } }, DataCell{ timestamp_t{ boost::posix_time::pos_infin } }, DataCell{ timestamp_t{ boost::posix_time::neg_infin } } } ) );
+	table.append( make_column( "later", { DataCell{ day }, DataCell{ day }, DataCell{ timestamp_t{ boost::posix_time::pos_infin } }, DataCell{ } } ) );
+	auto const columns = compress_columns( table );
+	BOOST_REQUIRE_EQUAL( columns.size( ), 2u );
+	auto const & special = columns[0];
+	BOOST_CHECK( special.is_null( 1 ) );
+	BOOST_CHECK_EQUAL( special.count( ), 3u );
+	BOOST_CHECK_EQUAL( *special.min( ), compressed_column_t::neg_infinity_value );
+	BOOST_CHECK_EQUAL( *special.max( ), compressed_column_t::pos_infinity_value );
+	BOOST_CHECK( std::isnan( special.mean( ) ) );
+	BOOST_CHECK( special.cell( 2 ).timestamp( ).is_pos_infinity( ) );
+	BOOST_CHECK( special.cell( 3 ).timestamp( ).is_neg_infinity( ) );
+	BOOST_CHECK( special.cell( 1 ).empty( ) );
+	BOOST_CHECK( (std::vector<uint8_t>{ 1, 0, 0, 1 }) == special.filter_between( timestamp_t{ boost::posix_time::neg_infin }, day ) );
+	BOOST_CHECK_THROW( special.filter_between( timestamp_t{ boost::posix_time::not_a_date_time }, day ), std::exception );
+	BOOST_CHECK( std::isinf( columns[1].mean( ) ) && 0.0 < columns[1].mean( ) );
+	auto const cells = special.decompress( );
+	BOOST_CHECK( cells[2].timestamp( ).is_pos_infinity( ) );
+	BOOST_CHECK( DataCell::equal( cells[0], table[0][0] ) );
+}
+
+BOOST_AUTO_TEST_CASE( format_and_parse_concurrently ) {
+	timestamp_t const start{ boost::gregorian::date{ 2016, 1, 1 } };
+	DataTable::value_type column{ "a" };
+	for( integer_t n = 0; n < 5000; ++n ) {
+		switch( n % 4 ) {
+		case 0:
+			column.append( DataCell{ start + boost::posix_time::minutes( n * 97 ) } );
+			break;
+		case 1:
+			column.append( DataCell{ n } );
+			break;
+		case 2:
+			column.append( DataCell{ static_cast<real_t>(n) / 8.0 } );
+			break;
+		default:
+			column.append( DataCell{ } );
+		}
+	}
+	std::vector<std::string> expected;
+	for( auto const & cell : column ) {
+		expected.push_back( cell.to_string( ) );
+	}
+	std::atomic<size_t> mismatches{ 0 };
+	std::vector<std::thread> threads;
+	for( int t = 0; t < 4; ++t ) {
+		threads.emplace_back( [&, t]( ) {
+			for( int pass = 0; pass < 6; ++pass ) {
+				// Alternate locales so each thread switches between its cached streams
+				std::string const locale_str = 0 == (pass + t) % 2 ? "" : "C";
+				if( expected != column.to_strings( locale_str ) ) {
+					++mismatches;
+				}
+				for( size_t row = 0; row < column.size( ); row += 4 ) {
+					auto const text = daw::string::ptime_to_string( column[row].timestamp( ), "%Y-%m-%d %H:%M:%S", locale_str );
+					if( DataCell::from_time_string( text, "%Y-%m-%d %H:%M:%S" ).timestamp( ) != column[row].timestamp( ) ) {
+						++mismatches;
+					}
+				}
+			}
+		} );
+	}
+	for( auto & thread : threads ) {
+		thread.join( );
+	}
+	BOOST_CHECK_EQUAL( mismatches.load( ), 0u );
+}
+
+BOOST_AUTO_TEST_CASE( memory_arena_allocations ) {
+	memory_arena_t arena{ 64 };
+	auto const ptr = arena.allocate( 24, 16 );
+	BOOST_CHECK_EQUAL( reinterpret_cast<std::uintptr_t>( ptr ) % 16, 0u );
+	auto const str = arena.copy_string( "hello", 5 );
+	BOOST_CHECK_EQUAL( std::strcmp( str, "hello" ), 0 );
+	arena.allocate( 1000 );	// Larger than a chunk
+	BOOST_CHECK_GE( arena.allocated( ), 1029u );
+	BOOST_CHECK_GE( arena.reserved( ), arena.allocated( ) );
+
+	auto & child = arena.make_child( );
+	child.allocate( 100 );
+	BOOST_CHECK_EQUAL( child.allocated( ), 100u );
+
+	{
+		DataTable::value_type column{ "a", DataTable::allocator_type{ &arena } };
+		for( integer_t n = 0; n < 100; ++n ) {
+			column.append( DataCell{ n } );
+		}
+		BOOST_CHECK_EQUAL( column[99].integer( ), 99 );
+		BOOST_CHECK( &arena == column.get_allocator( ).arena( ) );
+	}
+	arena.release( );
+	BOOST_CHECK_EQUAL( arena.allocated( ), 0u );
+}
+
+BOOST_AUTO_TEST_CASE( sparse_column_round_trip ) {
+	DataColumnSparse column{ "a" };
+	for( integer_t n = 0; n < 100; ++n ) {
+		column.append( 0 == n % 10 ? DataCell{ n } : DataCell{ } );
+	}
+	column.make_sparse( );
+	BOOST_CHECK( column.is_sparse( ) );
+	column[5] = DataCell{ integer_t{ 7 } };
+	column[10] = DataCell{ };
+	BOOST_CHECK( column.is_sparse( ) );
+
+	auto const & cells = column;
+	BOOST_REQUIRE_EQUAL( cells.size( ), 100u );
+	BOOST_CHECK_EQUAL( cells[5].integer( ), 7 );
+	BOOST_CHECK( cells[10].empty( ) );
+	BOOST_CHECK_EQUAL( cells[90].integer( ), 90 );
+
+	DataColumnDense dense{ std::move( column ) };
+	BOOST_REQUIRE_EQUAL( dense.size( ), 100u );
+	BOOST_CHECK_EQUAL( dense[5].integer( ), 7 );
+	BOOST_CHECK_EQUAL( dense[20].integer( ), 20 );
+	BOOST_CHECK_EQUAL( dense.stats( ).null_count( ), 90u );
+}
+
+BOOST_AUTO_TEST_CASE( hash_join_numeric_keys ) {
+	DataTable left;
+	left.append( make_column( "k", { DataCell{ integer_t{ 5 } }, DataCell{ real_t{ 0.1 } }, DataCell::from_string( "xx" ), DataCell{ } } ) );
+	DataTable right;
+	right.append( make_column( "k", { DataCell{ decimal_t{ 500, 2 } }, DataCell{ decimal_t{ 10, 2 } }, DataCell::from_string( "xx" ), DataCell{ real_t{ 5.0 } }, DataCell{ } } ) );
+	right.append( make_column( "r", { DataCell{ integer_t{ 1 } }, DataCell{ integer_t{ 2 } }, DataCell{ integer_t{ 3 } }, DataCell{ integer_t{ 4 } }, DataCell{ integer_t{ 5 } } } ) );
+
+	auto const inner = algorithm::hash_join( left, right, { "k" }, { "k" } );
+	BOOST_REQUIRE_EQUAL( inner["r"].size( ), 4u );
+	BOOST_CHECK_EQUAL( inner["r"][0].integer( ) + inner["r"][1].integer( ), 5 );
+	BOOST_CHECK_EQUAL( inner["r"][2].integer( ), 2 );
+	BOOST_CHECK_EQUAL( inner["r"][3].integer( ), 3 );
+
+	auto const semi = algorithm::hash_join( left, right, { "k" }, { "k" }, algorithm::join_type::semi );
+	BOOST_CHECK_EQUAL( semi["k"].size( ), 3u );
+}
+
+BOOST_AUTO_TEST_CASE( scheduler_nested_parallel_for ) {
+	std::atomic<size_t> total{ 0 };
+	algorithm::parallel_for( 0, 16, [&total]( size_t first, size_t last ) {
+		for( auto n = first; n < last; ++n ) {
+			algorithm::parallel_for( 0, 1000, [&total]( size_t inner_first, size_t inner_last ) {
+				total += inner_last - inner_first;
+			} );
+		}
+	} );
+	BOOST_CHECK_EQUAL( total.load( ), 16000u );
+}
+
+BOOST_AUTO_TEST_CASE( scheduler_task_exceptions ) {
+	BOOST_CHECK_THROW( algorithm::parallel_for( 0, 1000, []( size_t first, size_t ) {
+		if( 0 == first ) {
+			throw std::runtime_error( "first chunk" );
+		}
+	} ), std::runtime_error );
+
+	task_scheduler scheduler{ 2 };
+	task_group group{ scheduler };
+	std::atomic<int> ran{ 0 };
+	auto const ok = [&ran]( ) {
+		++ran;
+	};
+	auto const fail = [&ran]( ) {
+		++ran;
+		throw std::logic_error( "task" );
+	};
+	group.run( ok );
+	group.run( fail );
+	group.run( ok );
+	BOOST_CHECK_THROW( group.wait( ), std::logic_error );
+	BOOST_CHECK_EQUAL( ran.load( ), 3 );
+
+	// A plain task's exception is kept by the scheduler rather than ending the process
+	BOOST_CHECK( !scheduler.take_error( ) );
+	scheduler.add_task( fail );
+	std::exception_ptr error;
+	while( !(error = scheduler.take_error( )) ) {
+		std::this_thread::yield( );
+	}
+	BOOST_CHECK_THROW( std::rethrow_exception( error ), std::logic_error );
+	BOOST_CHECK( !scheduler.take_error( ) );
+	BOOST_CHECK_EQUAL( ran.load( ), 4 );
+}
+
+BOOST_AUTO_TEST_CASE( scheduler_wait_runs_only_its_group ) {
+	task_scheduler scheduler{ 1 };
+	std::atomic<bool> release{ false };
+	std::atomic<bool> blocked{ false };
+	scheduler.add_task( [&]( ) {
+		blocked = true;
+		while( !release ) {
+			std::this_thread::yield( );
+		}
+	} );
+	while( !blocked ) {
+		std::this_thread::yield( );
+	}
+	std::atomic<bool> unrelated_ran{ false };
+	scheduler.add_task( [&unrelated_ran]( ) {
+		unrelated_ran = true;
+	} );
+
+	// The only worker is busy, so the waiting thread has to run the group's task itself and must leave the other alone
+	std::atomic<int> group_ran{ 0 };
+	auto const task = [&group_ran]( ) {
+		++group_ran;
+	};
+	{
+		task_group group{ scheduler };
+		group.run( task );
+		group.wait( );
+	}
+	BOOST_CHECK_EQUAL( group_ran.load( ), 1 );
+	BOOST_CHECK( !unrelated_ran );
+	release = true;
+}
+
+BOOST_AUTO_TEST_CASE( scheduler_drains_on_destruction ) {
+	std::atomic<int> ran{ 0 };
+	{
+		task_scheduler scheduler{ 2 };
+		for( int n = 0; n < 100; ++n ) {
+			scheduler.add_task( [&scheduler, &ran]( ) {
+				++ran;
+				scheduler.add_task( [&ran]( ) {	// Queued while stopping, and still run
+					++ran;
+				} );
+			} );
+		}
+	}
+	BOOST_CHECK_EQUAL( ran.load( ), 200 );
+}
+
+BOOST_AUTO_TEST_CASE( sort_keys_match_compare ) {
+	check_sort_key_order( { DataCell{ integer_t{ -5 } }, DataCell{ integer_t{ -1 } }, DataCell{ integer_t{ 0 } }, DataCell{ integer_t{ 3 } },
+		DataCell{ std::numeric_limits<integer_t>::min( ) }, DataCell{ std::numeric_limits<integer_t>::max( ) } } );
+
+	check_sort_key_order( { DataCell{ real_t{ -0.0 } }, DataCell{ real_t{ 0.0 } }, DataCell{ real_t{ -2.5 } }, DataCell{ real_t{ -1e-300 } }, DataCell{ real_t{ 1e300 } },
+		DataCell{ std::numeric_limits<real_t>::infinity( ) }, DataCell{ -std::numeric_limits<real_t>::infinity( ) } } );
+	BOOST_CHECK_EQUAL( sort_key( DataCell{ real_t{ -0.0 } } ), sort_key( DataCell{ real_t{ 0.0 } } ) );
+
+	check_sort_key_order( { DataCell{ decimal_t{ -150, 2 } }, DataCell{ decimal_t{ -15, 1 } }, DataCell{ decimal_t{ -1, 0 } }, DataCell{ decimal_t{ -149, 2 } },
+		DataCell{ decimal_t{ -1, 3 } }, DataCell{ decimal_t{ 0, 4 } }, DataCell{ decimal_t{ 1, 3 } }, DataCell{ decimal_t{ 105, 2 } }, DataCell{ decimal_t{ 11, 1 } } } );
+
+	std::string const with_nul{ "a\0b", 3 };
+	std::string const with_nul_end{ "a\0", 2 };
+	check_sort_key_order( { DataCell::from_string( "a" ), DataCell::from_string( "ab" ), DataCell::from_string( "abc" ), DataCell::from_string( "b" ),
+		DataCell{ daw::cstring( with_nul.data( ), true, with_nul.size( ) ) }, DataCell{ daw::cstring( with_nul_end.data( ), true, with_nul_end.size( ) ) } } );
+
+	auto const empty_key = sort_key( DataCell{ } );
+	BOOST_CHECK_LT( empty_key, sort_key( DataCell{ integer_t{ -1 } } ) );
+	BOOST_CHECK_LT( empty_key, sort_key( DataCell::from_string( "a" ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( sort_keys_multi_column_descending ) {
+	DataTable table;
+	table.append( make_column( "a", { DataCell{ integer_t{ 1 } }, DataCell{ integer_t{ 1 } }, DataCell{ integer_t{ 0 } }, DataCell{ integer_t{ 1 } } } ) );
+	table.append( make_column( "b", { DataCell::from_string( "x" ), DataCell::from_string( "xy" ), DataCell::from_string( "z" ), DataCell::from_string( "w" ) } ) );
+	auto const keys = sort_keys( table, { "a", "b" }, { false, true } );
+	BOOST_REQUIRE_EQUAL( keys.size( ), 4u );
+	// a ascending, then b descending: row 2, then rows 1, 0, 3
+	BOOST_CHECK_LT( keys[2], keys[1] );
+	BOOST_CHECK_LT( keys[1], keys[0] );
+	BOOST_CHECK_LT( keys[0], keys[3] );
+	BOOST_CHECK_EQUAL( keys[0], sort_key( DataCell{ integer_t{ 1 } } ) + sort_key( DataCell::from_string( "x" ), true ) );
+	BOOST_CHECK_THROW( sort_keys( table, { "a", "b" }, { true } ), std::exception );
+}